@@ -0,0 +1,22 @@
+# Generates a binary snapshot of an FLL engine (see FlbExporter) at build time:
+#
+#   fuzzylite_engine_snapshot(<engine.fll> <engine.flb>)
+#
+# The snapshot is regenerated whenever the FLL file or the fuzzylite binary change.
+# Add the snapshot to the sources of a target for the target to depend on it.
+function(fuzzylite_engine_snapshot FLL FLB)
+    if (NOT TARGET binaryTarget)
+        message(FATAL_ERROR "fuzzylite_engine_snapshot requires the fuzzylite binary (FL_BUILD_BINARY=ON)")
+    endif ()
+    get_filename_component(FLL ${FLL} ABSOLUTE)
+    get_filename_component(FLB ${FLB} ABSOLUTE BASE_DIR ${CMAKE_CURRENT_BINARY_DIR})
+    get_filename_component(FLB_DIRECTORY ${FLB} DIRECTORY)
+    add_custom_command(
+            OUTPUT ${FLB}
+            COMMAND ${CMAKE_COMMAND} -E make_directory ${FLB_DIRECTORY}
+            COMMAND binaryTarget -i ${FLL} -of flb -o ${FLB}
+            DEPENDS ${FLL} binaryTarget
+            COMMENT "Generating engine snapshot ${FLB} from ${FLL}"
+            VERBATIM
+    )
+endfunction()
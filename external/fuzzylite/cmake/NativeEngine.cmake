@@ -0,0 +1,22 @@
+# Generates a standalone C++ header that evaluates an FLL engine (see NativeExporter) at build time:
+#
+#   fuzzylite_native_engine(<engine.fll> <header.h>)
+#
+# The header is regenerated whenever the FLL file or the fuzzylite binary change.
+# Add the header to the sources of a target for the target to depend on it.
+function(fuzzylite_native_engine FLL HEADER)
+    if (NOT TARGET binaryTarget)
+        message(FATAL_ERROR "fuzzylite_native_engine requires the fuzzylite binary (FL_BUILD_BINARY=ON)")
+    endif ()
+    get_filename_component(FLL ${FLL} ABSOLUTE)
+    get_filename_component(HEADER ${HEADER} ABSOLUTE BASE_DIR ${CMAKE_CURRENT_BINARY_DIR})
+    get_filename_component(HEADER_DIRECTORY ${HEADER} DIRECTORY)
+    add_custom_command(
+            OUTPUT ${HEADER}
+            COMMAND ${CMAKE_COMMAND} -E make_directory ${HEADER_DIRECTORY}
+            COMMAND binaryTarget -i ${FLL} -of native -o ${HEADER}
+            DEPENDS ${FLL} binaryTarget
+            COMMENT "Generating native engine ${HEADER} from ${FLL}"
+            VERBATIM
+    )
+endfunction()
@@ -69,6 +69,12 @@ namespace fuzzylite {
         static const std::string KW_DATA_EXPORT_HEADER;
         /**Keyword for exporting input values in FLD*/
         static const std::string KW_DATA_EXPORT_INPUTS;
+        /**Keyword for the number of threads to evaluate the FLD*/
+        static const std::string KW_DATA_THREADS;
+        /**Keyword for the format of the FLD*/
+        static const std::string KW_DATA_FORMAT;
+        /**Keyword for reporting the progress of the FLD*/
+        static const std::string KW_DATA_PROGRESS;
 
         /**
           Creates a new Mamdani Engine based on the SimpleDimmer example
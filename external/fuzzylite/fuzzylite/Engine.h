@@ -19,8 +19,10 @@ fuzzylite is a registered trademark of FuzzyLite Limited.
 #define FL_ENGINE_H
 
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "fuzzylite/Instrumentation.h"
 #include "fuzzylite/fuzzylite.h"
 
 namespace fuzzylite {
@@ -34,6 +36,8 @@ namespace fuzzylite {
     class SNorm;
     class Defuzzifier;
     class Activation;
+    class EngineState;
+    class TaskPool;
 
     /**
       The Engine class is the core class of the library as it groups the
@@ -52,8 +56,18 @@ namespace fuzzylite {
         std::vector<InputVariable*> _inputVariables;
         std::vector<OutputVariable*> _outputVariables;
         std::vector<RuleBlock*> _ruleBlocks;
+        Instrumentation _instrumentation;
+        TaskPool* _taskPool;
+        std::size_t _parallelThreshold;
+        std::vector<std::pair<const RuleBlock*, std::size_t> > _plannedRuleBlocks;
+        std::vector<std::vector<RuleBlock*> > _parallelGroups;
+        std::size_t _parallelRules;
 
         void copyFrom(const Engine& source);
+        void planParallelActivation();
+        bool isParallelActivationPlanned() const;
+        bool activateInParallel();
+        bool defuzzifyInParallel();
 
       protected:
         void updateReferences() const;
@@ -134,17 +148,121 @@ namespace fuzzylite {
           @see Aggregated::clear()
           @see RuleBlock::activate()
           @see OutputVariable::defuzzify()
+          @see setTaskPool()
          */
         virtual void process();
 
+        /**
+          Processes the engine on the given state without modifying the engine
+          as follows: (a) Clears the aggregated fuzzy outputs of the state,
+          (b) Activates the rule blocks, and (c) Defuzzifies the output
+          variables, storing the results in the state. The engine can be
+          processed concurrently on different states.
+          @param state is the state created for this engine
+          @throws fl::Exception if the state was created for a different engine
+          @see EngineState
+         */
+        virtual void process(EngineState& state) const;
+
+        /**
+          Processes the engine incrementally on the given state without
+          modifying the engine, activating again only the rules that depend
+          on the input variables whose values changed since the last update,
+          and aggregating and defuzzifying again only the output variables
+          affected by those rules. The results are the same as those of
+          process(EngineState&).
+          @param state is the state created for this engine
+          @throws fl::Exception if the state was created for a different engine
+          @see EngineState::update()
+         */
+        virtual void update(EngineState& state) const;
+
         /**
           Restarts the engine by setting the values of the input variables to
-          fl::nan and clearing the output variables
+          fl::nan and clearing the output variables, and regroups the rule
+          blocks that process() activates in parallel
           @see Variable::setValue()
           @see OutputVariable::clear()
          */
         virtual void restart();
 
+        /**
+          Replaces the terms of the variables whose membership functions are
+          expensive to compute with Tabulated terms that approximate them
+          within the range of their variables, and reloads the rules to refer
+          to the new terms. The EngineState%s created beforehand must be
+          created again.
+          @param resolution is the number of intervals of the lookup tables
+          @return the largest estimated error of the lookup tables (see
+          Tabulated::getError()), fl::nan if any of them is fl::nan, or zero
+          if no term is replaced
+          @see Tabulated::isExpensive()
+         */
+        virtual scalar tabulate(int resolution);
+
+        /**
+          Gets the counters and timers collected by process(), which are only
+          collected when the library is built with `FL_INSTRUMENT`. The
+          counters collected by process(EngineState&) and update() are in
+          EngineState::instrumentation() instead.
+          @return the counters and timers collected by process()
+          @see Instrumentation
+         */
+        virtual const Instrumentation& instrumentation() const;
+        /**
+          Binds the instrumentation to the current structure of the engine and
+          sets its counters to zero, which is needed after the terms of the
+          engine are replaced (e.g., by tabulate())
+         */
+        virtual void resetInstrumentation();
+
+        /**
+          Sets the pool of threads where process() activates the independent
+          rule blocks (i.e., those whose rules do not conclude on the same
+          output variables) and defuzzifies the output variables in parallel.
+          Each stage runs in parallel only when its estimated work reaches the
+          parallel threshold, hence small engines are still processed
+          serially. The output variables are defuzzified serially when any of
+          them has a Function term, which may depend on the values of the
+          other output variables. The engine is processed serially when the
+          library is built with `FL_INSTRUMENT`.
+
+          The rule blocks are grouped once by the output variables of their
+          rules, and regrouped when the enabled rule blocks or their number
+          of rules change. The rules modified otherwise (e.g., their
+          consequents) require restart() to regroup the rule blocks.
+          @param taskPool is the pool of threads, which is not owned by the
+          engine, or null to process the engine serially (default)
+          @see TaskPool
+         */
+        virtual void setTaskPool(TaskPool* taskPool);
+        /**
+          Gets the pool of threads where process() runs its stages in parallel
+          @return the pool of threads where process() runs its stages in
+          parallel, or null if the engine is processed serially
+         */
+        virtual TaskPool* getTaskPool() const;
+
+        /**
+          Sets the minimum estimated work of a stage of process() to run it
+          in parallel, where the work of activating the rule blocks is the
+          number of rules, and the work of defuzzifying the output variables
+          is the number of terms times the resolution of the integral
+          defuzzifiers, or the cubed number of terms for the Centroid of
+          piecewise linear terms aggregated by Maximum (whose exact centroid
+          intersects the terms within each interval regardless of the
+          resolution), or one for the other defuzzifiers
+          @param parallelThreshold is the minimum estimated work of a stage
+          to run it in parallel (default: 1000)
+         */
+        virtual void setParallelThreshold(std::size_t parallelThreshold);
+        /**
+          Gets the minimum estimated work of a stage of process() to run it
+          in parallel
+          @return the minimum estimated work of a stage to run it in parallel
+         */
+        virtual std::size_t getParallelThreshold() const;
+
         /**
           Sets the name of the engine
           @param name is the name of the engine
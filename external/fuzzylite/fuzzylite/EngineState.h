@@ -0,0 +1,296 @@
+/*
+fuzzylite (R), a fuzzy logic control library in C++.
+
+Copyright (C) 2010-2024 FuzzyLite Limited. All rights reserved.
+Author: Juan Rada-Vilela, PhD <jcrada@fuzzylite.com>.
+
+This file is part of fuzzylite.
+
+fuzzylite is free software: you can redistribute it and/or modify it under
+the terms of the FuzzyLite License included with the software.
+
+You should have received a copy of the FuzzyLite License along with
+fuzzylite. If not, see <https://github.com/fuzzylite/fuzzylite/>.
+
+fuzzylite is a registered trademark of FuzzyLite Limited.
+*/
+
+#ifndef FL_ENGINESTATE_H
+#define FL_ENGINESTATE_H
+
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "fuzzylite/Instrumentation.h"
+#include "fuzzylite/fuzzylite.h"
+
+namespace fuzzylite {
+
+    class Engine;
+    class Aggregated;
+    class Expression;
+    class Proposition;
+    class Rule;
+    class SNorm;
+    class TNorm;
+    class Variable;
+
+    /**
+      The EngineState class contains the values that change while an Engine
+      is processed, namely the values of the input and output variables, the
+      aggregated fuzzy outputs and the activation degrees of the rules. An
+      Engine processed by means of Engine::process(EngineState&) is not
+      modified, which allows a single engine to be shared (read-only) amongst
+      multiple threads, each of them operating on its own EngineState.
+
+      The state resolves the rules of the engine into a compact form where
+      the variables are referenced by index. Hence, the structure of the
+      engine (i.e., its variables, terms and rules) must not change while
+      the state is in use, otherwise a new state must be created.
+
+      The EngineState supports rule blocks whose activation method is
+      General, and it does not support terms that depend on the values of
+      the engine variables (i.e., Linear and Function), since these read the
+      values from the engine rather than from the state. Hence, the engines
+      with such terms (including the compiled programs of Function) are
+      processed by Engine::process() only.
+
+      The propositions on input variables that are equal (i.e., same
+      variable, term and hedges) are evaluated once, and only when the value
+      of their input variable changes. The rules whose antecedents are
+      conjunctions of such propositions are indexed by proposition, such
+      that the rules containing a proposition whose degree is zero are not
+      evaluated when the conjunction is one of the built-in TNorm%s, for
+      which zero is absorbing (which TNormFunction and other TNorm%s do not
+      guarantee, hence their rules are always evaluated). Likewise, the fuzzy
+      outputs that receive no activations are not defuzzified, but take the
+      value of an empty fuzzy output instead.
+
+      The state can also be processed incrementally by means of
+      Engine::update(), in which case only the rules that depend on the
+      input variables whose values changed since the last update are
+      activated again, and only the output variables receiving rules whose
+      activation degrees changed are aggregated and defuzzified again,
+      reusing the results cached for everything else.
+
+      @author Juan Rada-Vilela, Ph.D.
+      @see Engine
+      @see Engine::process(EngineState&)
+      @since 7.1
+     */
+    class FL_API EngineState {
+      public:
+        /**
+          The Conclusion struct is a proposition of a consequent whose output
+          variable is referenced by index
+         */
+        struct Conclusion {
+            std::size_t output;
+            const Proposition* proposition;
+        };
+
+        /**
+          The Instruction struct is an element of the antecedent of a rule in
+          postfix notation, whose variables are referenced by index
+         */
+        struct Instruction {
+            enum Code { Input, Output, And, Or };
+
+            Code code;
+            std::size_t index;
+            const Proposition* proposition;
+            std::size_t slot;
+        };
+
+        /**
+          The CompiledRule struct is a rule whose antecedent is in postfix
+          notation and whose variables are referenced by index
+         */
+        struct CompiledRule {
+            const Rule* rule;
+            std::vector<Instruction> antecedent;
+            std::vector<Conclusion> consequent;
+            bool conjunctive;
+        };
+
+      private:
+        const Engine* _engine;
+        std::vector<scalar> _inputValues;
+        std::vector<scalar> _outputValues;
+        std::vector<scalar> _previousOutputValues;
+        std::vector<Aggregated*> _fuzzyOutputs;
+        std::vector<std::vector<CompiledRule> > _rules;
+        std::vector<std::vector<scalar> > _activationDegrees;
+        std::vector<scalar> _stack;
+        std::vector<Instruction> _propositions;
+        std::vector<scalar> _propositionValues;
+        std::vector<std::vector<std::size_t> > _inputPropositions;
+        std::vector<bool> _dirtyInputs;
+        bool _dirty;
+        std::size_t _irregularPropositions;
+        std::vector<std::vector<std::vector<std::size_t> > > _ruleIndex;
+        std::vector<bool> _pruned;
+        std::vector<scalar> _emptyOutputValues;
+        std::vector<bool> _changedInputs;
+        std::vector<std::vector<std::pair<std::size_t, std::size_t> > > _inputRules;
+        std::vector<std::pair<std::size_t, std::size_t> > _outputDependentRules;
+        std::vector<std::vector<std::pair<std::size_t, std::size_t> > > _outputRules;
+        std::vector<std::vector<bool> > _staleRules;
+        std::vector<bool> _dirtyOutputs;
+        std::vector<scalar> _rawOutputValues;
+        bool _updated;
+        Instrumentation _instrumentation;
+
+        void copyFrom(const EngineState& source);
+        void compile();
+        static void compileAntecedent(
+            const Expression* node,
+            const std::map<const Variable*, std::size_t>& inputs,
+            const std::map<const Variable*, std::size_t>& outputs,
+            std::vector<Instruction>& result
+        );
+        scalar evaluate(const Instruction& instruction) const;
+        void updatePropositions();
+        scalar activationDegree(const CompiledRule& compiled, const TNorm* conjunction, const SNorm* disjunction);
+        void aggregate(std::size_t output);
+        scalar rawValue(std::size_t index) const;
+        scalar finalValue(std::size_t index, scalar value) const;
+        void updateRawValue(std::size_t index);
+        void trigger(const CompiledRule& compiled, scalar activationDegree, const TNorm* implication);
+        static bool isZeroAbsorbing(const TNorm* tnorm);
+
+      public:
+        explicit EngineState(const Engine* engine);
+        EngineState(const EngineState& other);
+        EngineState& operator=(const EngineState& other);
+        virtual ~EngineState();
+        FL_DEFAULT_MOVE(EngineState)
+
+        /**
+          Gets the engine from which the state was created
+          @return the engine from which the state was created
+         */
+        virtual const Engine* getEngine() const;
+
+        /**
+          Sets the value of the input variable at the given index, bounding
+          the value to the range of the variable if it is locked
+          @param index is the index of the input variable
+          @param value is the value of the input variable
+         */
+        virtual void setInputValue(std::size_t index, scalar value);
+        /**
+          Gets the value of the input variable at the given index
+          @param index is the index of the input variable
+          @return the value of the input variable at the given index
+         */
+        virtual scalar getInputValue(std::size_t index) const;
+
+        /**
+          Gets the value of the output variable at the given index
+          @param index is the index of the output variable
+          @return the value of the output variable at the given index
+         */
+        virtual scalar getOutputValue(std::size_t index) const;
+        /**
+          Gets the previous value of the output variable at the given index
+          @param index is the index of the output variable
+          @return the previous value of the output variable at the given index
+         */
+        virtual scalar getPreviousOutputValue(std::size_t index) const;
+
+        /**
+          Gets the aggregated fuzzy output of the output variable at the given
+          index
+          @param index is the index of the output variable
+          @return the aggregated fuzzy output of the output variable
+         */
+        virtual Aggregated* fuzzyOutput(std::size_t index) const;
+
+        /**
+          Gets the activation degree of the given rule in the given rule block
+          @param ruleBlock is the index of the rule block
+          @param rule is the index of the rule in the rule block
+          @return the activation degree of the rule
+         */
+        virtual scalar getActivationDegree(std::size_t ruleBlock, std::size_t rule) const;
+
+        /**
+          Returns an immutable vector of the values of the input variables
+          @return an immutable vector of the values of the input variables
+         */
+        virtual const std::vector<scalar>& inputValues() const;
+        /**
+          Returns an immutable vector of the values of the output variables
+          @return an immutable vector of the values of the output variables
+         */
+        virtual const std::vector<scalar>& outputValues() const;
+
+        /**
+          Clears the aggregated fuzzy outputs
+         */
+        virtual void clearFuzzyOutputs();
+        /**
+          Activates the rules of the rule block at the given index, storing
+          their activation degrees and aggregating their consequents into the
+          fuzzy outputs. The conjunctive rules containing a proposition whose
+          degree is zero are not evaluated, unless a proposition has a degree
+          that is not in [0.0, 1.0] (e.g., fl::nan).
+          @param ruleBlock is the index of the rule block
+         */
+        virtual void activate(std::size_t ruleBlock);
+        /**
+          Defuzzifies the fuzzy output of the output variable at the given
+          index in the same manner as OutputVariable::defuzzify(), where an
+          empty fuzzy output takes the value computed upon construction
+          @param index is the index of the output variable
+         */
+        virtual void defuzzify(std::size_t index);
+        /**
+          Computes the value of the output variable at the given index from its
+          fuzzy output in the same manner as OutputVariable::defuzzify(),
+          without storing the value in the state
+          @param index is the index of the output variable
+          @return the defuzzified value of the output variable, or its current
+          value if the variable is disabled
+         */
+        virtual scalar defuzzified(std::size_t index) const;
+
+        /**
+          Processes the engine incrementally, activating only the rules that
+          depend on the input variables whose values changed since the last
+          update, and aggregating and defuzzifying only the output variables
+          that receive rules whose activation degrees changed. The results are
+          the same as those of Engine::process(EngineState&), which are
+          computed in full upon the first update, after the fuzzy outputs are
+          cleared, and always if an antecedent contains output variables.
+
+          The enabled status of the components of the engine must not change
+          between updates, otherwise the fuzzy outputs must be cleared first.
+         */
+        virtual void update();
+
+        /**
+          Restarts the state by setting the values of the input variables to
+          fl::nan and clearing the output variables
+         */
+        virtual void restart();
+
+        /**
+          Gets the counters and timers collected by
+          Engine::process(EngineState&) and update() on this state, which are
+          only collected when the library is built with `FL_INSTRUMENT`
+          @return the counters and timers collected on this state
+          @see Instrumentation
+         */
+        virtual const Instrumentation& instrumentation() const;
+        /**
+          Gets the counters and timers collected by
+          Engine::process(EngineState&) and update() on this state
+          @return the counters and timers collected on this state
+         */
+        virtual Instrumentation& instrumentation();
+    };
+}
+#endif /* FL_ENGINESTATE_H */
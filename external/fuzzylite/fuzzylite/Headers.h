@@ -27,8 +27,11 @@ fuzzylite is a registered trademark of FuzzyLite Limited.
 #include "fuzzylite/Benchmark.h"
 #include "fuzzylite/Console.h"
 #include "fuzzylite/Engine.h"
+#include "fuzzylite/EngineState.h"
 #include "fuzzylite/Exception.h"
+#include "fuzzylite/Instrumentation.h"
 #include "fuzzylite/Operation.h"
+#include "fuzzylite/TaskPool.h"
 #include "fuzzylite/activation/Activation.h"
 #include "fuzzylite/activation/First.h"
 #include "fuzzylite/activation/General.h"
@@ -71,10 +74,13 @@ fuzzylite is a registered trademark of FuzzyLite Limited.
 #include "fuzzylite/imex/FclImporter.h"
 #include "fuzzylite/imex/FisExporter.h"
 #include "fuzzylite/imex/FisImporter.h"
+#include "fuzzylite/imex/FlbExporter.h"
+#include "fuzzylite/imex/FlbImporter.h"
 #include "fuzzylite/imex/FldExporter.h"
 #include "fuzzylite/imex/FllExporter.h"
 #include "fuzzylite/imex/FllImporter.h"
 #include "fuzzylite/imex/JavaExporter.h"
+#include "fuzzylite/imex/NativeExporter.h"
 #include "fuzzylite/imex/RScriptExporter.h"
 #include "fuzzylite/norm/Norm.h"
 #include "fuzzylite/norm/SNorm.h"
@@ -122,6 +128,7 @@ fuzzylite is a registered trademark of FuzzyLite Limited.
 #include "fuzzylite/term/SigmoidDifference.h"
 #include "fuzzylite/term/SigmoidProduct.h"
 #include "fuzzylite/term/Spike.h"
+#include "fuzzylite/term/Tabulated.h"
 #include "fuzzylite/term/Term.h"
 #include "fuzzylite/term/Trapezoid.h"
 #include "fuzzylite/term/Triangle.h"
@@ -0,0 +1,292 @@
+/*
+fuzzylite (R), a fuzzy logic control library in C++.
+
+Copyright (C) 2010-2024 FuzzyLite Limited. All rights reserved.
+Author: Juan Rada-Vilela, PhD <jcrada@fuzzylite.com>.
+
+This file is part of fuzzylite.
+
+fuzzylite is free software: you can redistribute it and/or modify it under
+the terms of the FuzzyLite License included with the software.
+
+You should have received a copy of the FuzzyLite License along with
+fuzzylite. If not, see <https://github.com/fuzzylite/fuzzylite/>.
+
+fuzzylite is a registered trademark of FuzzyLite Limited.
+*/
+
+#ifndef FL_INSTRUMENTATION_H
+#define FL_INSTRUMENTATION_H
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "fuzzylite/fuzzylite.h"
+
+/**
+  The hooks of the instrumentation are compiled only when the library is
+  built with `-DFL_INSTRUMENT` (i.e., `cmake -DFL_INSTRUMENT=ON`) in C++11
+ */
+#if defined(FL_INSTRUMENT) && !defined(FL_CPP98)
+#define FL_INSTRUMENTED
+#endif
+
+namespace fuzzylite {
+
+    class Engine;
+    class EngineState;
+    class Term;
+
+    /**
+      The Instrumentation class contains the counters and timers collected
+      while an Engine is processed, namely the number of times each rule is
+      activated and fired together with its mean activation degree, the time
+      spent defuzzifying each output variable, the number of times the
+      membership function of each term is evaluated, and the time spent in
+      each stage of the processing (i.e., fuzzification, activation,
+      aggregation and defuzzification).
+
+      The counters are collected by Engine::process() into the instrumentation
+      of the engine, and by Engine::process(EngineState&) and
+      Engine::update() into the instrumentation of the state. Hence, the
+      counters are local to the thread operating on the engine or the state,
+      and the counters of multiple threads are combined by means of merge().
+
+      The counters are only collected when the library is built with
+      `FL_INSTRUMENT`, otherwise they remain empty and the hooks cost nothing.
+      When collected, the timers add a small overhead to each proposition,
+      rule and output variable.
+
+      @author Juan Rada-Vilela, Ph.D.
+      @see Engine::instrumentation()
+      @see EngineState::instrumentation()
+      @since 7.1
+     */
+    class FL_API Instrumentation {
+      public:
+        /**
+          Stages in which the processing of an engine is divided
+         */
+        enum Stage { Fuzzification, Activation, Aggregation, Defuzzification };
+
+        /**
+          The Timer class measures the time spent in a stage while the timer
+          is in scope, excluding the time recorded in other stages meanwhile
+          (e.g., the fuzzification of the propositions while activating the
+          rules), and records it in the current instrumentation, if any
+         */
+        class FL_API Timer {
+          private:
+            Instrumentation* _instrumentation;
+            Stage _stage;
+            scalar _start;
+            scalar _recorded;
+
+          public:
+            explicit Timer(Stage stage);
+            ~Timer();
+
+          private:
+            FL_DISABLE_COPY(Timer)
+        };
+
+        /**
+          The Scope class sets the current instrumentation of the thread while
+          the scope exists, and restores the previous one upon destruction
+         */
+        class FL_API Scope {
+          private:
+            Instrumentation* _previous;
+
+          public:
+            explicit Scope(Instrumentation* instrumentation);
+            ~Scope();
+
+          private:
+            FL_DISABLE_COPY(Scope)
+        };
+
+      private:
+        const Engine* _engine;
+        unsigned long _processes;
+        std::vector<std::vector<unsigned long> > _activations;
+        std::vector<std::vector<unsigned long> > _firings;
+        std::vector<std::vector<scalar> > _activationDegrees;
+        std::vector<unsigned long> _defuzzifications;
+        std::vector<scalar> _defuzzificationTimes;
+        std::vector<std::vector<unsigned long> > _memberships;
+        std::map<const Term*, std::pair<std::size_t, std::size_t> > _terms;
+        std::vector<scalar> _stageTimes;
+
+      public:
+        explicit Instrumentation(const Engine* engine = fl::null);
+        virtual ~Instrumentation();
+        FL_DEFAULT_COPY_AND_MOVE(Instrumentation)
+
+        /**
+          Indicates whether the library collects the counters, that is,
+          whether it was built with `FL_INSTRUMENT`
+          @return whether the library collects the counters
+         */
+        static bool isEnabled();
+
+        /**
+          Gets the instrumentation of the current thread, set by means of
+          Instrumentation::Scope
+          @return the instrumentation of the current thread, or fl::null
+         */
+        static Instrumentation* current();
+
+        /**
+          Gets the time elapsed since an arbitrary point in time
+          @return the time elapsed in nanoseconds, or zero in C++98
+         */
+        static scalar now();
+
+        /**
+          Binds the instrumentation to the structure of the engine and sets
+          the counters to zero
+          @param engine is the engine to instrument
+         */
+        virtual void reset(const Engine* engine);
+        /**
+          Sets the counters to zero
+         */
+        virtual void clear();
+        /**
+          Indicates whether the instrumentation is bound to the engine and
+          matches its current number of rule blocks, rules and variables
+          @param engine is the engine
+          @return whether the instrumentation is bound to the engine
+         */
+        virtual bool isBoundTo(const Engine* engine) const;
+        /**
+          Gets the engine to which the instrumentation is bound
+          @return the engine to which the instrumentation is bound
+         */
+        virtual const Engine* getEngine() const;
+
+        /**
+          Adds the counters of the other instrumentation to this one, or
+          copies them if this instrumentation is not bound to an engine. The
+          engines of both instrumentations must have the same structure (e.g.,
+          clones of each other).
+          @param other is the instrumentation to merge
+          @throws fl::Exception if the structures of the engines differ
+         */
+        virtual void merge(const Instrumentation& other);
+
+        /**
+          Records the processing of the engine, counting the activation of
+          the enabled rules and the firing of those whose activation degree is
+          greater than zero
+          @param state is the state from which to take the activation degrees
+          of the rules, or fl::null to take them from the rules themselves
+         */
+        virtual void recordProcess(const EngineState* state = fl::null);
+        /**
+          Records the time spent in the stage
+          @param stage is the stage
+          @param nanoseconds is the time spent in the stage
+         */
+        virtual void recordStage(Stage stage, scalar nanoseconds);
+        /**
+          Records the time spent defuzzifying the output variable at the given
+          index, which is also added to the Defuzzification stage
+          @param output is the index of the output variable
+          @param nanoseconds is the time spent defuzzifying
+         */
+        virtual void recordDefuzzification(std::size_t output, scalar nanoseconds);
+        /**
+          Records the evaluation of the membership function of the term, which
+          is ignored if the term does not belong to the engine
+          @param term is the term
+         */
+        virtual void recordMembership(const Term* term);
+
+        /**
+          Gets the number of times the engine was processed
+          @return the number of times the engine was processed
+         */
+        virtual unsigned long processes() const;
+        /**
+          Gets the number of times the rule was activated
+          @param ruleBlock is the index of the rule block
+          @param rule is the index of the rule in the rule block
+          @return the number of times the rule was activated
+         */
+        virtual unsigned long activations(std::size_t ruleBlock, std::size_t rule) const;
+        /**
+          Gets the number of times the rule fired, that is, it was activated
+          with an activation degree greater than zero
+          @param ruleBlock is the index of the rule block
+          @param rule is the index of the rule in the rule block
+          @return the number of times the rule fired
+         */
+        virtual unsigned long firings(std::size_t ruleBlock, std::size_t rule) const;
+        /**
+          Gets the mean activation degree of the rule
+          @param ruleBlock is the index of the rule block
+          @param rule is the index of the rule in the rule block
+          @return the mean activation degree of the rule, or fl::nan if the
+          rule was never activated
+         */
+        virtual scalar meanActivationDegree(std::size_t ruleBlock, std::size_t rule) const;
+        /**
+          Gets the number of times the output variable was defuzzified
+          @param output is the index of the output variable
+          @return the number of times the output variable was defuzzified
+         */
+        virtual unsigned long defuzzifications(std::size_t output) const;
+        /**
+          Gets the time spent defuzzifying the output variable
+          @param output is the index of the output variable
+          @return the time spent defuzzifying the output variable in
+          nanoseconds
+         */
+        virtual scalar defuzzificationTime(std::size_t output) const;
+        /**
+          Gets the number of times the membership function of the term was
+          evaluated
+          @param variable is the index of the variable in Engine::variables()
+          @param term is the index of the term in the variable
+          @return the number of times the membership function was evaluated
+         */
+        virtual unsigned long memberships(std::size_t variable, std::size_t term) const;
+        /**
+          Gets the time spent in the stage
+          @param stage is the stage
+          @return the time spent in the stage in nanoseconds
+         */
+        virtual scalar stageTime(Stage stage) const;
+        /**
+          Gets the fraction of the time spent in the stage over the time spent
+          in all the stages
+          @param stage is the stage
+          @return the fraction of the time spent in the stage, or fl::nan if
+          no time was recorded
+         */
+        virtual scalar stageFraction(Stage stage) const;
+        /**
+          Gets the time spent in all the stages
+          @return the time spent in all the stages in nanoseconds
+         */
+        virtual scalar totalTime() const;
+
+        /**
+          Gets the names of the rules that never fired, prefixed by the name of
+          their rule block
+          @return the rules that never fired
+         */
+        virtual std::vector<std::string> rulesNeverFired() const;
+
+        /**
+          Returns a report of the counters
+          @return a report of the counters
+         */
+        virtual std::string toString() const;
+    };
+}
+#endif /* FL_INSTRUMENTATION_H */
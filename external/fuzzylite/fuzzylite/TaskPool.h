@@ -0,0 +1,100 @@
+/*
+fuzzylite (R), a fuzzy logic control library in C++.
+
+Copyright (C) 2010-2024 FuzzyLite Limited. All rights reserved.
+Author: Juan Rada-Vilela, PhD <jcrada@fuzzylite.com>.
+
+This file is part of fuzzylite.
+
+fuzzylite is free software: you can redistribute it and/or modify it under
+the terms of the FuzzyLite License included with the software.
+
+You should have received a copy of the FuzzyLite License along with
+fuzzylite. If not, see <https://github.com/fuzzylite/fuzzylite/>.
+
+fuzzylite is a registered trademark of FuzzyLite Limited.
+*/
+
+#ifndef FL_TASKPOOL_H
+#define FL_TASKPOOL_H
+
+#include <cstddef>
+
+#include "fuzzylite/fuzzylite.h"
+
+namespace fuzzylite {
+
+    /**
+      The TaskPool class is a pool of threads that runs the tasks of a job
+      (e.g., defuzzifying each output variable of an Engine) in parallel,
+      where the thread submitting the job runs tasks as well.
+
+      The tasks of a job are split evenly between the threads, and every
+      thread that runs out of tasks steals half of the remaining tasks of
+      another thread, such that tasks of different costs keep every thread
+      busy until the whole job is done.
+
+      The pool runs one job at a time. A job submitted while the pool is
+      busy (e.g., by another thread, or by a task of the current job) is run
+      serially by the thread submitting it. When the library is built with
+      `FL_CPP98`, the pool has no threads and every job is run serially.
+
+      @author Juan Rada-Vilela, Ph.D.
+      @see Engine::setTaskPool()
+      @since 7.1
+     */
+    class FL_API TaskPool {
+      public:
+        /**
+          The Job class is the interface of the jobs run by the TaskPool,
+          whose tasks are identified by their index
+         */
+        class FL_API Job {
+          public:
+            Job();
+            virtual ~Job();
+            FL_DEFAULT_COPY_AND_MOVE(Job)
+
+            /**
+              Runs the task of the given index, which may be called from any
+              of the threads of the pool at the same time as the other tasks
+              @param index is the index of the task, from zero to the number
+              of tasks of the job
+             */
+            virtual void run(std::size_t index) = 0;
+        };
+
+      private:
+        class Implementation;
+        Implementation* _implementation;
+
+      public:
+        /**
+          Creates a pool with the given number of threads besides the threads
+          submitting the jobs
+          @param threads is the number of threads of the pool, or a negative
+          number for as many threads as hardware threads minus one
+         */
+        explicit TaskPool(int threads = -1);
+        virtual ~TaskPool();
+        FL_DISABLE_COPY(TaskPool)
+
+        /**
+          Gets the number of threads of the pool besides the threads
+          submitting the jobs
+          @return the number of threads of the pool
+         */
+        virtual int getThreads() const;
+
+        /**
+          Runs the tasks of the job in parallel and returns once all of them
+          are done
+          @param job is the job to run
+          @param tasks is the number of tasks of the job
+          @throws the first exception thrown by the tasks, once all the tasks
+          are done
+         */
+        virtual void run(Job& job, std::size_t tasks);
+    };
+}
+#endif /* FL_TASKPOOL_H */
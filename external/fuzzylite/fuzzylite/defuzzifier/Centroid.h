@@ -18,9 +18,12 @@ fuzzylite is a registered trademark of FuzzyLite Limited.
 #ifndef FL_CENTROID_H
 #define FL_CENTROID_H
 
+#include <vector>
+
 #include "fuzzylite/defuzzifier/IntegralDefuzzifier.h"
 
 namespace fuzzylite {
+    class Aggregated;
 
     /**
       The Centroid class is an IntegralDefuzzifier that computes the centroid
@@ -33,6 +36,9 @@ namespace fuzzylite {
       @since 4.0
      */
     class FL_API Centroid : public IntegralDefuzzifier {
+      private:
+        static std::size_t vertices(const Term* term, scalar* result);
+
       public:
         explicit Centroid(int resolution = defaultResolution());
         virtual ~Centroid() FL_IOVERRIDE;
@@ -43,7 +49,10 @@ namespace fuzzylite {
         /**
           Computes the centroid of a fuzzy set. The defuzzification process
           integrates over the fuzzy set utilizing the boundaries given as
-          parameters. The integration algorithm is the midpoint rectangle
+          parameters. If the fuzzy set is piecewise linear (see
+          Centroid::isPiecewiseLinear()), the centroid is computed exactly
+          from the vertices of the polygon regardless of the resolution.
+          Otherwise, the integration algorithm is the midpoint rectangle
           method (https://en.wikipedia.org/wiki/Rectangle_method).
 
           @param term is the fuzzy set
@@ -52,6 +61,42 @@ namespace fuzzylite {
           @return the @f$x@f$-coordinate of the centroid of the fuzzy set
          */
         virtual scalar defuzzify(const Term* term, scalar minimum, scalar maximum) const FL_IOVERRIDE;
+
+        /**
+          Indicates whether the fuzzy set is an Aggregated term whose
+          centroid can be computed exactly, that is, the aggregation operator
+          is Maximum, and the activated terms are finite Ramp, Triangle,
+          Trapezoid, or Rectangle terms implied by Minimum or AlgebraicProduct
+          @param term is the fuzzy set
+          @return whether the fuzzy set is piecewise linear
+         */
+        static bool isPiecewiseLinear(const Term* term);
+
+        /**
+          Indicates whether the term is a finite Ramp, Triangle, Trapezoid, or
+          Rectangle, whose activations can be part of a piecewise linear
+          fuzzy set
+          @param term is the term
+          @return whether the term is piecewise linear
+          @see Centroid::isPiecewiseLinear()
+         */
+        static bool isPiecewiseLinearTerm(const Term* term);
+
+        /**
+          Computes the exact centroid of a piecewise linear fuzzy set by
+          integrating the polygon that results from the vertices of the
+          activated terms, the intersections of the terms with their
+          activation degrees, and the intersections between the terms. The
+          points of the polygon are stored in the workspace of the fuzzy set,
+          which avoids allocating memory once the workspace has grown.
+          @param term is the fuzzy set, which must be piecewise linear
+          @param minimum is the minimum value of the fuzzy set
+          @param maximum is the maximum value of the fuzzy set
+          @return the @f$x@f$-coordinate of the centroid of the fuzzy set
+          @see Centroid::isPiecewiseLinear()
+         */
+        virtual scalar piecewiseLinear(const Aggregated* term, scalar minimum, scalar maximum) const;
+
         virtual Centroid* clone() const FL_IOVERRIDE;
 
         static Defuzzifier* constructor();
@@ -413,7 +413,7 @@ namespace fuzzylite {
     }
 
     inline std::string fuzzylite::version() {
-        const std::string __version__ = "7.0.0";
+        const std::string __version__ = "7.1.0";
         return __version__;
     }
 
@@ -0,0 +1,96 @@
+/*
+fuzzylite (R), a fuzzy logic control library in C++.
+
+Copyright (C) 2010-2024 FuzzyLite Limited. All rights reserved.
+Author: Juan Rada-Vilela, PhD <jcrada@fuzzylite.com>.
+
+This file is part of fuzzylite.
+
+fuzzylite is free software: you can redistribute it and/or modify it under
+the terms of the FuzzyLite License included with the software.
+
+You should have received a copy of the FuzzyLite License along with
+fuzzylite. If not, see <https://github.com/fuzzylite/fuzzylite/>.
+
+fuzzylite is a registered trademark of FuzzyLite Limited.
+*/
+
+#ifndef FL_FLBEXPORTER_H
+#define FL_FLBEXPORTER_H
+
+#include "fuzzylite/imex/Exporter.h"
+
+namespace fuzzylite {
+
+    /**
+      The FlbExporter class is an Exporter that translates an Engine into a
+      binary snapshot in the FuzzyLite Binary format (FLB), which is imported
+      by the FlbImporter without parsing any text.
+
+      The snapshot starts with a header containing the magic `FLB` followed
+      by a null character, the version of the format, the size of fl::scalar,
+      and a marker of the byte order of fl::scalar, all of which must match
+      upon importing the snapshot. The header is followed by the engine, its
+      variables with their terms, and its rule blocks with their norms and
+      rules, where the antecedents and consequents of the rules are stored as
+      expression trees that refer to the variables and terms by index. The
+      built-in terms store their parameters as binary fl::scalar%s (hence,
+      without the loss of precision of the decimals in FLL), and the other
+      terms store their parameters in text to be configured upon importing.
+
+      The snapshot is meant to load engines faster than FLL and to clone
+      engines without parsing the rules again, that is,
+      `FlbImporter().fromString(FlbExporter().toString(engine))`.
+
+      @author Juan Rada-Vilela, Ph.D.
+      @see FlbImporter
+      @see Exporter
+      @since 7.1
+     */
+    class FL_API FlbExporter : public Exporter {
+      public:
+        FlbExporter();
+        virtual ~FlbExporter() FL_IOVERRIDE;
+        FL_DEFAULT_COPY_AND_MOVE(FlbExporter)
+
+        virtual std::string name() const FL_IOVERRIDE;
+
+        /**
+          Returns the binary snapshot of the engine
+          @param engine is the engine to export
+          @return the binary snapshot of the engine
+          @throws fl::Exception if a rule refers to a variable or a term that
+          is not registered in the engine
+         */
+        virtual std::string toString(const Engine* engine) const FL_IOVERRIDE;
+
+        /**
+          Stores the binary snapshot of the engine into the given file
+          @param path is the full path of the file
+          @param engine is the engine to export
+         */
+        virtual void toFile(const std::string& path, const Engine* engine) const FL_IOVERRIDE;
+
+        /**
+          Gets the magic number that starts the snapshots
+          @return the magic number that starts the snapshots
+         */
+        static std::string magic();
+        /**
+          Gets the version of the format of the snapshots, which changes
+          whenever the format changes
+          @return the version of the format of the snapshots
+         */
+        static int version();
+        /**
+          Gets the scalar stored in the header of the snapshots whose bytes
+          must match upon importing the snapshot, which ensures the scalars
+          are stored in the same byte order and floating-point format
+          @return the scalar stored in the header of the snapshots
+         */
+        static scalar byteOrderMarker();
+
+        virtual FlbExporter* clone() const FL_IOVERRIDE;
+    };
+}
+#endif /* FL_FLBEXPORTER_H */
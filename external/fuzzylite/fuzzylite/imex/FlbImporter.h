@@ -0,0 +1,92 @@
+/*
+fuzzylite (R), a fuzzy logic control library in C++.
+
+Copyright (C) 2010-2024 FuzzyLite Limited. All rights reserved.
+Author: Juan Rada-Vilela, PhD <jcrada@fuzzylite.com>.
+
+This file is part of fuzzylite.
+
+fuzzylite is free software: you can redistribute it and/or modify it under
+the terms of the FuzzyLite License included with the software.
+
+You should have received a copy of the FuzzyLite License along with
+fuzzylite. If not, see <https://github.com/fuzzylite/fuzzylite/>.
+
+fuzzylite is a registered trademark of FuzzyLite Limited.
+*/
+
+#ifndef FL_FLBIMPORTER_H
+#define FL_FLBIMPORTER_H
+
+#include "fuzzylite/imex/Importer.h"
+
+namespace fuzzylite {
+
+    /**
+      The FlbImporter class is an Importer that configures an Engine from a
+      binary snapshot in the FuzzyLite Binary format (FLB) created by the
+      FlbExporter. The rules are created from the expression trees in the
+      snapshot, hence they are loaded without parsing their text.
+
+      The snapshot is read in place from memory by means of fromBuffer(),
+      without copying it, such that a snapshot can be imported directly from
+      a file mapped into memory. Likewise, cloneEngine() clones an engine
+      through a snapshot in memory.
+
+      @author Juan Rada-Vilela, Ph.D.
+      @see FlbExporter
+      @see Importer
+      @since 7.1
+     */
+    class FL_API FlbImporter : public Importer {
+      public:
+        FlbImporter();
+        virtual ~FlbImporter() FL_IOVERRIDE;
+        FL_DEFAULT_COPY_AND_MOVE(FlbImporter)
+
+        virtual std::string name() const FL_IOVERRIDE;
+
+        /**
+          Imports the engine from the binary snapshot
+          @param text is the binary snapshot
+          @return the engine in the snapshot
+          @throws fl::Exception if the snapshot is invalid
+         */
+        virtual Engine* fromString(const std::string& text) const FL_IOVERRIDE;
+        /**
+          Imports the engine from the binary snapshot in the given file
+          @param path is the full path of the file
+          @return the engine in the snapshot
+          @throws fl::Exception if the file cannot be read or the snapshot is
+          invalid
+         */
+        virtual Engine* fromFile(const std::string& path) const FL_IOVERRIDE;
+        /**
+          Imports the engine from the binary snapshot in the given buffer,
+          which is read in place
+          @param data is the buffer containing the snapshot
+          @param size is the size of the buffer in bytes
+          @return the engine in the snapshot
+          @throws fl::Exception if the snapshot is invalid (e.g., truncated,
+          or created by a different version of the format, byte order, or
+          size of fl::scalar)
+         */
+        virtual Engine* fromBuffer(const char* data, std::size_t size) const;
+
+        /**
+          Clones the engine by exporting it to a binary snapshot and importing
+          it back, which creates the rules from their expression trees rather
+          than parsing their text as Engine::clone() does. Unlike
+          Engine::clone(), the clone is processed serially (i.e., without the
+          TaskPool of the engine).
+          @param engine is the engine to clone
+          @return a clone of the engine
+          @throws fl::Exception if the engine cannot be exported to a snapshot
+          @see FlbExporter::toString()
+         */
+        virtual Engine* cloneEngine(const Engine* engine) const;
+
+        virtual FlbImporter* clone() const FL_IOVERRIDE;
+    };
+}
+#endif /* FL_FLBIMPORTER_H */
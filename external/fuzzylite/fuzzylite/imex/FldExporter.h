@@ -33,18 +33,26 @@ namespace fuzzylite {
       see [http://www.fuzzylite.com/fll-fld](http://www.fuzzylite.com/fll-fld)
       for more information.
 
+      The values of a dataset can be exported on multiple threads by means of
+      setThreads(), in which case the rows of the dataset (i.e., the values of
+      the grid or the lines of the reader) are divided in chunks of
+      getChunkSize() rows, each chunk is evaluated on an EngineState of the
+      engine (hence, the engine is not modified), and the chunks are streamed
+      to the writer in the order of the rows. The state of each chunk starts
+      from the current values of the engine, so the dataset is the same for any
+      number of threads, and it is the same as the one exported on a single
+      thread unless the output variables lock their previous values.
+
+      The dataset can also be exported in the binary format by means of
+      setFormat(), where the rows are stored in blocks of getChunkSize() rows,
+      and the values of each column are stored contiguously in each block.
+
       @author Juan Rada-Vilela, Ph.D.
       @see FllExporter
       @see Exporter
       @since 4.0
      */
     class FL_API FldExporter : public Exporter {
-      private:
-        std::string _separator;
-        bool _exportHeaders;
-        bool _exportInputValues;
-        bool _exportOutputValues;
-
       public:
         /**
          The ScopeOfValues refers to the scope of the equally-distributed values
@@ -57,6 +65,27 @@ namespace fuzzylite {
             AllVariables
         };
 
+        /**
+          The Format refers to the format of the dataset to write
+         */
+        enum Format {
+            /**Writes the rows in text separated by lines, and the values separated by the separator*/
+            Text,
+            /**Writes the rows in blocks in binary, see writeBinaryHeader()*/
+            Binary
+        };
+
+      private:
+        std::string _separator;
+        bool _exportHeaders;
+        bool _exportInputValues;
+        bool _exportOutputValues;
+        int _threads;
+        std::size_t _chunkSize;
+        Format _format;
+        std::ostream* _progress;
+
+      public:
         explicit FldExporter(const std::string& separator = " ");
         virtual ~FldExporter() FL_IOVERRIDE;
         FL_DEFAULT_COPY_AND_MOVE(FldExporter)
@@ -110,6 +139,55 @@ namespace fuzzylite {
          */
         virtual bool exportsOutputValues() const;
 
+        /**
+          Sets the number of threads to evaluate the datasets
+          @param threads is the number of threads to evaluate the datasets,
+          where `1` evaluates the engine itself (default), and `0` uses as
+          many threads as the hardware supports. Only one thread is used in
+          C++98.
+         */
+        virtual void setThreads(int threads);
+        /**
+          Gets the number of threads to evaluate the datasets
+          @return the number of threads to evaluate the datasets
+         */
+        virtual int getThreads() const;
+
+        /**
+          Sets the number of rows evaluated and written at once by each thread
+          @param chunkSize is the number of rows in each chunk
+         */
+        virtual void setChunkSize(std::size_t chunkSize);
+        /**
+          Gets the number of rows evaluated and written at once by each thread
+          @return the number of rows in each chunk
+         */
+        virtual std::size_t getChunkSize() const;
+
+        /**
+          Sets the format of the dataset to write
+          @param format is the format of the dataset to write
+         */
+        virtual void setFormat(Format format);
+        /**
+          Gets the format of the dataset to write
+          @return the format of the dataset to write
+         */
+        virtual Format getFormat() const;
+
+        /**
+          Sets the writer of the progress of the datasets, which reports the
+          number of rows written and the rows written per second
+          @param progress is the writer of the progress, or fl::null to
+          not report the progress (default)
+         */
+        virtual void setProgress(std::ostream* progress);
+        /**
+          Gets the writer of the progress of the datasets
+          @return the writer of the progress of the datasets
+         */
+        virtual std::ostream* getProgress() const;
+
         /**
           Gets the header of the dataset for the given engine
           @param engine is the engine to be exported
@@ -199,6 +277,28 @@ namespace fuzzylite {
          */
         virtual std::vector<scalar> parse(const std::string& values) const;
 
+        /**
+          Writes the header of the dataset in the binary format, which
+          contains the magic `FLD` followed by a null character, the version
+          of the format, the size of fl::scalar, the marker of the byte order
+          in FlbExporter::byteOrderMarker(), and the names of the columns. The
+          header is followed by blocks of rows, each starting with the number
+          of rows in the block and followed by the values of each column, and
+          the last block has no rows.
+          @param engine is the engine to export
+          @param writer is the output where the header will be written to
+         */
+        virtual void writeBinaryHeader(const Engine* engine, std::ostream& writer) const;
+        /**
+          Reads a dataset in the binary format
+          @param reader is the input containing the dataset in binary format
+          @param columns is the vector to store the names of the columns, if any
+          @return the rows of the dataset
+          @throws fl::Exception if the dataset is invalid
+         */
+        virtual std::vector<std::vector<scalar> >
+        readBinary(std::istream& reader, std::vector<std::string>* columns = fl::null) const;
+
         /**
           Writes the engine into the given writer
           @param engine is the engine to export
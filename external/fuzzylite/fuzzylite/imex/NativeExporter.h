@@ -0,0 +1,153 @@
+/*
+fuzzylite (R), a fuzzy logic control library in C++.
+
+Copyright (C) 2010-2024 FuzzyLite Limited. All rights reserved.
+Author: Juan Rada-Vilela, PhD <jcrada@fuzzylite.com>.
+
+This file is part of fuzzylite.
+
+fuzzylite is free software: you can redistribute it and/or modify it under
+the terms of the FuzzyLite License included with the software.
+
+You should have received a copy of the FuzzyLite License along with
+fuzzylite. If not, see <https://github.com/fuzzylite/fuzzylite/>.
+
+fuzzylite is a registered trademark of FuzzyLite Limited.
+*/
+
+#ifndef FL_NATIVEEXPORTER_H
+#define FL_NATIVEEXPORTER_H
+
+#include <set>
+#include <utility>
+
+#include "fuzzylite/imex/Exporter.h"
+
+namespace fuzzylite {
+    class Engine;
+    class Expression;
+    class Hedge;
+    class Proposition;
+    class RuleBlock;
+    class Term;
+
+    /**
+      The NativeExporter class is an Exporter that translates an Engine into
+      a standalone `C++` header that does not depend on the `fuzzylite`
+      library. The header contains a function
+      `void process(const double* input, double* output, double* previous)`
+      that evaluates the engine in the same manner as Engine::process(), where
+      the membership functions are inlined as arithmetic expressions, the
+      rules are unrolled into fixed expressions of their norms and hedges,
+      and the variables are addressed by index, without virtual calls nor
+      allocations of memory.
+
+      The exporter supports the engines whose rule blocks use the General
+      activation; conjunctions Minimum or AlgebraicProduct; disjunctions
+      Maximum or AlgebraicSum; implication Minimum or AlgebraicProduct (the
+      same in every rule block); antecedents on input variables only; and
+      output variables with aggregation Maximum, defuzzifier Centroid, and
+      Triangle, Trapezoid, Rectangle or Ramp terms, which are defuzzified
+      exactly as in Centroid::piecewiseLinear().
+
+      @author Juan Rada-Vilela, Ph.D.
+      @see CppExporter
+      @see Exporter
+      @since 7.1
+     */
+    class FL_API NativeExporter : public Exporter {
+      private:
+        std::string _namespace;
+
+      public:
+        explicit NativeExporter(const std::string& namespaceName = "");
+        virtual ~NativeExporter() FL_IOVERRIDE;
+        FL_DEFAULT_COPY_AND_MOVE(NativeExporter)
+
+        virtual std::string name() const FL_IOVERRIDE;
+        /**
+          Returns the standalone `C++` header that evaluates the engine
+          @param engine is the engine to export
+          @return the standalone `C++` header that evaluates the engine
+          @throws fl::Exception if the engine contains components that are
+          not supported
+         */
+        virtual std::string toString(const Engine* engine) const FL_IOVERRIDE;
+
+        /**
+          Sets the namespace of the exported code, which defaults to the name
+          of the engine if empty
+          @param namespaceName is the namespace of the exported code
+         */
+        virtual void setNamespace(const std::string& namespaceName);
+        /**
+          Gets the namespace of the exported code, which defaults to the name
+          of the engine if empty
+          @return the namespace of the exported code
+         */
+        virtual std::string getNamespace() const;
+
+        /**
+          Returns the helper functions used by the exported code
+          @return the helper functions used by the exported code
+         */
+        virtual std::string helpers() const;
+
+        /**
+          Returns the expression that computes the activation degree of the
+          antecedent in the `C++` programming language
+          @param node is the root of the antecedent
+          @param engine is the engine in which the antecedent is registered
+          @param ruleBlock is the rule block in which the antecedent is registered
+          @param memberships is the set where the pairs of indices of the input
+          variables and their terms used by the antecedent are stored
+          @return the expression that computes the activation degree of the
+          antecedent
+         */
+        virtual std::string antecedent(
+            const Expression* node,
+            const Engine* engine,
+            const RuleBlock* ruleBlock,
+            std::set<std::pair<std::size_t, std::size_t> >& memberships
+        ) const;
+
+        /**
+          Returns the expression that computes the membership function of
+          the term in the `C++` programming language
+          @param term is the term
+          @param x is the expression of the value to compute the membership of
+          @return the expression that computes the membership function of the
+          term
+         */
+        virtual std::string membership(const Term* term, const std::string& x) const;
+
+        /**
+          Returns the expression that applies the hedge in the `C++`
+          programming language
+          @param hedge is the hedge
+          @param x is the expression of the value to apply the hedge to
+          @return the expression that applies the hedge
+         */
+        virtual std::string hedge(const Hedge* hedge, const std::string& x) const;
+
+        /**
+          Returns the piecewise linear shape of the term in the `C++`
+          programming language
+          @param term is the term of an output variable
+          @return the piecewise linear shape of the term
+         */
+        virtual std::string shape(const Term* term) const;
+
+        /**
+          Returns a string representation of the scalar value in the `C++`
+          programming language with enough digits to represent it exactly
+          @param value is the scalar value
+          @return a string representation of the scalar value in the `C++`
+          programming language
+         */
+        virtual std::string toString(scalar value) const;
+
+        virtual NativeExporter* clone() const FL_IOVERRIDE;
+    };
+}
+#endif /* FL_NATIVEEXPORTER_H */
@@ -157,7 +157,8 @@ namespace fuzzylite {
          */
         virtual void unloadRules() const;
         /**
-          Loads all the rules into the rule block
+          Loads all the rules into the rule block, reserving storage in the
+          fuzzy outputs for the conclusions of the rules
           @param engine is the engine where this rule block is registered
          */
         virtual void loadRules(const Engine* engine);
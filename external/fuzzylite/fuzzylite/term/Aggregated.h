@@ -37,6 +37,12 @@ namespace fuzzylite {
       therefore their destructors will be called upon destruction of this term
       (or calling Aggregated::clear()).
 
+      The storage of the activated terms is preserved when the fuzzy set is
+      cleared, and it can be reserved upfront by means of
+      Aggregated::reserve(), such that aggregating the same number of terms
+      again does not allocate memory. Likewise, the workspace of the fuzzy
+      set provides buffers that the defuzzifiers reuse between calls.
+
       @author Juan Rada-Vilela, Ph.D.
       @see Antecedent
       @see Rule
@@ -46,10 +52,17 @@ namespace fuzzylite {
       @since 6.0
      */
     class FL_API Aggregated : public Term {
+      public:
+        /**
+          Number of buffers in the workspace of the fuzzy set
+         */
+        static const std::size_t WorkspaceBuffers = 4;
+
       private:
         scalar _minimum, _maximum;
         FL_unique_ptr<SNorm> _aggregation;
         std::vector<Activated> _terms;
+        mutable std::vector<scalar> _workspace[WorkspaceBuffers];
 
         void copyFrom(const Aggregated& source);
 
@@ -227,9 +240,33 @@ namespace fuzzylite {
          */
         virtual bool isEmpty() const;
         /**
-          Clears and deletes the activated terms
+          Clears and deletes the activated terms, preserving their storage
          */
         virtual void clear();
+        /**
+          Reserves storage for the given number of activated terms, such that
+          adding up to that number of terms does not allocate memory
+          @param terms is the number of activated terms to reserve storage for
+         */
+        virtual void reserve(std::size_t terms);
+        /**
+          Returns the number of activated terms that can be stored without
+          allocating memory
+          @return the number of activated terms that can be stored without
+          allocating memory
+         */
+        virtual std::size_t capacity() const;
+        /**
+          Gets the buffer at the given index of the workspace, which the
+          defuzzifiers use as scratch storage that preserves its memory between
+          calls. The contents of the buffers are undefined, and they are not
+          copied together with the fuzzy set.
+          @param index is the index of the buffer
+          @return the buffer at the given index of the workspace
+          @throws fl::Exception if the index is not smaller than
+          Aggregated::WorkspaceBuffers
+         */
+        virtual std::vector<scalar>& workspace(std::size_t index) const;
 
         /**
          * Representation of the aggregated term as a fuzzy value (eg, "0.4/Low + 0.5/High")
@@ -20,6 +20,7 @@ fuzzylite is a registered trademark of FuzzyLite Limited.
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include "fuzzylite/term/Term.h"
 
@@ -247,6 +248,23 @@ namespace fuzzylite {
             void copyFrom(const Node& source);
         };
 
+        /**
+          The Instruction struct is an element of the formula compiled in
+          postfix notation, whose variables are bound by index to the engine
+         */
+        struct FL_API Instruction {
+            enum Code { Constant, Argument, InputValue, OutputValue, UnaryCall, BinaryCall };
+
+            Code code;
+            scalar constant;
+            std::size_t index;
+            Unary unary;
+            Binary binary;
+        };
+
+        /**Maximum depth of the stack used to evaluate the compiled formulas*/
+        static const std::size_t MaximumStackSize = 64;
+
         /******************************
          * Term
          ******************************/
@@ -255,6 +273,10 @@ namespace fuzzylite {
         FL_unique_ptr<Node> _root;
         std::string _formula;
         const Engine* _engine;
+        std::vector<Instruction> _program;
+
+        void compile();
+        bool compile(const Node* node, std::size_t depth);
 
       public:
         /**A map of variables and substitution values**/
@@ -289,6 +311,14 @@ namespace fuzzylite {
           If the engine has been set, the current values of the input variables
           and output variables are added to the map of Function::variables. In
           addition, the variable @f$x@f$ will also be added to the map.
+
+          If the formula is compiled (see Function::isCompiled()), the value
+          is computed instead from the program in postfix notation, reading
+          the values of the variables directly from the engine, without
+          updating the map of Function::variables. Hence, the program runs
+          only when the engine itself is processed, since an EngineState keeps
+          the values of the variables apart from the engine and does not
+          support Function terms.
           @param x
           @return the membership function value of @f$x@f$ at the root node
          */
@@ -353,12 +383,28 @@ namespace fuzzylite {
           @return whether the formula is loaded
          */
         virtual bool isLoaded() const;
+        /**
+          Indicates whether the loaded formula is also compiled into a program
+          in postfix notation, which happens when the formula refers only to
+          @f$x@f$ and to the variables of the engine, and its evaluation
+          requires at most Function::MaximumStackSize values in the stack. The
+          expression tree remains as the reference to evaluate the formula.
+          @return whether the loaded formula is also compiled
+         */
+        virtual bool isCompiled() const;
+        /**
+          Gets the program in postfix notation compiled from the formula, which
+          is empty if the formula is not compiled
+          @return the program in postfix notation compiled from the formula
+         */
+        virtual const std::vector<Instruction>& program() const;
         /**
           Unloads the formula and resets the map of substitution variables.
          */
         virtual void unload();
         /**
-          Loads the current formula expressed in infix notation
+          Loads the current formula expressed in infix notation, compiling it
+          into a program in postfix notation where possible
          */
         virtual void load();
         /**
@@ -0,0 +1,200 @@
+/*
+fuzzylite (R), a fuzzy logic control library in C++.
+
+Copyright (C) 2010-2024 FuzzyLite Limited. All rights reserved.
+Author: Juan Rada-Vilela, PhD <jcrada@fuzzylite.com>.
+
+This file is part of fuzzylite.
+
+fuzzylite is free software: you can redistribute it and/or modify it under
+the terms of the FuzzyLite License included with the software.
+
+You should have received a copy of the FuzzyLite License along with
+fuzzylite. If not, see <https://github.com/fuzzylite/fuzzylite/>.
+
+fuzzylite is a registered trademark of FuzzyLite Limited.
+*/
+
+#ifndef FL_TABULATED_H
+#define FL_TABULATED_H
+
+#include <vector>
+
+#include "fuzzylite/term/Term.h"
+
+namespace fuzzylite {
+
+    /**
+      The Tabulated class is a Term that approximates the membership function
+      of another term by means of a lookup table, which samples the term
+      uniformly within a range and interpolates linearly between the samples.
+      The membership of values outside the range is computed by the term
+      itself. The table is computed once when the term is configured, and it
+      is shared (read-only) amongst the copies of the term, such that cloning
+      an engine does not compute the tables again.
+
+      The Tabulated term is meant to replace the terms whose membership
+      functions are expensive to compute (see Tabulated::isExpensive()), which
+      is done for a whole engine by means of Engine::tabulate(). The term
+      being tabulated must depend on @f$x@f$ only, and the height of the
+      Tabulated term is given by the term being tabulated.
+
+      @author Juan Rada-Vilela, Ph.D.
+      @see Engine::tabulate()
+      @see Term
+      @see Variable
+      @since 7.1
+     */
+    class FL_API Tabulated : public Term {
+      private:
+        FL_unique_ptr<Term> _term;
+        scalar _minimum, _maximum;
+        int _resolution;
+#ifdef FL_CPP98
+        std::vector<scalar> _table;
+#else
+        std::shared_ptr<const std::vector<scalar> > _table;
+#endif
+        scalar _error;
+
+        void copyFrom(const Tabulated& source);
+        const std::vector<scalar>& table() const;
+
+      public:
+        explicit Tabulated(
+            const std::string& name = "",
+            Term* term = fl::null,
+            scalar minimum = fl::nan,
+            scalar maximum = fl::nan,
+            int resolution = defaultResolution()
+        );
+        Tabulated(const Tabulated& other);
+        Tabulated& operator=(const Tabulated& other);
+        virtual ~Tabulated() FL_IOVERRIDE;
+        FL_DEFAULT_MOVE(Tabulated)
+
+        virtual std::string className() const FL_IOVERRIDE;
+        /**
+          Returns the parameters of the term
+          @return `"resolution minimum maximum className [parameters]"`, where
+          `className` and `parameters` are those of the tabulated term
+         */
+        virtual std::string parameters() const FL_IOVERRIDE;
+        /**
+          Configures the term with the parameters, creating the tabulated term
+          by means of the TermFactory and computing the table
+          @param parameters as `"resolution minimum maximum className [parameters]"`,
+          where `className` and `parameters` are those of the tabulated term
+         */
+        virtual void configure(const std::string& parameters) FL_IOVERRIDE;
+
+        /**
+          Computes the membership function evaluated at @f$x@f$ by linear
+          interpolation between the two samples of the table surrounding
+          @f$x@f$, or by the tabulated term if @f$x@f$ is outside the range
+          @param x
+          @return the approximate membership of @f$x@f$ to the tabulated term
+         */
+        virtual scalar membership(scalar x) const FL_IOVERRIDE;
+
+        /**
+          Updates the reference of the tabulated term, and computes the table
+          if it has not been computed yet
+          @param engine is the engine to which the term belongs
+         */
+        virtual void updateReference(const Engine* engine) FL_IOVERRIDE;
+
+        /**
+          Computes the table by sampling the tabulated term at
+          `resolution + 1` equally spaced values within the range, and
+          estimates the error of the table as the largest absolute difference
+          between the table and the term at three values within each
+          interval, which is not a bound of the error between those values,
+          and is fl::nan if any of the differences is fl::nan
+         */
+        virtual void tabulate();
+
+        /**
+          Sets the term to tabulate and computes the table
+          @param term is the term to tabulate
+         */
+        virtual void setTerm(Term* term);
+        /**
+          Gets the term being tabulated
+          @return the term being tabulated
+         */
+        virtual Term* getTerm() const;
+
+        /**
+          Sets the range of the table and computes the table
+          @param minimum is the minimum value of the table
+          @param maximum is the maximum value of the table
+         */
+        virtual void setRange(scalar minimum, scalar maximum);
+        /**
+          Gets the minimum value of the table
+          @return the minimum value of the table
+         */
+        virtual scalar getMinimum() const;
+        /**
+          Gets the maximum value of the table
+          @return the maximum value of the table
+         */
+        virtual scalar getMaximum() const;
+
+        /**
+          Sets the number of intervals of the table and computes the table
+          @param resolution is the number of intervals of the table
+         */
+        virtual void setResolution(int resolution);
+        /**
+          Gets the number of intervals of the table
+          @return the number of intervals of the table
+         */
+        virtual int getResolution() const;
+
+        /**
+          Gets the error of the table estimated upon computing it, as the
+          largest difference sampled between the table and the term (hence,
+          not a bound of the error)
+          @return the estimated error of the table, or fl::nan if the table is
+          not computed or the term is fl::nan at any of the samples
+         */
+        virtual scalar getError() const;
+
+        /**
+          Indicates whether the table has been computed
+          @return whether the table has been computed
+         */
+        virtual bool isTabulated() const;
+
+        /**
+          Indicates whether the table is shared with the given term
+          @param other is the other term
+          @return whether the table is shared with the given term
+         */
+        virtual bool sharesTable(const Tabulated& other) const;
+
+        /**
+          Indicates whether the membership function of the term is expensive
+          to compute, that is, the term is a Bell, Cosine, Discrete, Gaussian,
+          GaussianProduct, PiShape, Sigmoid, SigmoidDifference,
+          SigmoidProduct, or a Function that depends on @f$x@f$ only
+          @param term is the term
+          @return whether the membership function of the term is expensive to
+          compute
+         */
+        static bool isExpensive(const Term* term);
+
+        /**
+          Gets the default number of intervals of the tables
+          @return the default number of intervals of the tables
+         */
+        static int defaultResolution();
+
+        virtual Tabulated* clone() const FL_IOVERRIDE;
+
+        static Term* constructor();
+    };
+}
+#endif /* FL_TABULATED_H */
@@ -41,6 +41,9 @@ namespace fuzzylite {
 
     const std::string Console::KW_DATA_EXPORT_HEADER = "-dheader";
     const std::string Console::KW_DATA_EXPORT_INPUTS = "-dinputs";
+    const std::string Console::KW_DATA_THREADS = "-dthreads";
+    const std::string Console::KW_DATA_FORMAT = "-dformat";
+    const std::string Console::KW_DATA_PROGRESS = "-dprogress";
 
     Console::Option::Option(const std::string& key, const std::string& value, const std::string& description) :
         key(key),
@@ -50,11 +53,13 @@ namespace fuzzylite {
     std::vector<Console::Option> Console::availableOptions() {
         std::vector<Console::Option> options;
         options.push_back(Option(KW_INPUT_FILE, "inputfile", "file to import your engine from"));
-        options.push_back(Option(KW_INPUT_FORMAT, "format", "format of the file to import (fll | fis | fcl)"));
+        options.push_back(Option(KW_INPUT_FORMAT, "format", "format of the file to import (fll | flb | fis | fcl)"));
         options.push_back(Option(KW_OUTPUT_FILE, "outputfile", "file to export your engine to"));
-        options.push_back(
-            Option(KW_OUTPUT_FORMAT, "format", "format of the file to export (fll | fld | cpp | java | fis | fcl)")
-        );
+        options.push_back(Option(
+            KW_OUTPUT_FORMAT,
+            "format",
+            "format of the file to export (fll | fld | flb | cpp | native | java | fis | fcl)"
+        ));
         options.push_back(Option(
             KW_EXAMPLE, "letter", "if not inputfile, built-in example to use as engine: (m)amdani or (t)akagi-sugeno"
         ));
@@ -75,6 +80,15 @@ namespace fuzzylite {
         options.push_back(Option(KW_DATA_EXPORT_HEADER, "boolean", "if true and exporting to fld, include headers"));
         options.push_back(Option(KW_DATA_EXPORT_INPUTS, "boolean", "if true and exporting to fld, include input values")
         );
+        options.push_back(Option(
+            KW_DATA_THREADS, "number", "if exporting to fld, number of threads to evaluate your engine on (0: all)"
+        ));
+        options.push_back(
+            Option(KW_DATA_FORMAT, "format", "if exporting to fld, format of the results: [text|binary]")
+        );
+        options.push_back(
+            Option(KW_DATA_PROGRESS, "boolean", "if true and exporting to fld, report the progress to standard error")
+        );
         return options;
     }
 
@@ -184,13 +198,6 @@ namespace fuzzylite {
             if (it == options.end())
                 throw Exception("[option error] no input file specified", FL_AT);
             std::string inputFilename = it->second;
-            std::ifstream inputFile(inputFilename.c_str());
-            if (not inputFile.is_open())
-                throw Exception("[file error] file <" + inputFilename + "> could not be opened", FL_AT);
-            std::string line;
-            while (std::getline(inputFile, line))
-                textEngine << line << std::endl;
-            inputFile.close();
 
             it = options.find(KW_INPUT_FORMAT);
             if (it != options.end()) {
@@ -202,6 +209,22 @@ namespace fuzzylite {
                 else
                     throw Exception("[format error] unspecified format of input file", FL_AT);
             }
+
+            if ("flb" == inputFormat) {
+                std::ifstream inputFile(inputFilename.c_str(), std::ios::in | std::ios::binary);
+                if (not inputFile.is_open())
+                    throw Exception("[file error] file <" + inputFilename + "> could not be opened", FL_AT);
+                textEngine << inputFile.rdbuf();
+                inputFile.close();
+            } else {
+                std::ifstream inputFile(inputFilename.c_str());
+                if (not inputFile.is_open())
+                    throw Exception("[file error] file <" + inputFilename + "> could not be opened", FL_AT);
+                std::string line;
+                while (std::getline(inputFile, line))
+                    textEngine << line << std::endl;
+                inputFile.close();
+            }
         }
 
         std::string outputFilename;
@@ -224,7 +247,11 @@ namespace fuzzylite {
         if (outputFilename.empty()) {
             process(textEngine.str(), std::cout, inputFormat, outputFormat, options);
         } else {
-            std::ofstream writer(outputFilename.c_str());
+            std::ios::openmode mode = std::ios::out;
+            it = options.find(KW_DATA_FORMAT);
+            if ("flb" == outputFormat or ("fld" == outputFormat and it != options.end() and "binary" == it->second))
+                mode |= std::ios::binary;
+            std::ofstream writer(outputFilename.c_str(), mode);
             if (not writer.is_open())
                 throw Exception("[file error] file <" + outputFilename + "> could not be created", FL_AT);
             process(textEngine.str(), writer, inputFormat, outputFormat, options);
@@ -246,6 +273,8 @@ namespace fuzzylite {
 
         if ("fll" == inputFormat) {
             importer.reset(new FllImporter);
+        } else if ("flb" == inputFormat) {
+            importer.reset(new FlbImporter);
         } else if ("fcl" == inputFormat) {
             importer.reset(new FclImporter);
         } else if ("fis" == inputFormat) {
@@ -274,6 +303,18 @@ namespace fuzzylite {
             if ((it = options.find(KW_DATA_EXPORT_INPUTS)) != options.end())
                 exportInputValues = ("true" == it->second);
             fldExporter.setExportInputValues(exportInputValues);
+            if ((it = options.find(KW_DATA_THREADS)) != options.end())
+                fldExporter.setThreads((int)Op::toScalar(it->second));
+            if ((it = options.find(KW_DATA_FORMAT)) != options.end()) {
+                if ("binary" == it->second)
+                    fldExporter.setFormat(FldExporter::Binary);
+                else if ("text" == it->second)
+                    fldExporter.setFormat(FldExporter::Text);
+                else
+                    throw Exception("[export error] unknown format of results <" + it->second + ">", FL_AT);
+            }
+            if ((it = options.find(KW_DATA_PROGRESS)) != options.end() and "true" == it->second)
+                fldExporter.setProgress(&std::cerr);
             if ((it = options.find(KW_DATA_INPUT_FILE)) != options.end()) {
                 std::ifstream dataFile(it->second.c_str());
                 if (not dataFile.is_open())
@@ -313,12 +354,16 @@ namespace fuzzylite {
         } else {
             if ("fll" == outputFormat)
                 exporter.reset(new FllExporter);
+            else if ("flb" == outputFormat)
+                exporter.reset(new FlbExporter);
             else if ("fcl" == outputFormat)
                 exporter.reset(new FclExporter);
             else if ("fis" == outputFormat)
                 exporter.reset(new FisExporter);
             else if ("cpp" == outputFormat)
                 exporter.reset(new CppExporter);
+            else if ("native" == outputFormat)
+                exporter.reset(new NativeExporter);
             else if ("java" == outputFormat)
                 exporter.reset(new JavaExporter);
             else
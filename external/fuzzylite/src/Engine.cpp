@@ -17,12 +17,19 @@ fuzzylite is a registered trademark of FuzzyLite Limited.
 
 #include "fuzzylite/Engine.h"
 
+#include <map>
+
+#include "fuzzylite/EngineState.h"
+#include "fuzzylite/TaskPool.h"
 #include "fuzzylite/activation/General.h"
+#include "fuzzylite/defuzzifier/Centroid.h"
+#include "fuzzylite/defuzzifier/IntegralDefuzzifier.h"
 #include "fuzzylite/defuzzifier/WeightedAverage.h"
 #include "fuzzylite/defuzzifier/WeightedSum.h"
 #include "fuzzylite/factory/DefuzzifierFactory.h"
 #include "fuzzylite/factory/FactoryManager.h"
 #include "fuzzylite/imex/FllExporter.h"
+#include "fuzzylite/norm/s/Maximum.h"
 #include "fuzzylite/norm/t/AlgebraicProduct.h"
 #include "fuzzylite/rule/Consequent.h"
 #include "fuzzylite/rule/Expression.h"
@@ -30,10 +37,12 @@ fuzzylite is a registered trademark of FuzzyLite Limited.
 #include "fuzzylite/rule/RuleBlock.h"
 #include "fuzzylite/term/Aggregated.h"
 #include "fuzzylite/term/Constant.h"
+#include "fuzzylite/term/Function.h"
 #include "fuzzylite/term/Linear.h"
 #include "fuzzylite/term/Ramp.h"
 #include "fuzzylite/term/SShape.h"
 #include "fuzzylite/term/Sigmoid.h"
+#include "fuzzylite/term/Tabulated.h"
 #include "fuzzylite/term/ZShape.h"
 #include "fuzzylite/variable/InputVariable.h"
 #include "fuzzylite/variable/OutputVariable.h"
@@ -52,7 +61,10 @@ namespace fuzzylite {
         _description(description),
         _inputVariables(inputVariables),
         _outputVariables(outputVariables),
-        _ruleBlocks(ruleBlocks) {
+        _ruleBlocks(ruleBlocks),
+        _taskPool(fl::null),
+        _parallelThreshold(1000),
+        _parallelRules(0) {
         if (load) {
             updateReferences();
 
@@ -61,7 +73,12 @@ namespace fuzzylite {
         }
     }
 
-    Engine::Engine(const Engine& other) : _name(""), _description("") {
+    Engine::Engine(const Engine& other) :
+        _name(""),
+        _description(""),
+        _taskPool(fl::null),
+        _parallelThreshold(1000),
+        _parallelRules(0) {
         copyFrom(other);
     }
 
@@ -83,8 +100,14 @@ namespace fuzzylite {
     }
 
     void Engine::copyFrom(const Engine& other) {
+        _instrumentation.reset(fl::null);
         _name = other._name;
         _description = other._description;
+        _taskPool = other._taskPool;
+        _parallelThreshold = other._parallelThreshold;
+        _plannedRuleBlocks.clear();
+        _parallelGroups.clear();
+        _parallelRules = 0;
         for (std::size_t i = 0; i < other._inputVariables.size(); ++i)
             _inputVariables.push_back(new InputVariable(*other._inputVariables.at(i)));
         for (std::size_t i = 0; i < other._outputVariables.size(); ++i)
@@ -292,9 +315,71 @@ namespace fuzzylite {
             inputVariables().at(i)->setValue(fl::nan);
         for (std::size_t i = 0; i < outputVariables().size(); ++i)
             outputVariables().at(i)->clear();
+        if (_taskPool)
+            planParallelActivation();
+    }
+
+    scalar Engine::tabulate(int resolution) {
+        scalar error = 0.0;
+        bool replaced = false;
+        const std::vector<Variable*> myVariables = variables();
+        for (std::size_t i = 0; i < myVariables.size(); ++i) {
+            Variable* variable = myVariables.at(i);
+            if (not(Op::isFinite(variable->getMinimum()) and Op::isFinite(variable->getMaximum())))
+                continue;
+            for (std::size_t t = 0; t < variable->numberOfTerms(); ++t) {
+                const Term* term = variable->getTerm(t);
+                if (not Tabulated::isExpensive(term))
+                    continue;
+                Tabulated* tabulated = new Tabulated(
+                    term->getName(), variable->removeTerm(t), variable->getMinimum(), variable->getMaximum(), resolution
+                );
+                variable->insertTerm(tabulated, t);
+                if (Op::isNaN(tabulated->getError()) or tabulated->getError() > error)
+                    error = tabulated->getError();
+                replaced = true;
+            }
+        }
+        // the rules refer to the terms that were replaced
+        if (replaced) {
+            for (std::size_t i = 0; i < _ruleBlocks.size(); ++i)
+                _ruleBlocks.at(i)->reloadRules(this);
+        }
+        return error;
+    }
+
+    const Instrumentation& Engine::instrumentation() const {
+        return _instrumentation;
+    }
+
+    void Engine::setTaskPool(TaskPool* taskPool) {
+        this->_taskPool = taskPool;
+        if (_taskPool)
+            planParallelActivation();
+    }
+
+    TaskPool* Engine::getTaskPool() const {
+        return this->_taskPool;
+    }
+
+    void Engine::setParallelThreshold(std::size_t parallelThreshold) {
+        this->_parallelThreshold = parallelThreshold;
+    }
+
+    std::size_t Engine::getParallelThreshold() const {
+        return this->_parallelThreshold;
+    }
+
+    void Engine::resetInstrumentation() {
+        _instrumentation.reset(this);
     }
 
     void Engine::process() {
+#ifdef FL_INSTRUMENTED
+        if (not _instrumentation.isBoundTo(this))
+            _instrumentation.reset(this);
+        Instrumentation::Scope scope(&_instrumentation);
+#endif
         for (std::size_t i = 0; i < _outputVariables.size(); ++i)
             _outputVariables.at(i)->fuzzyOutput()->clear();
 
@@ -313,17 +398,35 @@ namespace fuzzylite {
         }
         FL_DEBUG_END;
 
-        for (std::size_t i = 0; i < _ruleBlocks.size(); ++i) {
-            RuleBlock* ruleBlock = _ruleBlocks.at(i);
-            if (ruleBlock->isEnabled()) {
-                FL_DBG("===============");
-                FL_DBG("RULE BLOCK: " << ruleBlock->getName());
-                ruleBlock->activate();
+        if (not activateInParallel()) {
+            for (std::size_t i = 0; i < _ruleBlocks.size(); ++i) {
+                RuleBlock* ruleBlock = _ruleBlocks.at(i);
+                if (ruleBlock->isEnabled()) {
+                    FL_DBG("===============");
+                    FL_DBG("RULE BLOCK: " << ruleBlock->getName());
+#ifdef FL_INSTRUMENTED
+                    // excludes the fuzzification and aggregation timed within
+                    Instrumentation::Timer timer(Instrumentation::Activation);
+#endif
+                    ruleBlock->activate();
+                }
             }
         }
 
-        for (std::size_t i = 0; i < _outputVariables.size(); ++i)
-            _outputVariables.at(i)->defuzzify();
+        if (not defuzzifyInParallel()) {
+            for (std::size_t i = 0; i < _outputVariables.size(); ++i) {
+#ifdef FL_INSTRUMENTED
+                const scalar start = Instrumentation::now();
+                _outputVariables.at(i)->defuzzify();
+                _instrumentation.recordDefuzzification(i, Instrumentation::now() - start);
+#else
+                _outputVariables.at(i)->defuzzify();
+#endif
+            }
+        }
+#ifdef FL_INSTRUMENTED
+        _instrumentation.recordProcess();
+#endif
 
         FL_DEBUG_BEGIN;
         FL_DBG("===============");
@@ -349,6 +452,211 @@ namespace fuzzylite {
         FL_DEBUG_END;
     }
 
+    namespace {
+        /** Activates each group of rule blocks, in order, as a task */
+        class RuleBlockActivation : public TaskPool::Job {
+          private:
+            const std::vector<std::vector<RuleBlock*> >* _groups;
+
+          public:
+            explicit RuleBlockActivation(const std::vector<std::vector<RuleBlock*> >* groups) : _groups(groups) {}
+
+            virtual void run(std::size_t index) FL_IOVERRIDE {
+                const std::vector<RuleBlock*>& group = _groups->at(index);
+                for (std::size_t i = 0; i < group.size(); ++i)
+                    group.at(i)->activate();
+            }
+        };
+
+        /** Defuzzifies each output variable as a task */
+        class Defuzzification : public TaskPool::Job {
+          private:
+            const std::vector<OutputVariable*>* _outputVariables;
+
+          public:
+            explicit Defuzzification(const std::vector<OutputVariable*>* outputVariables) :
+                _outputVariables(outputVariables) {}
+
+            virtual void run(std::size_t index) FL_IOVERRIDE {
+                _outputVariables->at(index)->defuzzify();
+            }
+        };
+
+        /** Indicates whether the Centroid of the output variable is computed exactly from its vertices */
+        bool isPiecewiseLinear(const OutputVariable* outputVariable) {
+            if (not dynamic_cast<const Centroid*>(outputVariable->getDefuzzifier())
+                or not dynamic_cast<const Maximum*>(outputVariable->fuzzyOutput()->getAggregation()))
+                return false;
+            for (std::size_t t = 0; t < outputVariable->numberOfTerms(); ++t) {
+                if (not Centroid::isPiecewiseLinearTerm(outputVariable->getTerm(t)))
+                    return false;
+            }
+            return true;
+        }
+
+        /** Adds the output variables in the propositions of the expression */
+        void addOutputVariables(const Expression* expression, std::vector<const Variable*>& outputVariables) {
+            if (not expression)
+                return;
+            if (expression->type() == Expression::Proposition) {
+                const Variable* variable = static_cast<const Proposition*>(expression)->variable;
+                if (variable and variable->type() == Variable::Output)
+                    outputVariables.push_back(variable);
+            } else {
+                const Operator* op = static_cast<const Operator*>(expression);
+                addOutputVariables(op->left, outputVariables);
+                addOutputVariables(op->right, outputVariables);
+            }
+        }
+    }
+
+    void Engine::planParallelActivation() {
+        // the rule blocks that use the same output variables are grouped to be activated in order,
+        // since they aggregate on (or their antecedents read) the same fuzzy outputs
+        _plannedRuleBlocks.clear();
+        _parallelGroups.clear();
+        _parallelRules = 0;
+        std::vector<std::size_t> groupOf(_ruleBlocks.size(), _ruleBlocks.size());
+        std::map<const Variable*, std::size_t> groupOfVariable;
+        for (std::size_t b = 0; b < _ruleBlocks.size(); ++b) {
+            const RuleBlock* ruleBlock = _ruleBlocks.at(b);
+            if (not ruleBlock->isEnabled())
+                continue;
+            _plannedRuleBlocks.push_back(std::make_pair(ruleBlock, ruleBlock->numberOfRules()));
+            groupOf.at(b) = b;
+            _parallelRules += ruleBlock->numberOfRules();
+            std::vector<const Variable*> outputVariables;
+            for (std::size_t r = 0; r < ruleBlock->numberOfRules(); ++r) {
+                const Rule* rule = ruleBlock->getRule(r);
+                if (not rule->isLoaded())
+                    continue;
+                const std::vector<Proposition*>& conclusions = rule->getConsequent()->conclusions();
+                for (std::size_t c = 0; c < conclusions.size(); ++c)
+                    outputVariables.push_back(conclusions.at(c)->variable);
+                addOutputVariables(rule->getAntecedent()->getExpression(), outputVariables);
+            }
+            for (std::size_t v = 0; v < outputVariables.size(); ++v) {
+                const std::size_t group = groupOf.at(b);
+                const std::size_t merged
+                    = groupOfVariable.insert(std::make_pair(outputVariables.at(v), group)).first->second;
+                if (merged == group)
+                    continue;
+                for (std::size_t other = 0; other <= b; ++other) {
+                    if (groupOf.at(other) == group)
+                        groupOf.at(other) = merged;
+                }
+                for (std::map<const Variable*, std::size_t>::iterator it = groupOfVariable.begin();
+                     it != groupOfVariable.end();
+                     ++it) {
+                    if (it->second == group)
+                        it->second = merged;
+                }
+            }
+        }
+
+        std::vector<std::size_t> indexOfGroup(_ruleBlocks.size(), _ruleBlocks.size());
+        for (std::size_t b = 0; b < _ruleBlocks.size(); ++b) {
+            const std::size_t group = groupOf.at(b);
+            if (group == _ruleBlocks.size())
+                continue;
+            if (indexOfGroup.at(group) == _ruleBlocks.size()) {
+                indexOfGroup.at(group) = _parallelGroups.size();
+                _parallelGroups.push_back(std::vector<RuleBlock*>());
+            }
+            _parallelGroups.at(indexOfGroup.at(group)).push_back(_ruleBlocks.at(b));
+        }
+    }
+
+    bool Engine::isParallelActivationPlanned() const {
+        std::size_t planned = 0;
+        for (std::size_t b = 0; b < _ruleBlocks.size(); ++b) {
+            const RuleBlock* ruleBlock = _ruleBlocks.at(b);
+            if (not ruleBlock->isEnabled())
+                continue;
+            if (planned == _plannedRuleBlocks.size() or _plannedRuleBlocks.at(planned).first != ruleBlock
+                or _plannedRuleBlocks.at(planned).second != ruleBlock->numberOfRules())
+                return false;
+            ++planned;
+        }
+        return planned == _plannedRuleBlocks.size();
+    }
+
+    bool Engine::activateInParallel() {
+#ifdef FL_INSTRUMENTED
+        return false;
+#else
+        if (not _taskPool)
+            return false;
+        if (not isParallelActivationPlanned())
+            planParallelActivation();
+        if (_parallelRules < _parallelThreshold or _parallelGroups.size() < 2)
+            return false;
+
+        RuleBlockActivation activation(&_parallelGroups);
+        _taskPool->run(activation, _parallelGroups.size());
+        return true;
+#endif
+    }
+
+    bool Engine::defuzzifyInParallel() {
+#ifdef FL_INSTRUMENTED
+        return false;
+#else
+        if (not _taskPool or _outputVariables.size() < 2)
+            return false;
+
+        std::size_t work = 0;
+        for (std::size_t i = 0; i < _outputVariables.size(); ++i) {
+            const OutputVariable* outputVariable = _outputVariables.at(i);
+            if (not outputVariable->isEnabled())
+                continue;
+            for (std::size_t t = 0; t < outputVariable->numberOfTerms(); ++t) {
+                if (dynamic_cast<const Function*>(outputVariable->getTerm(t)))
+                    return false;
+            }
+            const std::size_t terms = std::max(std::size_t(1), outputVariable->numberOfTerms());
+            const IntegralDefuzzifier* integral
+                = dynamic_cast<const IntegralDefuzzifier*>(outputVariable->getDefuzzifier());
+            if (not integral)
+                work += terms;
+            else if (isPiecewiseLinear(outputVariable))
+                work += terms * terms * terms;
+            else
+                work += terms * std::size_t(std::max(1, integral->getResolution()));
+        }
+        if (work < _parallelThreshold)
+            return false;
+
+        Defuzzification defuzzification(&_outputVariables);
+        _taskPool->run(defuzzification, _outputVariables.size());
+        return true;
+#endif
+    }
+
+    void Engine::process(EngineState& state) const {
+        if (state.getEngine() != this)
+            throw Exception("[engine error] the state was not created for engine <" + getName() + ">", FL_AT);
+
+        state.clearFuzzyOutputs();
+
+        for (std::size_t i = 0; i < _ruleBlocks.size(); ++i) {
+            if (_ruleBlocks.at(i)->isEnabled())
+                state.activate(i);
+        }
+
+        for (std::size_t i = 0; i < _outputVariables.size(); ++i)
+            state.defuzzify(i);
+#ifdef FL_INSTRUMENTED
+        state.instrumentation().recordProcess(&state);
+#endif
+    }
+
+    void Engine::update(EngineState& state) const {
+        if (state.getEngine() != this)
+            throw Exception("[engine error] the state was not created for engine <" + getName() + ">", FL_AT);
+        state.update();
+    }
+
     void Engine::setName(const std::string& name) {
         this->_name = name;
     }
@@ -0,0 +1,739 @@
+/*
+fuzzylite (R), a fuzzy logic control library in C++.
+
+Copyright (C) 2010-2024 FuzzyLite Limited. All rights reserved.
+Author: Juan Rada-Vilela, PhD <jcrada@fuzzylite.com>.
+
+This file is part of fuzzylite.
+
+fuzzylite is free software: you can redistribute it and/or modify it under
+the terms of the FuzzyLite License included with the software.
+
+You should have received a copy of the FuzzyLite License along with
+fuzzylite. If not, see <https://github.com/fuzzylite/fuzzylite/>.
+
+fuzzylite is a registered trademark of FuzzyLite Limited.
+*/
+
+#include "fuzzylite/EngineState.h"
+
+#include <algorithm>
+#include <map>
+#include <typeinfo>
+
+#include "fuzzylite/Engine.h"
+#include "fuzzylite/activation/General.h"
+#include "fuzzylite/defuzzifier/Defuzzifier.h"
+#include "fuzzylite/hedge/Any.h"
+#include "fuzzylite/norm/t/AlgebraicProduct.h"
+#include "fuzzylite/norm/t/BoundedDifference.h"
+#include "fuzzylite/norm/t/DrasticProduct.h"
+#include "fuzzylite/norm/t/EinsteinProduct.h"
+#include "fuzzylite/norm/t/HamacherProduct.h"
+#include "fuzzylite/norm/t/Minimum.h"
+#include "fuzzylite/norm/t/NilpotentMinimum.h"
+#include "fuzzylite/rule/Expression.h"
+#include "fuzzylite/rule/Rule.h"
+#include "fuzzylite/rule/RuleBlock.h"
+#include "fuzzylite/term/Aggregated.h"
+#include "fuzzylite/term/Function.h"
+#include "fuzzylite/term/Linear.h"
+#include "fuzzylite/variable/InputVariable.h"
+#include "fuzzylite/variable/OutputVariable.h"
+
+namespace fuzzylite {
+
+    EngineState::EngineState(const Engine* engine) :
+        _engine(engine),
+        _dirty(true),
+        _irregularPropositions(0),
+        _updated(false) {
+        if (not engine)
+            throw Exception("[engine state error] expected an engine, but got null", FL_AT);
+        for (std::size_t i = 0; i < engine->numberOfInputVariables(); ++i)
+            _inputValues.push_back(engine->getInputVariable(i)->getValue());
+        for (std::size_t i = 0; i < engine->numberOfOutputVariables(); ++i) {
+            const OutputVariable* outputVariable = engine->getOutputVariable(i);
+            _outputValues.push_back(outputVariable->getValue());
+            _previousOutputValues.push_back(outputVariable->getPreviousValue());
+            _fuzzyOutputs.push_back(outputVariable->fuzzyOutput()->clone());
+        }
+        compile();
+#ifdef FL_INSTRUMENTED
+        _instrumentation.reset(engine);
+#endif
+    }
+
+    EngineState::EngineState(const EngineState& other) :
+        _engine(fl::null),
+        _dirty(true),
+        _irregularPropositions(0),
+        _updated(false) {
+        copyFrom(other);
+    }
+
+    EngineState& EngineState::operator=(const EngineState& other) {
+        if (this != &other) {
+            for (std::size_t i = 0; i < _fuzzyOutputs.size(); ++i)
+                delete _fuzzyOutputs.at(i);
+            _fuzzyOutputs.clear();
+
+            copyFrom(other);
+        }
+        return *this;
+    }
+
+    EngineState::~EngineState() {
+        for (std::size_t i = 0; i < _fuzzyOutputs.size(); ++i)
+            delete _fuzzyOutputs.at(i);
+    }
+
+    void EngineState::copyFrom(const EngineState& source) {
+        _engine = source._engine;
+        _inputValues = source._inputValues;
+        _outputValues = source._outputValues;
+        _previousOutputValues = source._previousOutputValues;
+        for (std::size_t i = 0; i < source._fuzzyOutputs.size(); ++i)
+            _fuzzyOutputs.push_back(source._fuzzyOutputs.at(i)->clone());
+        _rules = source._rules;
+        _activationDegrees = source._activationDegrees;
+        _stack.reserve(source._stack.capacity());
+        _propositions = source._propositions;
+        _propositionValues = source._propositionValues;
+        _inputPropositions = source._inputPropositions;
+        _dirtyInputs = source._dirtyInputs;
+        _dirty = source._dirty;
+        _irregularPropositions = source._irregularPropositions;
+        _ruleIndex = source._ruleIndex;
+        _pruned = source._pruned;
+        _emptyOutputValues = source._emptyOutputValues;
+        _changedInputs = source._changedInputs;
+        _inputRules = source._inputRules;
+        _outputDependentRules = source._outputDependentRules;
+        _outputRules = source._outputRules;
+        _staleRules = source._staleRules;
+        _dirtyOutputs = source._dirtyOutputs;
+        _rawOutputValues = source._rawOutputValues;
+        _updated = source._updated;
+        _instrumentation = source._instrumentation;
+    }
+
+    void EngineState::compileAntecedent(
+        const Expression* node,
+        const std::map<const Variable*, std::size_t>& inputs,
+        const std::map<const Variable*, std::size_t>& outputs,
+        std::vector<Instruction>& result
+    ) {
+        Instruction instruction;
+        if (node->type() == Expression::Proposition) {
+            const Proposition* proposition = static_cast<const Proposition*>(node);
+            std::map<const Variable*, std::size_t>::const_iterator it = inputs.find(proposition->variable);
+            if (it != inputs.end()) {
+                instruction.code = Instruction::Input;
+            } else {
+                it = outputs.find(proposition->variable);
+                if (it == outputs.end())
+                    throw Exception(
+                        "[engine state error] variable in proposition <" + proposition->toString()
+                            + "> is not registered in the engine",
+                        FL_AT
+                    );
+                instruction.code = Instruction::Output;
+            }
+            instruction.index = it->second;
+            instruction.proposition = proposition;
+            instruction.slot = 0;
+        } else {
+            const Operator* fuzzyOperator = static_cast<const Operator*>(node);
+            if (not(fuzzyOperator->left and fuzzyOperator->right))
+                throw Exception("[syntax error] left and right operands must exist", FL_AT);
+            compileAntecedent(fuzzyOperator->left, inputs, outputs, result);
+            compileAntecedent(fuzzyOperator->right, inputs, outputs, result);
+            if (fuzzyOperator->name == Rule::andKeyword())
+                instruction.code = Instruction::And;
+            else if (fuzzyOperator->name == Rule::orKeyword())
+                instruction.code = Instruction::Or;
+            else
+                throw Exception("[syntax error] operator <" + fuzzyOperator->name + "> not recognized", FL_AT);
+            instruction.index = 0;
+            instruction.proposition = fl::null;
+            instruction.slot = 0;
+        }
+        result.push_back(instruction);
+    }
+
+    void EngineState::compile() {
+        std::map<const Variable*, std::size_t> inputs, outputs;
+        for (std::size_t i = 0; i < _engine->numberOfInputVariables(); ++i)
+            inputs[_engine->getInputVariable(i)] = i;
+        for (std::size_t i = 0; i < _engine->numberOfOutputVariables(); ++i)
+            outputs[_engine->getOutputVariable(i)] = i;
+
+        const std::vector<Variable*> variables = _engine->variables();
+        for (std::size_t i = 0; i < variables.size(); ++i) {
+            for (std::size_t t = 0; t < variables.at(i)->numberOfTerms(); ++t) {
+                const Term* term = variables.at(i)->getTerm(t);
+                if (dynamic_cast<const Linear*>(term) or dynamic_cast<const Function*>(term))
+                    throw Exception(
+                        "[engine state error] term <" + term->toString() + "> in variable <"
+                            + variables.at(i)->getName() + "> depends on the values of the engine variables",
+                        FL_AT
+                    );
+            }
+        }
+
+        std::size_t stackSize = 0;
+        _rules.clear();
+        _activationDegrees.clear();
+        _propositions.clear();
+        _inputPropositions.assign(_inputValues.size(), std::vector<std::size_t>());
+        // propositions are equal if they have the same input variable, term and hedges
+        typedef std::pair<std::pair<std::size_t, const Term*>, std::string> PropositionKey;
+        std::map<PropositionKey, std::size_t> slots;
+        for (std::size_t b = 0; b < _engine->numberOfRuleBlocks(); ++b) {
+            const RuleBlock* ruleBlock = _engine->getRuleBlock(b);
+            if (ruleBlock->getActivation() and not dynamic_cast<const General*>(ruleBlock->getActivation()))
+                throw Exception(
+                    "[engine state error] activation <" + ruleBlock->getActivation()->className()
+                        + "> is not supported in rule block <" + ruleBlock->getName() + ">",
+                    FL_AT
+                );
+            std::vector<CompiledRule> rules(ruleBlock->numberOfRules());
+            for (std::size_t r = 0; r < ruleBlock->numberOfRules(); ++r) {
+                const Rule* rule = ruleBlock->getRule(r);
+                CompiledRule& compiled = rules.at(r);
+                compiled.rule = rule;
+                // rules not loaded are compiled without antecedent and ignored upon activation
+                if (not rule->isLoaded())
+                    continue;
+                compileAntecedent(rule->getAntecedent()->getExpression(), inputs, outputs, compiled.antecedent);
+                stackSize = std::max(stackSize, compiled.antecedent.size());
+
+                compiled.conjunctive = true;
+                for (std::size_t i = 0; i < compiled.antecedent.size(); ++i) {
+                    Instruction& instruction = compiled.antecedent.at(i);
+                    if (instruction.code != Instruction::Input) {
+                        compiled.conjunctive = compiled.conjunctive and instruction.code == Instruction::And;
+                        continue;
+                    }
+                    std::vector<std::string> hedges;
+                    for (std::size_t h = 0; h < instruction.proposition->hedges.size(); ++h)
+                        hedges.push_back(instruction.proposition->hedges.at(h)->name());
+                    const PropositionKey key(
+                        std::make_pair(instruction.index, instruction.proposition->term), Op::join(hedges, " ")
+                    );
+                    std::map<PropositionKey, std::size_t>::const_iterator slot = slots.find(key);
+                    if (slot == slots.end()) {
+                        slot = slots.insert(std::make_pair(key, _propositions.size())).first;
+                        instruction.slot = slot->second;
+                        _propositions.push_back(instruction);
+                        _inputPropositions.at(instruction.index).push_back(slot->second);
+                    }
+                    instruction.slot = slot->second;
+                }
+
+                const std::vector<Proposition*>& conclusions = rule->getConsequent()->conclusions();
+                for (std::size_t c = 0; c < conclusions.size(); ++c) {
+                    Conclusion conclusion;
+                    conclusion.output = outputs.at(conclusions.at(c)->variable);
+                    conclusion.proposition = conclusions.at(c);
+                    compiled.consequent.push_back(conclusion);
+                }
+            }
+            _rules.push_back(rules);
+            _activationDegrees.push_back(std::vector<scalar>(rules.size(), 0.0));
+        }
+        _stack.reserve(stackSize);
+
+        // index from propositions to the conjunctive rules that contain them
+        std::size_t maximumRules = 0;
+        _ruleIndex.assign(_rules.size(), std::vector<std::vector<std::size_t> >(_propositions.size()));
+        for (std::size_t b = 0; b < _rules.size(); ++b) {
+            maximumRules = std::max(maximumRules, _rules.at(b).size());
+            for (std::size_t r = 0; r < _rules.at(b).size(); ++r) {
+                const CompiledRule& compiled = _rules.at(b).at(r);
+                if (compiled.antecedent.empty() or not compiled.conjunctive)
+                    continue;
+                for (std::size_t i = 0; i < compiled.antecedent.size(); ++i) {
+                    if (compiled.antecedent.at(i).code == Instruction::Input)
+                        _ruleIndex.at(b).at(compiled.antecedent.at(i).slot).push_back(r);
+                }
+            }
+        }
+        _pruned.assign(maximumRules, false);
+        _propositionValues.assign(_propositions.size(), fl::nan);
+        _dirtyInputs.assign(_inputValues.size(), true);
+        _dirty = true;
+
+        // dependencies of the rules on the variables, used to update the state incrementally
+        _inputRules.assign(_inputValues.size(), std::vector<std::pair<std::size_t, std::size_t> >());
+        _outputRules.assign(_outputValues.size(), std::vector<std::pair<std::size_t, std::size_t> >());
+        _outputDependentRules.clear();
+        _staleRules.clear();
+        std::vector<std::size_t> conclusions(_outputValues.size(), 0);
+        for (std::size_t b = 0; b < _rules.size(); ++b) {
+            for (std::size_t r = 0; r < _rules.at(b).size(); ++r) {
+                const CompiledRule& compiled = _rules.at(b).at(r);
+                const std::pair<std::size_t, std::size_t> rule(b, r);
+                for (std::size_t i = 0; i < compiled.antecedent.size(); ++i) {
+                    const Instruction& instruction = compiled.antecedent.at(i);
+                    std::vector<std::pair<std::size_t, std::size_t> >* dependents = fl::null;
+                    if (instruction.code == Instruction::Input)
+                        dependents = &_inputRules.at(instruction.index);
+                    else if (instruction.code == Instruction::Output)
+                        dependents = &_outputDependentRules;
+                    if (dependents and (dependents->empty() or dependents->back() != rule))
+                        dependents->push_back(rule);
+                }
+                for (std::size_t c = 0; c < compiled.consequent.size(); ++c) {
+                    std::vector<std::pair<std::size_t, std::size_t> >& dependents
+                        = _outputRules.at(compiled.consequent.at(c).output);
+                    if (dependents.empty() or dependents.back() != rule)
+                        dependents.push_back(rule);
+                    ++conclusions.at(compiled.consequent.at(c).output);
+                }
+            }
+            _staleRules.push_back(std::vector<bool>(_rules.at(b).size(), false));
+        }
+        // the fuzzy outputs can hold every conclusion without allocating memory
+        for (std::size_t i = 0; i < _fuzzyOutputs.size(); ++i)
+            _fuzzyOutputs.at(i)->reserve(conclusions.at(i));
+        _changedInputs.assign(_inputValues.size(), true);
+        _dirtyOutputs.assign(_outputValues.size(), false);
+        _rawOutputValues.assign(_outputValues.size(), fl::nan);
+        _updated = false;
+
+        // the value of the fuzzy outputs that receive no activations
+        _emptyOutputValues.clear();
+        for (std::size_t i = 0; i < _engine->numberOfOutputVariables(); ++i) {
+            const OutputVariable* outputVariable = _engine->getOutputVariable(i);
+            scalar value = fl::nan;
+            if (outputVariable->getDefuzzifier()) {
+                FL_unique_ptr<Aggregated> empty(outputVariable->fuzzyOutput()->clone());
+                empty->clear();
+                value = outputVariable->getDefuzzifier()->defuzzify(
+                    empty.get(), outputVariable->getMinimum(), outputVariable->getMaximum()
+                );
+            }
+            _emptyOutputValues.push_back(value);
+        }
+    }
+
+    const Engine* EngineState::getEngine() const {
+        return this->_engine;
+    }
+
+    void EngineState::setInputValue(std::size_t index, scalar value) {
+        const InputVariable* inputVariable = _engine->getInputVariable(index);
+        if (inputVariable->isLockValueInRange())
+            value = Op::bound(value, inputVariable->getMinimum(), inputVariable->getMaximum());
+        if (not(_inputValues.at(index) == value)) {
+            _inputValues[index] = value;
+            _dirtyInputs[index] = true;
+            _changedInputs[index] = true;
+            _dirty = true;
+        }
+    }
+
+    scalar EngineState::getInputValue(std::size_t index) const {
+        return _inputValues.at(index);
+    }
+
+    scalar EngineState::getOutputValue(std::size_t index) const {
+        return _outputValues.at(index);
+    }
+
+    scalar EngineState::getPreviousOutputValue(std::size_t index) const {
+        return _previousOutputValues.at(index);
+    }
+
+    Aggregated* EngineState::fuzzyOutput(std::size_t index) const {
+        return _fuzzyOutputs.at(index);
+    }
+
+    scalar EngineState::getActivationDegree(std::size_t ruleBlock, std::size_t rule) const {
+        return _activationDegrees.at(ruleBlock).at(rule);
+    }
+
+    const std::vector<scalar>& EngineState::inputValues() const {
+        return this->_inputValues;
+    }
+
+    const std::vector<scalar>& EngineState::outputValues() const {
+        return this->_outputValues;
+    }
+
+    void EngineState::clearFuzzyOutputs() {
+        _updated = false;
+        for (std::size_t i = 0; i < _fuzzyOutputs.size(); ++i)
+            _fuzzyOutputs[i]->clear();
+    }
+
+    scalar EngineState::evaluate(const Instruction& instruction) const {
+        // mirrors Antecedent::activationDegree() for propositions
+        const Proposition* proposition = instruction.proposition;
+        if (not proposition->variable->isEnabled())
+            return 0.0;
+
+        const std::vector<Hedge*>& hedges = proposition->hedges;
+        if (not hedges.empty()) {
+            // if last hedge is "Any", apply hedges in reverse order and return degree
+            std::vector<Hedge*>::const_reverse_iterator rit = hedges.rbegin();
+            if (dynamic_cast<Any*>(*rit)) {
+                scalar result = (*rit)->hedge(fl::nan);
+                while (++rit != hedges.rend())
+                    result = (*rit)->hedge(result);
+                return result;
+            }
+        }
+
+        scalar result;
+        if (instruction.code == Instruction::Input) {
+#ifdef FL_INSTRUMENTED
+            if (Instrumentation* instrumentation = Instrumentation::current())
+                instrumentation->recordMembership(proposition->term);
+#endif
+            result = proposition->term->membership(_inputValues[instruction.index]);
+        } else
+            result = _fuzzyOutputs[instruction.index]->activationDegree(proposition->term);
+
+        for (std::vector<Hedge*>::const_reverse_iterator rit = hedges.rbegin(); rit != hedges.rend(); ++rit)
+            result = (*rit)->hedge(result);
+        return result;
+    }
+
+    void EngineState::updatePropositions() {
+        if (not _dirty)
+            return;
+        for (std::size_t i = 0; i < _dirtyInputs.size(); ++i) {
+            if (not _dirtyInputs[i])
+                continue;
+            const std::vector<std::size_t>& propositions = _inputPropositions[i];
+            for (std::size_t p = 0; p < propositions.size(); ++p)
+                _propositionValues[propositions[p]] = evaluate(_propositions[propositions[p]]);
+            _dirtyInputs[i] = false;
+        }
+        _irregularPropositions = 0;
+        for (std::size_t p = 0; p < _propositionValues.size(); ++p) {
+            if (not(_propositionValues[p] >= 0.0 and _propositionValues[p] <= 1.0))
+                ++_irregularPropositions;
+        }
+        _dirty = false;
+    }
+
+    bool EngineState::isZeroAbsorbing(const TNorm* tnorm) {
+        // exactly the built-in t-norms, since derived classes (like TNormFunction) may compute anything
+        if (not tnorm)
+            return false;
+        const std::type_info& type = typeid(*tnorm);
+        return type == typeid(AlgebraicProduct) or type == typeid(BoundedDifference)
+               or type == typeid(DrasticProduct) or type == typeid(EinsteinProduct)
+               or type == typeid(HamacherProduct) or type == typeid(Minimum)
+               or type == typeid(NilpotentMinimum);
+    }
+
+    void EngineState::activate(std::size_t ruleBlock) {
+        const RuleBlock* block = _engine->getRuleBlock(ruleBlock);
+        const TNorm* conjunction = block->getConjunction();
+        const SNorm* disjunction = block->getDisjunction();
+        const TNorm* implication = block->getImplication();
+#ifdef FL_INSTRUMENTED
+        Instrumentation::Scope scope(&_instrumentation);
+        {
+            Instrumentation::Timer timer(Instrumentation::Fuzzification);
+            updatePropositions();
+        }
+        // excludes the aggregation timed within
+        Instrumentation::Timer timer(Instrumentation::Activation);
+#else
+        updatePropositions();
+#endif
+        // propositions out of [0.0, 1.0] (e.g., nan) would yield results other than zero in the pruned rules
+        const bool pruning = isZeroAbsorbing(conjunction) and _irregularPropositions == 0;
+        if (pruning) {
+            std::fill(_pruned.begin(), _pruned.end(), false);
+            const std::vector<std::vector<std::size_t> >& index = _ruleIndex.at(ruleBlock);
+            for (std::size_t p = 0; p < index.size(); ++p) {
+                if (_propositionValues[p] != 0.0)
+                    continue;
+                for (std::size_t i = 0; i < index[p].size(); ++i)
+                    _pruned[index[p][i]] = true;
+            }
+        }
+
+        const std::vector<CompiledRule>& rules = _rules.at(ruleBlock);
+        std::vector<scalar>& activationDegrees = _activationDegrees.at(ruleBlock);
+        for (std::size_t r = 0; r < rules.size(); ++r) {
+            const CompiledRule& compiled = rules[r];
+            activationDegrees[r] = 0.0;
+            if (compiled.antecedent.empty())
+                continue;
+            if (pruning and _pruned[r]) {
+                // the rule is not triggered
+                activationDegrees[r] = compiled.rule->getWeight() * 0.0;
+                continue;
+            }
+
+            activationDegrees[r] = activationDegree(compiled, conjunction, disjunction);
+#ifdef FL_INSTRUMENTED
+            Instrumentation::Timer timer(Instrumentation::Aggregation);
+#endif
+            trigger(compiled, activationDegrees[r], implication);
+        }
+    }
+
+    scalar EngineState::activationDegree(
+        const CompiledRule& compiled,
+        const TNorm* conjunction,
+        const SNorm* disjunction
+    ) {
+        _stack.clear();
+        for (std::size_t i = 0; i < compiled.antecedent.size(); ++i) {
+            const Instruction& instruction = compiled.antecedent[i];
+            if (instruction.code == Instruction::Input) {
+                _stack.push_back(_propositionValues[instruction.slot]);
+                continue;
+            }
+            if (instruction.code == Instruction::Output) {
+                _stack.push_back(evaluate(instruction));
+                continue;
+            }
+            const scalar right = _stack.back();
+            _stack.pop_back();
+            const scalar left = _stack.back();
+            if (instruction.code == Instruction::And) {
+                if (not conjunction)
+                    throw Exception(
+                        "[conjunction error] the following rule requires a conjunction operator:\n"
+                            + compiled.rule->getText(),
+                        FL_AT
+                    );
+                _stack.back() = conjunction->compute(left, right);
+            } else {
+                if (not disjunction)
+                    throw Exception(
+                        "[disjunction error] the following rule requires a disjunction operator:\n"
+                            + compiled.rule->getText(),
+                        FL_AT
+                    );
+                _stack.back() = disjunction->compute(left, right);
+            }
+        }
+
+        // mirrors Rule::activateWith()
+        return compiled.rule->getWeight() * _stack.back();
+    }
+
+    void EngineState::trigger(const CompiledRule& compiled, scalar activationDegree, const TNorm* implication) {
+        // mirrors Rule::trigger()
+        if (not(compiled.rule->isEnabled() and Op::isGt(activationDegree, 0.0)))
+            return;
+        for (std::size_t c = 0; c < compiled.consequent.size(); ++c) {
+            const Conclusion& conclusion = compiled.consequent[c];
+            const Proposition* proposition = conclusion.proposition;
+            if (not proposition->variable->isEnabled())
+                continue;
+            for (std::vector<Hedge*>::const_reverse_iterator rit = proposition->hedges.rbegin();
+                 rit != proposition->hedges.rend();
+                 ++rit) {
+                activationDegree = (*rit)->hedge(activationDegree);
+            }
+            _fuzzyOutputs[conclusion.output]->addTerm(proposition->term, activationDegree, implication);
+        }
+    }
+
+    void EngineState::defuzzify(std::size_t index) {
+        if (not _engine->getOutputVariable(index)->isEnabled())
+            return;
+#ifdef FL_INSTRUMENTED
+        Instrumentation::Scope scope(&_instrumentation);
+        const scalar start = Instrumentation::now();
+        const scalar value = defuzzified(index);
+        _instrumentation.recordDefuzzification(index, Instrumentation::now() - start);
+#else
+        const scalar value = defuzzified(index);
+#endif
+        _previousOutputValues[index] = _outputValues[index];
+        _outputValues[index] = value;
+    }
+
+    scalar EngineState::defuzzified(std::size_t index) const {
+        if (not _engine->getOutputVariable(index)->isEnabled())
+            return _outputValues[index];
+        return finalValue(index, rawValue(index));
+    }
+
+    scalar EngineState::rawValue(std::size_t index) const {
+        const OutputVariable* outputVariable = _engine->getOutputVariable(index);
+        if (not outputVariable->getDefuzzifier())
+            throw Exception(
+                "[defuzzify error] expected a defuzzifier in variable '" + outputVariable->getName()
+                    + "', but got null",
+                FL_AT
+            );
+        if (_fuzzyOutputs[index]->isEmpty())
+            return _emptyOutputValues[index];
+        return outputVariable->getDefuzzifier()->defuzzify(
+            _fuzzyOutputs[index], outputVariable->getMinimum(), outputVariable->getMaximum()
+        );
+    }
+
+    scalar EngineState::finalValue(std::size_t index, scalar value) const {
+        // mirrors OutputVariable::defuzzify()
+        const OutputVariable* outputVariable = _engine->getOutputVariable(index);
+        if (outputVariable->isLockPreviousValue() and Op::isNaN(value))
+            value = _previousOutputValues[index];
+
+        if (Op::isNaN(value))
+            value = outputVariable->getDefaultValue();
+
+        return outputVariable->isLockValueInRange()
+                   ? Op::bound(value, outputVariable->getMinimum(), outputVariable->getMaximum())
+                   : value;
+    }
+
+    void EngineState::aggregate(std::size_t output) {
+        // mirrors the order in which Engine::process(EngineState&) triggers the rules
+        _fuzzyOutputs[output]->clear();
+        const std::vector<std::pair<std::size_t, std::size_t> >& dependents = _outputRules[output];
+        for (std::size_t i = 0; i < dependents.size(); ++i) {
+            const RuleBlock* block = _engine->getRuleBlock(dependents[i].first);
+            const CompiledRule& compiled = _rules[dependents[i].first][dependents[i].second];
+            scalar activationDegree = _activationDegrees[dependents[i].first][dependents[i].second];
+            if (not(block->isEnabled() and compiled.rule->isEnabled() and Op::isGt(activationDegree, 0.0)))
+                continue;
+            for (std::size_t c = 0; c < compiled.consequent.size(); ++c) {
+                const Conclusion& conclusion = compiled.consequent[c];
+                const Proposition* proposition = conclusion.proposition;
+                if (not proposition->variable->isEnabled())
+                    continue;
+                // the hedges of a conclusion also apply to the conclusions that follow
+                for (std::vector<Hedge*>::const_reverse_iterator rit = proposition->hedges.rbegin();
+                     rit != proposition->hedges.rend();
+                     ++rit) {
+                    activationDegree = (*rit)->hedge(activationDegree);
+                }
+                if (conclusion.output == output)
+                    _fuzzyOutputs[output]->addTerm(proposition->term, activationDegree, block->getImplication());
+            }
+        }
+    }
+
+    void EngineState::update() {
+#ifdef FL_INSTRUMENTED
+        Instrumentation::Scope scope(&_instrumentation);
+#endif
+        // the rules on output variables depend on the fuzzy outputs aggregated by the preceding rules
+        if (not(_updated and _outputDependentRules.empty())) {
+            clearFuzzyOutputs();
+            for (std::size_t b = 0; b < _rules.size(); ++b) {
+                if (_engine->getRuleBlock(b)->isEnabled())
+                    activate(b);
+            }
+            for (std::size_t o = 0; o < _outputValues.size(); ++o) {
+                if (_engine->getOutputVariable(o)->isEnabled())
+                    updateRawValue(o);
+            }
+            std::fill(_changedInputs.begin(), _changedInputs.end(), false);
+            std::fill(_dirtyOutputs.begin(), _dirtyOutputs.end(), false);
+            _updated = true;
+        } else {
+#ifdef FL_INSTRUMENTED
+            {
+                Instrumentation::Timer timer(Instrumentation::Fuzzification);
+                updatePropositions();
+            }
+            Instrumentation::Timer timer(Instrumentation::Activation);
+#else
+            updatePropositions();
+#endif
+            for (std::size_t i = 0; i < _changedInputs.size(); ++i) {
+                if (not _changedInputs[i])
+                    continue;
+                for (std::size_t r = 0; r < _inputRules[i].size(); ++r)
+                    _staleRules[_inputRules[i][r].first][_inputRules[i][r].second] = true;
+                _changedInputs[i] = false;
+            }
+
+            for (std::size_t b = 0; b < _rules.size(); ++b) {
+                const RuleBlock* block = _engine->getRuleBlock(b);
+                std::vector<bool>& stale = _staleRules[b];
+                for (std::size_t r = 0; r < stale.size(); ++r) {
+                    if (not stale[r])
+                        continue;
+                    stale[r] = false;
+                    if (not block->isEnabled())
+                        continue;
+                    const CompiledRule& compiled = _rules[b][r];
+                    const scalar degree = activationDegree(compiled, block->getConjunction(), block->getDisjunction());
+                    if (degree == _activationDegrees[b][r])
+                        continue;
+                    _activationDegrees[b][r] = degree;
+                    for (std::size_t c = 0; c < compiled.consequent.size(); ++c)
+                        _dirtyOutputs[compiled.consequent[c].output] = true;
+                }
+            }
+
+            for (std::size_t o = 0; o < _outputValues.size(); ++o) {
+                if (not _dirtyOutputs[o])
+                    continue;
+                {
+#ifdef FL_INSTRUMENTED
+                    Instrumentation::Timer timer(Instrumentation::Aggregation);
+#endif
+                    aggregate(o);
+                }
+                if (_engine->getOutputVariable(o)->isEnabled())
+                    updateRawValue(o);
+                _dirtyOutputs[o] = false;
+            }
+        }
+
+        for (std::size_t o = 0; o < _outputValues.size(); ++o) {
+            if (not _engine->getOutputVariable(o)->isEnabled())
+                continue;
+            const scalar value = finalValue(o, _rawOutputValues[o]);
+            _previousOutputValues[o] = _outputValues[o];
+            _outputValues[o] = value;
+        }
+#ifdef FL_INSTRUMENTED
+        _instrumentation.recordProcess(this);
+#endif
+    }
+
+    void EngineState::updateRawValue(std::size_t index) {
+#ifdef FL_INSTRUMENTED
+        const scalar start = Instrumentation::now();
+        _rawOutputValues[index] = rawValue(index);
+        _instrumentation.recordDefuzzification(index, Instrumentation::now() - start);
+#else
+        _rawOutputValues[index] = rawValue(index);
+#endif
+    }
+
+    void EngineState::restart() {
+        for (std::size_t i = 0; i < _inputValues.size(); ++i) {
+            _inputValues[i] = fl::nan;
+            _dirtyInputs[i] = true;
+            _changedInputs[i] = true;
+        }
+        _dirty = true;
+        _updated = false;
+        for (std::size_t i = 0; i < _outputValues.size(); ++i) {
+            _fuzzyOutputs[i]->clear();
+            _outputValues[i] = fl::nan;
+            _previousOutputValues[i] = fl::nan;
+        }
+        for (std::size_t b = 0; b < _activationDegrees.size(); ++b)
+            std::fill(_activationDegrees[b].begin(), _activationDegrees[b].end(), 0.0);
+    }
+
+    const Instrumentation& EngineState::instrumentation() const {
+        return _instrumentation;
+    }
+
+    Instrumentation& EngineState::instrumentation() {
+        return _instrumentation;
+    }
+
+}
@@ -0,0 +1,336 @@
+/*
+fuzzylite (R), a fuzzy logic control library in C++.
+
+Copyright (C) 2010-2024 FuzzyLite Limited. All rights reserved.
+Author: Juan Rada-Vilela, PhD <jcrada@fuzzylite.com>.
+
+This file is part of fuzzylite.
+
+fuzzylite is free software: you can redistribute it and/or modify it under
+the terms of the FuzzyLite License included with the software.
+
+You should have received a copy of the FuzzyLite License along with
+fuzzylite. If not, see <https://github.com/fuzzylite/fuzzylite/>.
+
+fuzzylite is a registered trademark of FuzzyLite Limited.
+*/
+
+#include "fuzzylite/Instrumentation.h"
+
+#include "fuzzylite/Engine.h"
+#include "fuzzylite/EngineState.h"
+#include "fuzzylite/rule/Rule.h"
+#include "fuzzylite/rule/RuleBlock.h"
+#include "fuzzylite/term/Term.h"
+#include "fuzzylite/variable/OutputVariable.h"
+
+#ifdef FL_CPP98
+// timing is only available in C++11
+#else
+#include <chrono>
+#endif
+
+namespace fuzzylite {
+
+    namespace {
+        Instrumentation*& currentInstrumentation() {
+#ifdef FL_CPP98
+            static Instrumentation* instrumentation = fl::null;
+#else
+            static thread_local Instrumentation* instrumentation = fl::null;
+#endif
+            return instrumentation;
+        }
+    }
+
+    Instrumentation::Timer::Timer(Stage stage) :
+        _instrumentation(Instrumentation::current()),
+        _stage(stage),
+        _start(0.0),
+        _recorded(0.0) {
+        if (_instrumentation) {
+            _recorded = _instrumentation->totalTime();
+            _start = Instrumentation::now();
+        }
+    }
+
+    Instrumentation::Timer::~Timer() {
+        if (_instrumentation) {
+            const scalar elapsed = Instrumentation::now() - _start;
+            // the time recorded in other stages meanwhile is not part of this stage
+            const scalar nested = _instrumentation->totalTime() - _recorded;
+            _instrumentation->recordStage(_stage, elapsed - nested);
+        }
+    }
+
+    Instrumentation::Scope::Scope(Instrumentation* instrumentation) : _previous(currentInstrumentation()) {
+        currentInstrumentation() = instrumentation;
+    }
+
+    Instrumentation::Scope::~Scope() {
+        currentInstrumentation() = _previous;
+    }
+
+    Instrumentation::Instrumentation(const Engine* engine) : _engine(fl::null), _processes(0), _stageTimes(4, 0.0) {
+        if (engine)
+            reset(engine);
+    }
+
+    Instrumentation::~Instrumentation() {}
+
+    bool Instrumentation::isEnabled() {
+#ifdef FL_INSTRUMENTED
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    Instrumentation* Instrumentation::current() {
+        return currentInstrumentation();
+    }
+
+    scalar Instrumentation::now() {
+#ifdef FL_CPP98
+        return 0.0;
+#else
+        static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+        return std::chrono::duration<scalar, std::nano>(std::chrono::steady_clock::now() - epoch).count();
+#endif
+    }
+
+    void Instrumentation::reset(const Engine* engine) {
+        _engine = engine;
+        _activations.clear();
+        _firings.clear();
+        _activationDegrees.clear();
+        _defuzzifications.clear();
+        _defuzzificationTimes.clear();
+        _memberships.clear();
+        _terms.clear();
+        if (engine) {
+            for (std::size_t b = 0; b < engine->numberOfRuleBlocks(); ++b) {
+                const std::size_t rules = engine->getRuleBlock(b)->numberOfRules();
+                _activations.push_back(std::vector<unsigned long>(rules, 0));
+                _firings.push_back(std::vector<unsigned long>(rules, 0));
+                _activationDegrees.push_back(std::vector<scalar>(rules, 0.0));
+            }
+            _defuzzifications.resize(engine->numberOfOutputVariables(), 0);
+            _defuzzificationTimes.resize(engine->numberOfOutputVariables(), 0.0);
+            const std::vector<Variable*> variables = engine->variables();
+            for (std::size_t v = 0; v < variables.size(); ++v) {
+                _memberships.push_back(std::vector<unsigned long>(variables.at(v)->numberOfTerms(), 0));
+                for (std::size_t t = 0; t < variables.at(v)->numberOfTerms(); ++t)
+                    _terms[variables.at(v)->getTerm(t)] = std::make_pair(v, t);
+            }
+        }
+        clear();
+    }
+
+    void Instrumentation::clear() {
+        _processes = 0;
+        for (std::size_t b = 0; b < _activations.size(); ++b) {
+            std::fill(_activations.at(b).begin(), _activations.at(b).end(), 0);
+            std::fill(_firings.at(b).begin(), _firings.at(b).end(), 0);
+            std::fill(_activationDegrees.at(b).begin(), _activationDegrees.at(b).end(), 0.0);
+        }
+        std::fill(_defuzzifications.begin(), _defuzzifications.end(), 0);
+        std::fill(_defuzzificationTimes.begin(), _defuzzificationTimes.end(), 0.0);
+        for (std::size_t v = 0; v < _memberships.size(); ++v)
+            std::fill(_memberships.at(v).begin(), _memberships.at(v).end(), 0);
+        std::fill(_stageTimes.begin(), _stageTimes.end(), 0.0);
+    }
+
+    bool Instrumentation::isBoundTo(const Engine* engine) const {
+        if (not engine or _engine != engine)
+            return false;
+        if (_activations.size() != engine->numberOfRuleBlocks()
+            or _defuzzifications.size() != engine->numberOfOutputVariables()
+            or _memberships.size() != engine->numberOfInputVariables() + engine->numberOfOutputVariables())
+            return false;
+        for (std::size_t b = 0; b < _activations.size(); ++b) {
+            if (_activations.at(b).size() != engine->getRuleBlock(b)->numberOfRules())
+                return false;
+        }
+        return true;
+    }
+
+    const Engine* Instrumentation::getEngine() const {
+        return _engine;
+    }
+
+    void Instrumentation::merge(const Instrumentation& other) {
+        if (not _engine) {
+            *this = other;
+            return;
+        }
+        if (not other._engine)
+            return;
+        bool sameStructure = _activations.size() == other._activations.size()
+                             and _defuzzifications.size() == other._defuzzifications.size()
+                             and _memberships.size() == other._memberships.size();
+        for (std::size_t b = 0; sameStructure and b < _activations.size(); ++b)
+            sameStructure = _activations.at(b).size() == other._activations.at(b).size();
+        for (std::size_t v = 0; sameStructure and v < _memberships.size(); ++v)
+            sameStructure = _memberships.at(v).size() == other._memberships.at(v).size();
+        if (not sameStructure)
+            throw Exception(
+                "[instrumentation error] cannot merge the instrumentation of engines with different structures", FL_AT
+            );
+
+        _processes += other._processes;
+        for (std::size_t b = 0; b < _activations.size(); ++b) {
+            for (std::size_t r = 0; r < _activations.at(b).size(); ++r) {
+                _activations.at(b).at(r) += other._activations.at(b).at(r);
+                _firings.at(b).at(r) += other._firings.at(b).at(r);
+                _activationDegrees.at(b).at(r) += other._activationDegrees.at(b).at(r);
+            }
+        }
+        for (std::size_t o = 0; o < _defuzzifications.size(); ++o) {
+            _defuzzifications.at(o) += other._defuzzifications.at(o);
+            _defuzzificationTimes.at(o) += other._defuzzificationTimes.at(o);
+        }
+        for (std::size_t v = 0; v < _memberships.size(); ++v) {
+            for (std::size_t t = 0; t < _memberships.at(v).size(); ++t)
+                _memberships.at(v).at(t) += other._memberships.at(v).at(t);
+        }
+        for (std::size_t s = 0; s < _stageTimes.size(); ++s)
+            _stageTimes.at(s) += other._stageTimes.at(s);
+    }
+
+    void Instrumentation::recordProcess(const EngineState* state) {
+        ++_processes;
+        for (std::size_t b = 0; b < _activations.size(); ++b) {
+            const RuleBlock* ruleBlock = _engine->getRuleBlock(b);
+            if (not ruleBlock->isEnabled())
+                continue;
+            for (std::size_t r = 0; r < _activations[b].size(); ++r) {
+                const Rule* rule = ruleBlock->getRule(r);
+                if (not(rule->isEnabled() and rule->isLoaded()))
+                    continue;
+                const scalar activationDegree = state ? state->getActivationDegree(b, r) : rule->getActivationDegree();
+                ++_activations[b][r];
+                if (Op::isGt(activationDegree, 0.0))
+                    ++_firings[b][r];
+                if (not Op::isNaN(activationDegree))
+                    _activationDegrees[b][r] += activationDegree;
+            }
+        }
+    }
+
+    void Instrumentation::recordStage(Stage stage, scalar nanoseconds) {
+        _stageTimes[stage] += nanoseconds;
+    }
+
+    void Instrumentation::recordDefuzzification(std::size_t output, scalar nanoseconds) {
+        ++_defuzzifications.at(output);
+        _defuzzificationTimes.at(output) += nanoseconds;
+        _stageTimes[Defuzzification] += nanoseconds;
+    }
+
+    void Instrumentation::recordMembership(const Term* term) {
+        std::map<const Term*, std::pair<std::size_t, std::size_t> >::const_iterator it = _terms.find(term);
+        if (it != _terms.end())
+            ++_memberships[it->second.first][it->second.second];
+    }
+
+    unsigned long Instrumentation::processes() const {
+        return _processes;
+    }
+
+    unsigned long Instrumentation::activations(std::size_t ruleBlock, std::size_t rule) const {
+        return _activations.at(ruleBlock).at(rule);
+    }
+
+    unsigned long Instrumentation::firings(std::size_t ruleBlock, std::size_t rule) const {
+        return _firings.at(ruleBlock).at(rule);
+    }
+
+    scalar Instrumentation::meanActivationDegree(std::size_t ruleBlock, std::size_t rule) const {
+        const unsigned long activations = _activations.at(ruleBlock).at(rule);
+        if (activations == 0)
+            return fl::nan;
+        return _activationDegrees.at(ruleBlock).at(rule) / activations;
+    }
+
+    unsigned long Instrumentation::defuzzifications(std::size_t output) const {
+        return _defuzzifications.at(output);
+    }
+
+    scalar Instrumentation::defuzzificationTime(std::size_t output) const {
+        return _defuzzificationTimes.at(output);
+    }
+
+    unsigned long Instrumentation::memberships(std::size_t variable, std::size_t term) const {
+        return _memberships.at(variable).at(term);
+    }
+
+    scalar Instrumentation::stageTime(Stage stage) const {
+        return _stageTimes.at(stage);
+    }
+
+    scalar Instrumentation::stageFraction(Stage stage) const {
+        const scalar total = totalTime();
+        if (not Op::isGt(total, 0.0))
+            return fl::nan;
+        return stageTime(stage) / total;
+    }
+
+    scalar Instrumentation::totalTime() const {
+        return _stageTimes[Fuzzification] + _stageTimes[Activation] + _stageTimes[Aggregation]
+               + _stageTimes[Defuzzification];
+    }
+
+    std::vector<std::string> Instrumentation::rulesNeverFired() const {
+        std::vector<std::string> result;
+        for (std::size_t b = 0; b < _firings.size(); ++b) {
+            const RuleBlock* ruleBlock = _engine->getRuleBlock(b);
+            for (std::size_t r = 0; r < _firings.at(b).size(); ++r) {
+                if (_firings.at(b).at(r) == 0)
+                    result.push_back(ruleBlock->getName() + ": " + ruleBlock->getRule(r)->getText());
+            }
+        }
+        return result;
+    }
+
+    std::string Instrumentation::toString() const {
+        std::ostringstream ss;
+        ss << "processes: " << _processes << "\n";
+        if (not _engine)
+            return ss.str();
+
+        const std::string stages[] = {"fuzzification", "activation", "aggregation", "defuzzification"};
+        ss << "stages:";
+        for (int s = Fuzzification; s <= Defuzzification; ++s) {
+            ss << " " << stages[s] << "=" << Op::str(stageTime(Stage(s))) << "ns ("
+               << Op::str(100.0 * stageFraction(Stage(s))) << "%)";
+        }
+        ss << "\n";
+
+        for (std::size_t b = 0; b < _activations.size(); ++b) {
+            const RuleBlock* ruleBlock = _engine->getRuleBlock(b);
+            ss << "rule block " << ruleBlock->getName() << ":\n";
+            for (std::size_t r = 0; r < _activations.at(b).size(); ++r) {
+                ss << "  fired " << firings(b, r) << "/" << activations(b, r) << " mean "
+                   << Op::str(meanActivationDegree(b, r)) << ": " << ruleBlock->getRule(r)->getText() << "\n";
+            }
+        }
+
+        for (std::size_t o = 0; o < _defuzzifications.size(); ++o) {
+            ss << "output " << _engine->getOutputVariable(o)->getName() << ": defuzzified " << defuzzifications(o)
+               << " times in " << Op::str(defuzzificationTime(o)) << "ns\n";
+        }
+
+        const std::vector<Variable*> variables = _engine->variables();
+        for (std::size_t v = 0; v < _memberships.size(); ++v) {
+            for (std::size_t t = 0; t < _memberships.at(v).size(); ++t) {
+                ss << "term " << variables.at(v)->getName() << "." << variables.at(v)->getTerm(t)->getName() << ": "
+                   << memberships(v, t) << " memberships\n";
+            }
+        }
+
+        ss << "rules never fired: " << rulesNeverFired().size() << "\n";
+        return ss.str();
+    }
+
+}
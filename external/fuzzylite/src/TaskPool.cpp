@@ -0,0 +1,210 @@
+/*
+fuzzylite (R), a fuzzy logic control library in C++.
+
+Copyright (C) 2010-2024 FuzzyLite Limited. All rights reserved.
+Author: Juan Rada-Vilela, PhD <jcrada@fuzzylite.com>.
+
+This file is part of fuzzylite.
+
+fuzzylite is free software: you can redistribute it and/or modify it under
+the terms of the FuzzyLite License included with the software.
+
+You should have received a copy of the FuzzyLite License along with
+fuzzylite. If not, see <https://github.com/fuzzylite/fuzzylite/>.
+
+fuzzylite is a registered trademark of FuzzyLite Limited.
+*/
+
+#include "fuzzylite/TaskPool.h"
+
+#ifndef FL_CPP98
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+#endif
+
+namespace fuzzylite {
+
+    TaskPool::Job::Job() {}
+
+    TaskPool::Job::~Job() {}
+
+#ifdef FL_CPP98
+    class TaskPool::Implementation {};
+
+    TaskPool::TaskPool(int) : _implementation(fl::null) {}
+
+    TaskPool::~TaskPool() {}
+
+    int TaskPool::getThreads() const {
+        return 0;
+    }
+
+    void TaskPool::run(Job& job, std::size_t tasks) {
+        for (std::size_t i = 0; i < tasks; ++i)
+            job.run(i);
+    }
+#else
+    class TaskPool::Implementation {
+      public:
+        /** The tasks of the current job not yet taken by a thread, from begin to end */
+        struct Range {
+            std::mutex mutex;
+            std::size_t begin;
+            std::size_t end;
+
+            Range() : begin(0), end(0) {}
+        };
+
+        std::atomic<bool> busy;
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable done;
+        Job* job;
+        std::size_t generation;
+        std::size_t running;
+        bool stopping;
+        std::exception_ptr error;
+        // one range per thread of the pool, and the last one for the thread submitting the job
+        std::vector<Range> ranges;
+        std::vector<std::thread> threads;
+
+        explicit Implementation(std::size_t threadCount) :
+            busy(false),
+            job(fl::null),
+            generation(0),
+            running(0),
+            stopping(false),
+            ranges(threadCount + 1) {
+            for (std::size_t i = 0; i < threadCount; ++i)
+                threads.push_back(std::thread(&Implementation::work, this, i));
+        }
+
+        ~Implementation() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            wake.notify_all();
+            for (std::size_t i = 0; i < threads.size(); ++i)
+                threads.at(i).join();
+        }
+
+        void work(std::size_t self) {
+            std::size_t seen = 0;
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true) {
+                wake.wait(lock, [&]() { return stopping or generation != seen; });
+                if (stopping)
+                    return;
+                seen = generation;
+                Job* current = job;
+                lock.unlock();
+                runTasks(*current, self);
+                lock.lock();
+                if (--running == 0)
+                    done.notify_one();
+            }
+        }
+
+        void runTasks(Job& current, std::size_t self) {
+            std::size_t index = 0;
+            while (take(self, index) or steal(self, index)) {
+                try {
+                    current.run(index);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (not error)
+                        error = std::current_exception();
+                }
+            }
+        }
+
+        bool take(std::size_t self, std::size_t& index) {
+            Range& range = ranges.at(self);
+            std::lock_guard<std::mutex> lock(range.mutex);
+            if (range.begin == range.end)
+                return false;
+            index = range.begin++;
+            return true;
+        }
+
+        // takes the second half of the tasks left to another thread (or its only task left), and runs the first one
+        bool steal(std::size_t self, std::size_t& index) {
+            for (std::size_t offset = 1; offset < ranges.size(); ++offset) {
+                Range& victim = ranges.at((self + offset) % ranges.size());
+                std::size_t begin = 0, end = 0;
+                {
+                    std::lock_guard<std::mutex> lock(victim.mutex);
+                    if (victim.begin == victim.end)
+                        continue;
+                    begin = victim.begin + (victim.end - victim.begin) / 2;
+                    end = victim.end;
+                    victim.end = begin;
+                }
+                index = begin;
+                Range& range = ranges.at(self);
+                std::lock_guard<std::mutex> lock(range.mutex);
+                range.begin = begin + 1;
+                range.end = end;
+                return true;
+            }
+            return false;
+        }
+    };
+
+    TaskPool::TaskPool(int threads) : _implementation(fl::null) {
+        if (threads < 0)
+            threads = int(std::max(1u, std::thread::hardware_concurrency())) - 1;
+        _implementation = new Implementation(std::size_t(threads));
+    }
+
+    TaskPool::~TaskPool() {
+        delete _implementation;
+    }
+
+    int TaskPool::getThreads() const {
+        return int(_implementation->threads.size());
+    }
+
+    void TaskPool::run(Job& job, std::size_t tasks) {
+        Implementation& pool = *_implementation;
+        if (tasks <= 1 or pool.threads.empty() or pool.busy.exchange(true)) {
+            for (std::size_t i = 0; i < tasks; ++i)
+                job.run(i);
+            return;
+        }
+
+        const std::size_t threads = pool.ranges.size();
+        for (std::size_t i = 0; i < threads; ++i) {
+            std::lock_guard<std::mutex> lock(pool.ranges.at(i).mutex);
+            pool.ranges.at(i).begin = tasks * i / threads;
+            pool.ranges.at(i).end = tasks * (i + 1) / threads;
+        }
+        {
+            std::lock_guard<std::mutex> lock(pool.mutex);
+            pool.job = &job;
+            pool.running = pool.threads.size();
+            ++pool.generation;
+        }
+        pool.wake.notify_all();
+
+        pool.runTasks(job, threads - 1);
+
+        std::exception_ptr error;
+        {
+            std::unique_lock<std::mutex> lock(pool.mutex);
+            pool.done.wait(lock, [&]() { return pool.running == 0; });
+            pool.job = fl::null;
+            std::swap(error, pool.error);
+        }
+        pool.busy = false;
+        if (error)
+            std::rethrow_exception(error);
+    }
+#endif
+}
@@ -17,7 +17,17 @@ fuzzylite is a registered trademark of FuzzyLite Limited.
 
 #include "fuzzylite/defuzzifier/Centroid.h"
 
+#include <algorithm>
+
+#include "fuzzylite/norm/s/Maximum.h"
+#include "fuzzylite/norm/t/AlgebraicProduct.h"
+#include "fuzzylite/norm/t/Minimum.h"
+#include "fuzzylite/term/Aggregated.h"
+#include "fuzzylite/term/Ramp.h"
+#include "fuzzylite/term/Rectangle.h"
 #include "fuzzylite/term/Term.h"
+#include "fuzzylite/term/Trapezoid.h"
+#include "fuzzylite/term/Triangle.h"
 
 namespace fuzzylite {
 
@@ -33,6 +43,9 @@ namespace fuzzylite {
         if (not Op::isFinite(minimum + maximum))
             return fl::nan;
 
+        if (isPiecewiseLinear(term))
+            return piecewiseLinear(static_cast<const Aggregated*>(term), minimum, maximum);
+
         const int resolution = getResolution();
         const scalar dx = (maximum - minimum) / resolution;
         scalar area = 0.0, centroid = 0.0;
@@ -47,6 +60,153 @@ namespace fuzzylite {
         return centroid;
     }
 
+    std::size_t Centroid::vertices(const Term* term, scalar* result) {
+        std::size_t size = 0;
+        if (const Triangle* triangle = dynamic_cast<const Triangle*>(term)) {
+            result[size++] = triangle->getVertexA();
+            result[size++] = triangle->getVertexB();
+            result[size++] = triangle->getVertexC();
+        } else if (const Ramp* ramp = dynamic_cast<const Ramp*>(term)) {
+            if (Op::isEq(ramp->getStart(), ramp->getEnd()))
+                return 0;
+            result[size++] = ramp->getStart();
+            result[size++] = ramp->getEnd();
+        } else if (const Trapezoid* trapezoid = dynamic_cast<const Trapezoid*>(term)) {
+            result[size++] = trapezoid->getVertexA();
+            result[size++] = trapezoid->getVertexB();
+            result[size++] = trapezoid->getVertexC();
+            result[size++] = trapezoid->getVertexD();
+        } else if (const Rectangle* rectangle = dynamic_cast<const Rectangle*>(term)) {
+            result[size++] = rectangle->getStart();
+            result[size++] = rectangle->getEnd();
+        } else {
+            return 0;
+        }
+        for (std::size_t i = 0; i < size; ++i) {
+            if (not Op::isFinite(result[i]))
+                return 0;
+        }
+        return Op::isFinite(term->getHeight()) ? size : 0;
+    }
+
+    bool Centroid::isPiecewiseLinear(const Term* term) {
+        const Aggregated* aggregated = dynamic_cast<const Aggregated*>(term);
+        if (not aggregated or not dynamic_cast<const Maximum*>(aggregated->getAggregation()))
+            return false;
+        scalar ignore[4];
+        for (std::size_t i = 0; i < aggregated->numberOfTerms(); ++i) {
+            const Activated& activated = aggregated->getTerm(i);
+            const TNorm* implication = activated.getImplication();
+            if (not(dynamic_cast<const Minimum*>(implication) or dynamic_cast<const AlgebraicProduct*>(implication)))
+                return false;
+            if (not Op::isFinite(activated.getDegree()) or vertices(activated.getTerm(), ignore) == 0)
+                return false;
+        }
+        return true;
+    }
+
+    bool Centroid::isPiecewiseLinearTerm(const Term* term) {
+        scalar ignore[4];
+        return vertices(term, ignore) > 0;
+    }
+
+    scalar Centroid::piecewiseLinear(const Aggregated* term, scalar minimum, scalar maximum) const {
+        const std::size_t numberOfTerms = term->numberOfTerms();
+
+        // the buffers of the workspace keep their memory between calls
+        std::vector<scalar>& breakpoints = term->workspace(0);
+        std::vector<scalar>& slopes = term->workspace(1);
+        std::vector<scalar>& intercepts = term->workspace(2);
+        std::vector<scalar>& points = term->workspace(3);
+
+        // the vertices of the terms within the range are the initial breakpoints of the polygon
+        breakpoints.clear();
+        breakpoints.push_back(minimum);
+        for (std::size_t i = 0; i < numberOfTerms; ++i) {
+            scalar polygon[4];
+            const std::size_t numberOfPoints = vertices(term->getTerm(i).getTerm(), polygon);
+            for (std::size_t p = 0; p < numberOfPoints; ++p) {
+                if (polygon[p] > minimum and polygon[p] < maximum)
+                    breakpoints.push_back(polygon[p]);
+            }
+        }
+        breakpoints.push_back(maximum);
+        std::sort(breakpoints.begin(), breakpoints.end());
+        breakpoints.erase(std::unique(breakpoints.begin(), breakpoints.end()), breakpoints.end());
+
+        // the Minimum implication clips the terms where they cross their activation degrees
+        const std::size_t numberOfVertices = breakpoints.size();
+        for (std::size_t v = 0; v + 1 < numberOfVertices; ++v) {
+            const scalar a = breakpoints.at(v), b = breakpoints.at(v + 1);
+            const scalar x1 = a + (b - a) / 3.0, x2 = a + 2.0 * (b - a) / 3.0;
+            for (std::size_t i = 0; i < numberOfTerms; ++i) {
+                const Activated& activated = term->getTerm(i);
+                if (not dynamic_cast<const Minimum*>(activated.getImplication()))
+                    continue;
+                const scalar y1 = activated.getTerm()->membership(x1);
+                const scalar y2 = activated.getTerm()->membership(x2);
+                if (y1 == y2)
+                    continue;
+                const scalar x = x1 + (activated.getDegree() - y1) * (x2 - x1) / (y2 - y1);
+                if (x > a and x < b)
+                    breakpoints.push_back(x);
+            }
+        }
+        std::sort(breakpoints.begin(), breakpoints.end());
+        breakpoints.erase(std::unique(breakpoints.begin(), breakpoints.end()), breakpoints.end());
+
+        // within each interval, every activated term is a line and the aggregation is their upper envelope
+        slopes.resize(numberOfTerms);
+        intercepts.resize(numberOfTerms);
+        scalar area = 0.0, centroid = 0.0;
+        for (std::size_t v = 0; v + 1 < breakpoints.size(); ++v) {
+            const scalar a = breakpoints.at(v), b = breakpoints.at(v + 1);
+            const scalar x1 = a + (b - a) / 3.0, x2 = a + 2.0 * (b - a) / 3.0;
+            for (std::size_t i = 0; i < numberOfTerms; ++i) {
+                const Activated& activated = term->getTerm(i);
+                const scalar y1 = activated.membership(x1);
+                const scalar y2 = activated.membership(x2);
+                slopes.at(i) = (y2 - y1) / (x2 - x1);
+                intercepts.at(i) = y1 - slopes.at(i) * x1;
+            }
+
+            points.clear();
+            points.push_back(a);
+            points.push_back(b);
+            for (std::size_t i = 0; i < numberOfTerms; ++i) {
+                for (std::size_t j = i + 1; j < numberOfTerms; ++j) {
+                    if (slopes.at(i) == slopes.at(j))
+                        continue;
+                    const scalar x = (intercepts.at(j) - intercepts.at(i)) / (slopes.at(i) - slopes.at(j));
+                    if (x > a and x < b)
+                        points.push_back(x);
+                }
+            }
+            std::sort(points.begin(), points.end());
+
+            for (std::size_t p = 0; p + 1 < points.size(); ++p) {
+                const scalar left = points.at(p), right = points.at(p + 1);
+                if (not(right > left))
+                    continue;
+                const scalar middle = 0.5 * (left + right);
+                scalar slope = 0.0, intercept = 0.0;
+                for (std::size_t i = 0; i < numberOfTerms; ++i) {
+                    if (slopes.at(i) * middle + intercepts.at(i) > slope * middle + intercept) {
+                        slope = slopes.at(i);
+                        intercept = intercepts.at(i);
+                    }
+                }
+                const scalar yLeft = slope * left + intercept;
+                const scalar yRight = slope * right + intercept;
+                const scalar dx = right - left;
+                area += dx * (yLeft + yRight) / 2.0;
+                centroid += dx * (yLeft * (2.0 * left + right) + yRight * (left + 2.0 * right)) / 6.0;
+            }
+        }
+        centroid /= area;
+        return centroid;
+    }
+
     Centroid* Centroid::clone() const {
         return new Centroid(*this);
     }
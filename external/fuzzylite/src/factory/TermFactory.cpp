@@ -35,6 +35,7 @@ fuzzylite is a registered trademark of FuzzyLite Limited.
 #include "fuzzylite/term/SigmoidDifference.h"
 #include "fuzzylite/term/SigmoidProduct.h"
 #include "fuzzylite/term/Spike.h"
+#include "fuzzylite/term/Tabulated.h"
 #include "fuzzylite/term/Trapezoid.h"
 #include "fuzzylite/term/Triangle.h"
 #include "fuzzylite/term/ZShape.h"
@@ -61,6 +62,7 @@ namespace fuzzylite {
         ConstructionFactory::registerConstructor(SigmoidDifference().className(), &(SigmoidDifference::constructor));
         ConstructionFactory::registerConstructor(SigmoidProduct().className(), &(SigmoidProduct::constructor));
         ConstructionFactory::registerConstructor(Spike().className(), &(Spike::constructor));
+        ConstructionFactory::registerConstructor(Tabulated().className(), &(Tabulated::constructor));
         ConstructionFactory::registerConstructor(Trapezoid().className(), &(Trapezoid::constructor));
         ConstructionFactory::registerConstructor(Triangle().className(), &(Triangle::constructor));
         ConstructionFactory::registerConstructor(ZShape().className(), &(ZShape::constructor));
@@ -195,6 +195,14 @@ namespace fuzzylite {
             return ss.str();
         }
 
+        if (const Tabulated* tabulated = dynamic_cast<const Tabulated*>(term)) {
+            std::ostringstream ss;
+            ss << "new " << fl(term->className()) << "(\"" << term->getName() << "\", "
+               << toString(tabulated->getTerm()) << ", " << toString(tabulated->getMinimum()) << ", "
+               << toString(tabulated->getMaximum()) << ", " << tabulated->getResolution() << ")";
+            return ss.str();
+        }
+
         if (const Linear* linear = dynamic_cast<const Linear*>(term)) {
             std::ostringstream ss;
             ss << fl(term->className()) << "::create(\"" << term->getName() << "\", " << "engine, "
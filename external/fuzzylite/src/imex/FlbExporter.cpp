@@ -0,0 +1,364 @@
+/*
+fuzzylite (R), a fuzzy logic control library in C++.
+
+Copyright (C) 2010-2024 FuzzyLite Limited. All rights reserved.
+Author: Juan Rada-Vilela, PhD <jcrada@fuzzylite.com>.
+
+This file is part of fuzzylite.
+
+fuzzylite is free software: you can redistribute it and/or modify it under
+the terms of the FuzzyLite License included with the software.
+
+You should have received a copy of the FuzzyLite License along with
+fuzzylite. If not, see <https://github.com/fuzzylite/fuzzylite/>.
+
+fuzzylite is a registered trademark of FuzzyLite Limited.
+*/
+
+#include "fuzzylite/imex/FlbExporter.h"
+
+#include <fstream>
+#include <map>
+
+#include "fuzzylite/Headers.h"
+
+namespace fuzzylite {
+
+    namespace {
+        /**
+          Appends the values to the snapshot, where the integers are stored in
+          little-endian order and the scalars in the byte order of the machine
+         */
+        class SnapshotWriter {
+          private:
+            std::string& _buffer;
+            std::map<const Variable*, std::pair<int, std::size_t> > _variables;
+
+          public:
+            explicit SnapshotWriter(std::string& buffer) : _buffer(buffer) {}
+
+            void bytes(const void* data, std::size_t size) {
+                _buffer.append(static_cast<const char*>(data), size);
+            }
+
+            void u8(int value) {
+                const unsigned char byte = static_cast<unsigned char>(value);
+                bytes(&byte, sizeof(byte));
+            }
+
+            void u32(std::size_t value) {
+                for (int i = 0; i < 4; ++i)
+                    u8(static_cast<int>((value >> (8 * i)) & 0xFF));
+            }
+
+            void i32(int value) {
+                u32(static_cast<std::size_t>(static_cast<unsigned long>(static_cast<long>(value)) & 0xFFFFFFFFul));
+            }
+
+            void real(scalar value) {
+                bytes(&value, sizeof(value));
+            }
+
+            void text(const std::string& value) {
+                u32(value.size());
+                _buffer.append(value);
+            }
+
+            void norm(const Norm* norm) {
+                text(norm ? norm->className() : "");
+            }
+
+            void reals(const std::vector<scalar>& values) {
+                u32(values.size());
+                for (std::size_t i = 0; i < values.size(); ++i)
+                    real(values.at(i));
+            }
+
+            void engine(const Engine* engine) {
+                for (std::size_t i = 0; i < engine->numberOfInputVariables(); ++i)
+                    _variables[engine->getInputVariable(i)] = std::make_pair(Variable::Input, i);
+                for (std::size_t i = 0; i < engine->numberOfOutputVariables(); ++i)
+                    _variables[engine->getOutputVariable(i)] = std::make_pair(Variable::Output, i);
+
+                text(engine->getName());
+                text(engine->getDescription());
+
+                u32(engine->numberOfInputVariables());
+                for (std::size_t i = 0; i < engine->numberOfInputVariables(); ++i) {
+                    const InputVariable* inputVariable = engine->getInputVariable(i);
+                    variable(inputVariable);
+                    real(inputVariable->getValue());
+                }
+
+                u32(engine->numberOfOutputVariables());
+                for (std::size_t i = 0; i < engine->numberOfOutputVariables(); ++i) {
+                    const OutputVariable* outputVariable = engine->getOutputVariable(i);
+                    variable(outputVariable);
+                    real(outputVariable->getValue());
+                    real(outputVariable->getPreviousValue());
+                    real(outputVariable->getDefaultValue());
+                    u8(outputVariable->isLockPreviousValue());
+                    norm(outputVariable->fuzzyOutput()->getAggregation());
+                    defuzzifier(outputVariable->getDefuzzifier());
+                }
+
+                u32(engine->numberOfRuleBlocks());
+                for (std::size_t i = 0; i < engine->numberOfRuleBlocks(); ++i)
+                    ruleBlock(engine->getRuleBlock(i));
+            }
+
+            void variable(const Variable* variable) {
+                text(variable->getName());
+                text(variable->getDescription());
+                u8(variable->isEnabled());
+                real(variable->getMinimum());
+                real(variable->getMaximum());
+                u8(variable->isLockValueInRange());
+                u32(variable->numberOfTerms());
+                for (std::size_t i = 0; i < variable->numberOfTerms(); ++i)
+                    term(variable->getTerm(i));
+            }
+
+            void defuzzifier(const Defuzzifier* defuzzifier) {
+                text(defuzzifier ? defuzzifier->className() : "");
+                int parameter = -1;
+                if (const IntegralDefuzzifier* integral = dynamic_cast<const IntegralDefuzzifier*>(defuzzifier))
+                    parameter = integral->getResolution();
+                else if (const WeightedDefuzzifier* weighted = dynamic_cast<const WeightedDefuzzifier*>(defuzzifier))
+                    parameter = weighted->getType();
+                i32(parameter);
+            }
+
+            void term(const Term* term) {
+                text(term->className());
+                text(term->getName());
+                if (const Tabulated* tabulated = dynamic_cast<const Tabulated*>(term)) {
+                    if (tabulated->getTerm()) {
+                        u8(Tabulation);
+                        i32(tabulated->getResolution());
+                        real(tabulated->getMinimum());
+                        real(tabulated->getMaximum());
+                        this->term(tabulated->getTerm());
+                        return;
+                    }
+                }
+                std::vector<scalar> values;
+                if (parameters(term, values)) {
+                    u8(Scalars);
+                    reals(values);
+                } else {
+                    u8(Text);
+                    text(term->parameters());
+                }
+            }
+
+            /**
+              Gets the parameters of the built-in terms in the order of their
+              constructors, followed by their height
+             */
+            static bool parameters(const Term* term, std::vector<scalar>& values) {
+                if (const Triangle* t = dynamic_cast<const Triangle*>(term)) {
+                    values.push_back(t->getVertexA());
+                    values.push_back(t->getVertexB());
+                    values.push_back(t->getVertexC());
+                } else if (const Trapezoid* t = dynamic_cast<const Trapezoid*>(term)) {
+                    values.push_back(t->getVertexA());
+                    values.push_back(t->getVertexB());
+                    values.push_back(t->getVertexC());
+                    values.push_back(t->getVertexD());
+                } else if (const Rectangle* t = dynamic_cast<const Rectangle*>(term)) {
+                    values.push_back(t->getStart());
+                    values.push_back(t->getEnd());
+                } else if (const Ramp* t = dynamic_cast<const Ramp*>(term)) {
+                    values.push_back(t->getStart());
+                    values.push_back(t->getEnd());
+                } else if (const SShape* t = dynamic_cast<const SShape*>(term)) {
+                    values.push_back(t->getStart());
+                    values.push_back(t->getEnd());
+                } else if (const ZShape* t = dynamic_cast<const ZShape*>(term)) {
+                    values.push_back(t->getStart());
+                    values.push_back(t->getEnd());
+                } else if (const Gaussian* t = dynamic_cast<const Gaussian*>(term)) {
+                    values.push_back(t->getMean());
+                    values.push_back(t->getStandardDeviation());
+                } else if (const GaussianProduct* t = dynamic_cast<const GaussianProduct*>(term)) {
+                    values.push_back(t->getMeanA());
+                    values.push_back(t->getStandardDeviationA());
+                    values.push_back(t->getMeanB());
+                    values.push_back(t->getStandardDeviationB());
+                } else if (const Bell* t = dynamic_cast<const Bell*>(term)) {
+                    values.push_back(t->getCenter());
+                    values.push_back(t->getWidth());
+                    values.push_back(t->getSlope());
+                } else if (const Cosine* t = dynamic_cast<const Cosine*>(term)) {
+                    values.push_back(t->getCenter());
+                    values.push_back(t->getWidth());
+                } else if (const Spike* t = dynamic_cast<const Spike*>(term)) {
+                    values.push_back(t->getCenter());
+                    values.push_back(t->getWidth());
+                } else if (const Sigmoid* t = dynamic_cast<const Sigmoid*>(term)) {
+                    values.push_back(t->getInflection());
+                    values.push_back(t->getSlope());
+                } else if (const Concave* t = dynamic_cast<const Concave*>(term)) {
+                    values.push_back(t->getInflection());
+                    values.push_back(t->getEnd());
+                } else if (const Binary* t = dynamic_cast<const Binary*>(term)) {
+                    values.push_back(t->getStart());
+                    values.push_back(t->getDirection());
+                } else if (const PiShape* t = dynamic_cast<const PiShape*>(term)) {
+                    values.push_back(t->getBottomLeft());
+                    values.push_back(t->getTopLeft());
+                    values.push_back(t->getTopRight());
+                    values.push_back(t->getBottomRight());
+                } else if (const SigmoidDifference* t = dynamic_cast<const SigmoidDifference*>(term)) {
+                    values.push_back(t->getLeft());
+                    values.push_back(t->getRising());
+                    values.push_back(t->getFalling());
+                    values.push_back(t->getRight());
+                } else if (const SigmoidProduct* t = dynamic_cast<const SigmoidProduct*>(term)) {
+                    values.push_back(t->getLeft());
+                    values.push_back(t->getRising());
+                    values.push_back(t->getFalling());
+                    values.push_back(t->getRight());
+                } else if (const Discrete* t = dynamic_cast<const Discrete*>(term)) {
+                    values = Discrete::toVector(t->xy());
+                } else if (const Constant* t = dynamic_cast<const Constant*>(term)) {
+                    values.push_back(t->getValue());
+                    return true;
+                } else if (const Linear* t = dynamic_cast<const Linear*>(term)) {
+                    values = t->coefficients();
+                    return true;
+                } else {
+                    return false;
+                }
+                values.push_back(term->getHeight());
+                return true;
+            }
+
+            void ruleBlock(const RuleBlock* ruleBlock) {
+                text(ruleBlock->getName());
+                text(ruleBlock->getDescription());
+                u8(ruleBlock->isEnabled());
+                norm(ruleBlock->getConjunction());
+                norm(ruleBlock->getDisjunction());
+                norm(ruleBlock->getImplication());
+                const Activation* activation = ruleBlock->getActivation();
+                text(activation ? activation->className() : "");
+                text(activation ? activation->parameters() : "");
+
+                u32(ruleBlock->numberOfRules());
+                for (std::size_t i = 0; i < ruleBlock->numberOfRules(); ++i) {
+                    const Rule* rule = ruleBlock->getRule(i);
+                    text(rule->getText());
+                    real(rule->getWeight());
+                    u8(rule->isEnabled());
+                    u8(rule->isLoaded());
+                    if (not rule->isLoaded())
+                        continue;
+                    text(rule->getAntecedent()->getText());
+                    expression(rule->getAntecedent()->getExpression());
+                    text(rule->getConsequent()->getText());
+                    const std::vector<Proposition*>& conclusions = rule->getConsequent()->conclusions();
+                    u32(conclusions.size());
+                    for (std::size_t c = 0; c < conclusions.size(); ++c)
+                        proposition(conclusions.at(c));
+                }
+            }
+
+            void expression(const Expression* node) {
+                if (node->type() == Expression::Proposition) {
+                    u8(Expression::Proposition);
+                    proposition(static_cast<const Proposition*>(node));
+                } else {
+                    const Operator* fuzzyOperator = static_cast<const Operator*>(node);
+                    u8(Expression::Operator);
+                    text(fuzzyOperator->name);
+                    expression(fuzzyOperator->left);
+                    expression(fuzzyOperator->right);
+                }
+            }
+
+            void proposition(const Proposition* proposition) {
+                std::map<const Variable*, std::pair<int, std::size_t> >::const_iterator it
+                    = _variables.find(proposition->variable);
+                if (it == _variables.end())
+                    throw Exception(
+                        "[export error] variable <" + proposition->variable->getName()
+                            + "> is not registered in the engine",
+                        FL_AT
+                    );
+                u8(it->second.first);
+                u32(it->second.second);
+
+                std::size_t index = NoTerm;
+                if (proposition->term) {
+                    for (std::size_t t = 0; t < proposition->variable->numberOfTerms(); ++t) {
+                        if (proposition->variable->getTerm(t) == proposition->term) {
+                            index = t;
+                            break;
+                        }
+                    }
+                    if (index == NoTerm)
+                        throw Exception(
+                            "[export error] term <" + proposition->term->getName()
+                                + "> is not registered in variable <" + proposition->variable->getName() + ">",
+                            FL_AT
+                        );
+                }
+                u32(index);
+
+                u32(proposition->hedges.size());
+                for (std::size_t h = 0; h < proposition->hedges.size(); ++h)
+                    text(proposition->hedges.at(h)->name());
+            }
+
+            enum TermEncoding { Scalars, Text, Tabulation };
+            static const std::size_t NoTerm = 0xFFFFFFFF;
+        };
+    }
+
+    FlbExporter::FlbExporter() : Exporter() {}
+
+    FlbExporter::~FlbExporter() {}
+
+    std::string FlbExporter::name() const {
+        return "FlbExporter";
+    }
+
+    std::string FlbExporter::magic() {
+        return std::string("FLB\0", 4);
+    }
+
+    int FlbExporter::version() {
+        return 1;
+    }
+
+    scalar FlbExporter::byteOrderMarker() {
+        return -1.0 / 1024.0;
+    }
+
+    std::string FlbExporter::toString(const Engine* engine) const {
+        std::string result;
+        SnapshotWriter writer(result);
+        writer.bytes(magic().data(), magic().size());
+        writer.u32(version());
+        writer.u32(sizeof(scalar));
+        writer.real(byteOrderMarker());
+        writer.engine(engine);
+        return result;
+    }
+
+    void FlbExporter::toFile(const std::string& path, const Engine* engine) const {
+        std::ofstream writer(path.c_str(), std::ios::out | std::ios::binary);
+        if (not writer.is_open())
+            throw Exception("[file error] file <" + path + "> could not be created", FL_AT);
+        const std::string snapshot = toString(engine);
+        writer.write(snapshot.data(), static_cast<std::streamsize>(snapshot.size()));
+        writer.close();
+    }
+
+    FlbExporter* FlbExporter::clone() const {
+        return new FlbExporter(*this);
+    }
+
+}
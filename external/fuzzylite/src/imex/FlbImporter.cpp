@@ -0,0 +1,450 @@
+/*
+fuzzylite (R), a fuzzy logic control library in C++.
+
+Copyright (C) 2010-2024 FuzzyLite Limited. All rights reserved.
+Author: Juan Rada-Vilela, PhD <jcrada@fuzzylite.com>.
+
+This file is part of fuzzylite.
+
+fuzzylite is free software: you can redistribute it and/or modify it under
+the terms of the FuzzyLite License included with the software.
+
+You should have received a copy of the FuzzyLite License along with
+fuzzylite. If not, see <https://github.com/fuzzylite/fuzzylite/>.
+
+fuzzylite is a registered trademark of FuzzyLite Limited.
+*/
+
+#include "fuzzylite/imex/FlbImporter.h"
+
+#include <cstring>
+#include <fstream>
+#include <map>
+
+#include "fuzzylite/Headers.h"
+
+namespace fuzzylite {
+
+    namespace {
+        /**
+          Reads the values of the snapshot in the order written by the
+          FlbExporter, checking the bounds of the buffer on every read
+         */
+        class SnapshotReader {
+          private:
+            const char* _data;
+            const char* _end;
+            Engine* _engine;
+
+          public:
+            SnapshotReader(const char* data, std::size_t size) : _data(data), _end(data + size), _engine(fl::null) {}
+
+            const char* bytes(std::size_t size) {
+                if (size > static_cast<std::size_t>(_end - _data))
+                    throw Exception("[import error] the snapshot is truncated", FL_AT);
+                const char* result = _data;
+                _data += size;
+                return result;
+            }
+
+            int u8() {
+                return static_cast<unsigned char>(*bytes(1));
+            }
+
+            bool boolean() {
+                return u8() != 0;
+            }
+
+            std::size_t u32() {
+                const unsigned char* word = reinterpret_cast<const unsigned char*>(bytes(4));
+                unsigned long result = 0;
+                for (int i = 3; i >= 0; --i)
+                    result = (result << 8) | word[i];
+                return static_cast<std::size_t>(result);
+            }
+
+            int i32() {
+                const unsigned long word = static_cast<unsigned long>(u32());
+                if (word & 0x80000000ul)
+                    return -static_cast<int>(0xFFFFFFFFul - word) - 1;
+                return static_cast<int>(word);
+            }
+
+            scalar real() {
+                scalar result;
+                std::memcpy(&result, bytes(sizeof(scalar)), sizeof(scalar));
+                return result;
+            }
+
+            std::string text() {
+                const std::size_t size = u32();
+                return std::string(bytes(size), size);
+            }
+
+            std::vector<scalar> reals() {
+                const std::size_t size = u32();
+                std::vector<scalar> result;
+                result.reserve(std::min(size, static_cast<std::size_t>(_end - _data) / sizeof(scalar)));
+                for (std::size_t i = 0; i < size; ++i)
+                    result.push_back(real());
+                return result;
+            }
+
+            void header() {
+                const std::string magic = FlbExporter::magic();
+                if (std::string(bytes(magic.size()), magic.size()) != magic)
+                    throw Exception("[import error] the snapshot does not start with the magic of FLB", FL_AT);
+                const int version = static_cast<int>(u32());
+                if (version != FlbExporter::version())
+                    throw Exception(
+                        "[import error] expected a snapshot in version <" + Op::str(FlbExporter::version())
+                            + ">, but found version <" + Op::str(version) + ">",
+                        FL_AT
+                    );
+                const std::size_t scalarSize = u32();
+                if (scalarSize != sizeof(scalar))
+                    throw Exception(
+                        "[import error] expected a snapshot with scalars of <" + Op::str(sizeof(scalar))
+                            + "> bytes, but found scalars of <" + Op::str(scalarSize) + "> bytes",
+                        FL_AT
+                    );
+                const scalar marker = FlbExporter::byteOrderMarker();
+                if (std::memcmp(bytes(sizeof(scalar)), &marker, sizeof(scalar)) != 0)
+                    throw Exception(
+                        "[import error] the snapshot was created in a machine with a different byte order", FL_AT
+                    );
+            }
+
+            Engine* engine() {
+                FL_unique_ptr<Engine> engine(new Engine);
+                _engine = engine.get();
+                engine->setName(text());
+                engine->setDescription(text());
+
+                const std::size_t inputs = u32();
+                for (std::size_t i = 0; i < inputs; ++i) {
+                    FL_unique_ptr<InputVariable> inputVariable(new InputVariable);
+                    variable(inputVariable.get());
+                    inputVariable->setValue(real());
+                    engine->addInputVariable(inputVariable.release());
+                }
+
+                const std::size_t outputs = u32();
+                for (std::size_t i = 0; i < outputs; ++i) {
+                    FL_unique_ptr<OutputVariable> outputVariable(new OutputVariable);
+                    variable(outputVariable.get());
+                    outputVariable->setValue(real());
+                    outputVariable->setPreviousValue(real());
+                    outputVariable->setDefaultValue(real());
+                    outputVariable->setLockPreviousValue(boolean());
+                    outputVariable->fuzzyOutput()->setAggregation(
+                        FactoryManager::instance()->snorm()->constructObject(text())
+                    );
+                    outputVariable->setDefuzzifier(defuzzifier());
+                    engine->addOutputVariable(outputVariable.release());
+                }
+
+                const std::size_t ruleBlocks = u32();
+                for (std::size_t i = 0; i < ruleBlocks; ++i) {
+                    FL_unique_ptr<RuleBlock> ruleBlock(new RuleBlock);
+                    this->ruleBlock(ruleBlock.get());
+                    engine->addRuleBlock(ruleBlock.release());
+                }
+
+                if (_data != _end)
+                    throw Exception(
+                        "[import error] the snapshot contains <" + Op::str(std::size_t(_end - _data))
+                            + "> unexpected bytes after the engine",
+                        FL_AT
+                    );
+                return engine.release();
+            }
+
+            void variable(Variable* variable) {
+                variable->setName(text());
+                variable->setDescription(text());
+                variable->setEnabled(boolean());
+                const scalar minimum = real();
+                const scalar maximum = real();
+                variable->setRange(minimum, maximum);
+                variable->setLockValueInRange(boolean());
+                const std::size_t terms = u32();
+                for (std::size_t i = 0; i < terms; ++i)
+                    variable->addTerm(term());
+            }
+
+            Defuzzifier* defuzzifier() {
+                Defuzzifier* result = FactoryManager::instance()->defuzzifier()->constructObject(text());
+                const int parameter = i32();
+                if (IntegralDefuzzifier* integral = dynamic_cast<IntegralDefuzzifier*>(result))
+                    integral->setResolution(parameter);
+                else if (WeightedDefuzzifier* weighted = dynamic_cast<WeightedDefuzzifier*>(result))
+                    weighted->setType(WeightedDefuzzifier::Type(parameter));
+                return result;
+            }
+
+            Term* term() {
+                const std::string className = text();
+                const std::string name = text();
+                const int encoding = u8();
+                if (encoding == Tabulation) {
+                    const int resolution = i32();
+                    const scalar minimum = real();
+                    const scalar maximum = real();
+                    return new Tabulated(name, term(), minimum, maximum, resolution);
+                }
+                FL_unique_ptr<Term> result(FactoryManager::instance()->term()->constructObject(className));
+                result->updateReference(_engine);
+                result->setName(name);
+                if (encoding == Scalars) {
+                    const std::vector<scalar> values = reals();
+                    if (not parameters(result.get(), values))
+                        throw Exception(
+                            "[import error] term <" + className + "> cannot be configured from <"
+                                + Op::str(values.size()) + "> parameters",
+                            FL_AT
+                        );
+                } else if (encoding == Text) {
+                    result->configure(text());
+                } else {
+                    throw Exception("[import error] unknown encoding <" + Op::str(encoding) + "> of term", FL_AT);
+                }
+                return result.release();
+            }
+
+            /**
+              Sets the parameters of the built-in terms in the order of their
+              constructors, followed by their height
+              @return whether the number of parameters matches the term
+             */
+            static bool parameters(Term* term, const std::vector<scalar>& values) {
+                std::size_t expected;
+                if (dynamic_cast<Discrete*>(term))
+                    expected = values.size() - (values.size() + 1) % 2;  // pairs followed by the height
+                else if (dynamic_cast<Linear*>(term))
+                    expected = values.size();
+                else if (dynamic_cast<Constant*>(term))
+                    expected = 1;
+                else if (dynamic_cast<Trapezoid*>(term) or dynamic_cast<GaussianProduct*>(term)
+                         or dynamic_cast<PiShape*>(term) or dynamic_cast<SigmoidDifference*>(term)
+                         or dynamic_cast<SigmoidProduct*>(term))
+                    expected = 5;
+                else if (dynamic_cast<Triangle*>(term) or dynamic_cast<Bell*>(term))
+                    expected = 4;
+                else
+                    expected = 3;
+                if (values.size() != expected or values.empty())
+                    return false;
+
+                const scalar* v = &values.front();
+                if (Triangle* t = dynamic_cast<Triangle*>(term)) {
+                    t->setVertexA(v[0]);
+                    t->setVertexB(v[1]);
+                    t->setVertexC(v[2]);
+                } else if (Trapezoid* t = dynamic_cast<Trapezoid*>(term)) {
+                    t->setVertexA(v[0]);
+                    t->setVertexB(v[1]);
+                    t->setVertexC(v[2]);
+                    t->setVertexD(v[3]);
+                } else if (Rectangle* t = dynamic_cast<Rectangle*>(term)) {
+                    t->setStart(v[0]);
+                    t->setEnd(v[1]);
+                } else if (Ramp* t = dynamic_cast<Ramp*>(term)) {
+                    t->setStart(v[0]);
+                    t->setEnd(v[1]);
+                } else if (SShape* t = dynamic_cast<SShape*>(term)) {
+                    t->setStart(v[0]);
+                    t->setEnd(v[1]);
+                } else if (ZShape* t = dynamic_cast<ZShape*>(term)) {
+                    t->setStart(v[0]);
+                    t->setEnd(v[1]);
+                } else if (Gaussian* t = dynamic_cast<Gaussian*>(term)) {
+                    t->setMean(v[0]);
+                    t->setStandardDeviation(v[1]);
+                } else if (GaussianProduct* t = dynamic_cast<GaussianProduct*>(term)) {
+                    t->setMeanA(v[0]);
+                    t->setStandardDeviationA(v[1]);
+                    t->setMeanB(v[2]);
+                    t->setStandardDeviationB(v[3]);
+                } else if (Bell* t = dynamic_cast<Bell*>(term)) {
+                    t->setCenter(v[0]);
+                    t->setWidth(v[1]);
+                    t->setSlope(v[2]);
+                } else if (Cosine* t = dynamic_cast<Cosine*>(term)) {
+                    t->setCenter(v[0]);
+                    t->setWidth(v[1]);
+                } else if (Spike* t = dynamic_cast<Spike*>(term)) {
+                    t->setCenter(v[0]);
+                    t->setWidth(v[1]);
+                } else if (Sigmoid* t = dynamic_cast<Sigmoid*>(term)) {
+                    t->setInflection(v[0]);
+                    t->setSlope(v[1]);
+                } else if (Concave* t = dynamic_cast<Concave*>(term)) {
+                    t->setInflection(v[0]);
+                    t->setEnd(v[1]);
+                } else if (Binary* t = dynamic_cast<Binary*>(term)) {
+                    t->setStart(v[0]);
+                    t->setDirection(v[1]);
+                } else if (PiShape* t = dynamic_cast<PiShape*>(term)) {
+                    t->setBottomLeft(v[0]);
+                    t->setTopLeft(v[1]);
+                    t->setTopRight(v[2]);
+                    t->setBottomRight(v[3]);
+                } else if (SigmoidDifference* t = dynamic_cast<SigmoidDifference*>(term)) {
+                    t->setLeft(v[0]);
+                    t->setRising(v[1]);
+                    t->setFalling(v[2]);
+                    t->setRight(v[3]);
+                } else if (SigmoidProduct* t = dynamic_cast<SigmoidProduct*>(term)) {
+                    t->setLeft(v[0]);
+                    t->setRising(v[1]);
+                    t->setFalling(v[2]);
+                    t->setRight(v[3]);
+                } else if (Discrete* t = dynamic_cast<Discrete*>(term)) {
+                    t->setXY(Discrete::toPairs(std::vector<scalar>(values.begin(), values.end() - 1)));
+                } else if (Constant* t = dynamic_cast<Constant*>(term)) {
+                    t->setValue(v[0]);
+                    return true;
+                } else if (Linear* t = dynamic_cast<Linear*>(term)) {
+                    t->setCoefficients(values);
+                    return true;
+                } else {
+                    return false;
+                }
+                term->setHeight(values.back());
+                return true;
+            }
+
+            void ruleBlock(RuleBlock* ruleBlock) {
+                ruleBlock->setName(text());
+                ruleBlock->setDescription(text());
+                ruleBlock->setEnabled(boolean());
+                ruleBlock->setConjunction(FactoryManager::instance()->tnorm()->constructObject(text()));
+                ruleBlock->setDisjunction(FactoryManager::instance()->snorm()->constructObject(text()));
+                ruleBlock->setImplication(FactoryManager::instance()->tnorm()->constructObject(text()));
+                Activation* activation = FactoryManager::instance()->activation()->constructObject(text());
+                const std::string parameters = text();
+                if (activation)
+                    activation->configure(parameters);
+                ruleBlock->setActivation(activation);
+
+                std::map<OutputVariable*, std::size_t> conclusions;
+                const std::size_t rules = u32();
+                for (std::size_t i = 0; i < rules; ++i) {
+                    const std::string ruleText = text();
+                    const scalar weight = real();
+                    FL_unique_ptr<Rule> rule(new Rule(ruleText, weight));
+                    rule->setEnabled(boolean());
+                    if (boolean()) {
+                        rule->getAntecedent()->setText(text());
+                        rule->getAntecedent()->setExpression(expression());
+                        rule->getConsequent()->setText(text());
+                        const std::size_t size = u32();
+                        std::vector<Proposition*>& propositions = rule->getConsequent()->conclusions();
+                        for (std::size_t c = 0; c < size; ++c) {
+                            propositions.push_back(proposition());
+                            if (propositions.back()->variable->type() != Variable::Output)
+                                throw Exception(
+                                    "[import error] consequent <" + rule->getConsequent()->getText()
+                                        + "> concludes on a variable that is not an output variable",
+                                    FL_AT
+                                );
+                            ++conclusions[static_cast<OutputVariable*>(propositions.back()->variable)];
+                        }
+                    }
+                    ruleBlock->addRule(rule.release());
+                }
+                // the fuzzy outputs can hold the conclusions of the rules without allocating memory
+                std::map<OutputVariable*, std::size_t>::const_iterator it;
+                for (it = conclusions.begin(); it != conclusions.end(); ++it)
+                    it->first->fuzzyOutput()->reserve(it->second);
+            }
+
+            Expression* expression() {
+                const int type = u8();
+                if (type == Expression::Proposition)
+                    return proposition();
+                if (type != Expression::Operator)
+                    throw Exception("[import error] unknown type <" + Op::str(type) + "> of expression", FL_AT);
+                FL_unique_ptr<Operator> result(new Operator);
+                result->name = text();
+                result->left = expression();
+                result->right = expression();
+                return result.release();
+            }
+
+            Proposition* proposition() {
+                FL_unique_ptr<Proposition> result(new Proposition);
+                const int type = u8();
+                const std::size_t index = u32();
+                if (type == Variable::Input and index < _engine->numberOfInputVariables())
+                    result->variable = _engine->getInputVariable(index);
+                else if (type == Variable::Output and index < _engine->numberOfOutputVariables())
+                    result->variable = _engine->getOutputVariable(index);
+                else
+                    throw Exception(
+                        "[import error] proposition refers to unknown variable <" + Op::str(index) + ">", FL_AT
+                    );
+
+                const std::size_t term = u32();
+                if (term < result->variable->numberOfTerms())
+                    result->term = result->variable->getTerm(term);
+                else if (term != 0xFFFFFFFF)
+                    throw Exception(
+                        "[import error] proposition refers to unknown term <" + Op::str(term) + "> in variable <"
+                            + result->variable->getName() + ">",
+                        FL_AT
+                    );
+
+                const std::size_t hedges = u32();
+                for (std::size_t h = 0; h < hedges; ++h) {
+                    const std::string hedge = text();
+                    if (not FactoryManager::instance()->hedge()->hasConstructor(hedge))
+                        throw Exception("[import error] hedge <" + hedge + "> not registered", FL_AT);
+                    result->hedges.push_back(FactoryManager::instance()->hedge()->constructObject(hedge));
+                }
+                return result.release();
+            }
+
+            enum TermEncoding { Scalars, Text, Tabulation };
+        };
+    }
+
+    FlbImporter::FlbImporter() : Importer() {}
+
+    FlbImporter::~FlbImporter() {}
+
+    std::string FlbImporter::name() const {
+        return "FlbImporter";
+    }
+
+    Engine* FlbImporter::fromString(const std::string& text) const {
+        return fromBuffer(text.data(), text.size());
+    }
+
+    Engine* FlbImporter::fromFile(const std::string& path) const {
+        std::ifstream reader(path.c_str(), std::ios::in | std::ios::binary);
+        if (not reader.is_open())
+            throw Exception("[file error] file <" + path + "> could not be opened", FL_AT);
+        std::ostringstream snapshot;
+        snapshot << reader.rdbuf();
+        reader.close();
+        return fromString(snapshot.str());
+    }
+
+    Engine* FlbImporter::fromBuffer(const char* data, std::size_t size) const {
+        SnapshotReader reader(data, size);
+        reader.header();
+        return reader.engine();
+    }
+
+    Engine* FlbImporter::cloneEngine(const Engine* engine) const {
+        const std::string snapshot = FlbExporter().toString(engine);
+        return fromBuffer(snapshot.data(), snapshot.size());
+    }
+
+    FlbImporter* FlbImporter::clone() const {
+        return new FlbImporter(*this);
+    }
+
+}
@@ -17,22 +17,473 @@ fuzzylite is a registered trademark of FuzzyLite Limited.
 
 #include "fuzzylite/imex/FldExporter.h"
 
+#include <cstring>
+#include <ctime>
+#include <deque>
 #include <fstream>
+#include <map>
 
 #include "fuzzylite/Engine.h"
+#include "fuzzylite/EngineState.h"
 #include "fuzzylite/Operation.h"
+#include "fuzzylite/imex/FlbExporter.h"
 #include "fuzzylite/variable/InputVariable.h"
 #include "fuzzylite/variable/OutputVariable.h"
 #include "fuzzylite/variable/Variable.h"
 
+#ifdef FL_CPP98
+// datasets are evaluated on a single thread in C++98
+#else
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#endif
+
 namespace fuzzylite {
 
+    namespace {
+        void writeWord(std::ostream& writer, std::size_t value) {
+            char word[4];
+            for (int i = 0; i < 4; ++i)
+                word[i] = char((value >> (8 * i)) & 0xFF);
+            writer.write(word, 4);
+        }
+
+        void appendWord(std::string& buffer, std::size_t value) {
+            for (int i = 0; i < 4; ++i)
+                buffer.push_back(char((value >> (8 * i)) & 0xFF));
+        }
+
+        std::size_t readWord(std::istream& reader) {
+            unsigned char word[4];
+            if (not reader.read(reinterpret_cast<char*>(word), 4))
+                throw Exception("[import error] the binary dataset is truncated", FL_AT);
+            unsigned long result = 0;
+            for (int i = 3; i >= 0; --i)
+                result = (result << 8) | word[i];
+            return static_cast<std::size_t>(result);
+        }
+
+        scalar readScalar(std::istream& reader) {
+            scalar result;
+            if (not reader.read(reinterpret_cast<char*>(&result), sizeof(scalar)))
+                throw Exception("[import error] the binary dataset is truncated", FL_AT);
+            return result;
+        }
+
+        /**
+          Gets the seconds elapsed since an arbitrary point in time
+         */
+        scalar seconds() {
+#ifdef FL_CPP98
+            return scalar(std::clock()) / CLOCKS_PER_SEC;
+#else
+            return std::chrono::duration<scalar>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+        }
+
+        /**
+          A chunk of consecutive rows of the dataset, given either by a range
+          of rows of the grid or by the lines read from the reader
+         */
+        struct FldChunk {
+            std::size_t first, last;
+            std::vector<std::pair<std::size_t, std::string> > lines;
+            std::size_t rows;
+            std::string output;
+
+            FldChunk() : first(0), last(0), rows(0) {}
+        };
+
+        /**
+          Evaluates the chunks of a dataset on engine states, starting every
+          chunk from the same state, and formats their rows in text or binary
+         */
+        class FldEvaluator {
+          private:
+            const FldExporter& _exporter;
+            const Engine* _engine;
+            std::vector<bool> _active;
+            int _resolution;
+            std::vector<std::size_t> _dimensions;
+            EngineState _initial;
+
+          public:
+            FldEvaluator(
+                const FldExporter& exporter,
+                const Engine* engine,
+                const std::vector<InputVariable*>& activeVariables,
+                int resolution
+            ) :
+                _exporter(exporter),
+                _engine(engine),
+                _resolution(resolution),
+                _initial(engine) {
+                for (std::size_t i = 0; i < engine->numberOfInputVariables(); ++i) {
+                    _active.push_back(engine->getInputVariable(i) == activeVariables.at(i));
+                    _dimensions.push_back(_active.back() ? std::size_t(resolution + 1) : std::size_t(1));
+                }
+            }
+
+            /**
+              Gets the number of rows in the grid, or zero if they exceed the
+              size of std::size_t
+             */
+            std::size_t gridSize() const {
+                std::size_t result = 1;
+                for (std::size_t i = 0; i < _dimensions.size(); ++i) {
+                    if (result > std::size_t(-1) / _dimensions.at(i))
+                        return 0;
+                    result *= _dimensions.at(i);
+                }
+                return result;
+            }
+
+            const EngineState& initialState() const {
+                return _initial;
+            }
+
+            void evaluate(FldChunk& chunk, EngineState& state) const {
+                state = _initial;
+                chunk.output.clear();
+                chunk.rows = 0;
+                std::vector<std::vector<scalar> > rows;
+                std::vector<scalar> inputValues(_engine->numberOfInputVariables());
+                if (chunk.lines.empty()) {
+                    for (std::size_t row = chunk.first; row < chunk.last; ++row) {
+                        std::size_t index = row;
+                        for (std::size_t i = inputValues.size(); i-- > 0;) {
+                            const InputVariable* inputVariable = _engine->getInputVariable(i);
+                            if (_active.at(i)) {
+                                const int sample = int(index % _dimensions.at(i));
+                                inputValues.at(i) = inputVariable->getMinimum()
+                                                    + sample * inputVariable->range() / std::max(1, _resolution);
+                            } else {
+                                inputValues.at(i) = inputVariable->getValue();
+                            }
+                            index /= _dimensions.at(i);
+                        }
+                        rows.push_back(evaluate(inputValues, state));
+                    }
+                } else {
+                    for (std::size_t l = 0; l < chunk.lines.size(); ++l) {
+                        const std::string& line = chunk.lines.at(l).second;
+                        const std::vector<scalar> values = _exporter.parse(line);
+                        if (values.empty()) {  // blank lines are retained in text
+                            if (_exporter.getFormat() == FldExporter::Text)
+                                rows.push_back(values);
+                            continue;
+                        }
+                        try {
+                            if (values.size() < _engine->numberOfInputVariables()) {
+                                std::ostringstream ex;
+                                ex << "[export error] engine has <" << _engine->numberOfInputVariables()
+                                   << "> input variables, but input data provides <" << values.size() << "> values";
+                                throw Exception(ex.str(), FL_AT);
+                            }
+                            rows.push_back(evaluate(values, state));
+                        } catch (Exception& ex) {
+                            ex.append(" writing line <" + Op::str(chunk.lines.at(l).first) + ">");
+                            throw;
+                        }
+                    }
+                }
+                chunk.rows = rows.size();
+                if (_exporter.getFormat() == FldExporter::Binary)
+                    formatBinary(rows, chunk.output);
+                else
+                    formatText(rows, chunk.output);
+            }
+
+            std::vector<scalar> evaluate(const std::vector<scalar>& inputValues, EngineState& state) const {
+                std::vector<scalar> result;
+                for (std::size_t i = 0; i < _engine->numberOfInputVariables(); ++i) {
+                    state.setInputValue(i, inputValues.at(i));
+                    if (_exporter.exportsInputValues())
+                        result.push_back(inputValues.at(i));
+                }
+                _engine->process(state);
+                if (_exporter.exportsOutputValues()) {
+                    for (std::size_t i = 0; i < _engine->numberOfOutputVariables(); ++i)
+                        result.push_back(state.getOutputValue(i));
+                }
+                return result;
+            }
+
+            void formatText(const std::vector<std::vector<scalar> >& rows, std::string& output) const {
+                std::ostringstream writer;
+                for (std::size_t r = 0; r < rows.size(); ++r)
+                    writer << Op::join(rows.at(r), _exporter.getSeparator()) << "\n";
+                output = writer.str();
+            }
+
+            void formatBinary(const std::vector<std::vector<scalar> >& rows, std::string& output) const {
+                if (rows.empty())
+                    return;
+                const std::size_t columns = rows.front().size();
+                output.reserve(4 + rows.size() * columns * sizeof(scalar));
+                appendWord(output, rows.size());
+                for (std::size_t c = 0; c < columns; ++c) {
+                    for (std::size_t r = 0; r < rows.size(); ++r)
+                        output.append(reinterpret_cast<const char*>(&rows[r][c]), sizeof(scalar));
+                }
+            }
+        };
+
+        /**
+          Produces the chunks of the dataset in the order of their rows
+         */
+        class FldChunks {
+          public:
+            virtual ~FldChunks() {}
+            virtual bool next(FldChunk& chunk) = 0;
+        };
+
+        class FldGridChunks : public FldChunks {
+          private:
+            std::size_t _next, _size, _chunkSize;
+
+          public:
+            FldGridChunks(std::size_t size, std::size_t chunkSize) : _next(0), _size(size), _chunkSize(chunkSize) {}
+
+            bool next(FldChunk& chunk) FL_IOVERRIDE {
+                if (_next >= _size)
+                    return false;
+                chunk.first = _next;
+                chunk.last = _next + std::min(_chunkSize, _size - _next);
+                _next = chunk.last;
+                return true;
+            }
+        };
+
+        class FldReaderChunks : public FldChunks {
+          private:
+            const FldExporter& _exporter;
+            std::istream& _reader;
+            std::size_t _lineNumber, _chunkSize;
+
+          public:
+            FldReaderChunks(const FldExporter& exporter, std::istream& reader, std::size_t chunkSize) :
+                _exporter(exporter),
+                _reader(reader),
+                _lineNumber(0),
+                _chunkSize(chunkSize) {}
+
+            bool next(FldChunk& chunk) FL_IOVERRIDE {
+                std::string line;
+                while (chunk.lines.size() < _chunkSize and std::getline(_reader, line)) {
+                    ++_lineNumber;
+                    line = Op::trim(line);
+                    if (not line.empty() and line.at(0) == '#')
+                        continue;  // comments are ignored, blank lines are retained
+                    if (_lineNumber == 1) {  // automatic detection of header.
+                        try {
+                            _exporter.parse(line);
+                        } catch (std::exception&) { continue; }
+                    }
+                    chunk.lines.push_back(std::make_pair(_lineNumber, line));
+                }
+                return not chunk.lines.empty();
+            }
+        };
+
+        /**
+          Reports the number of rows written and the rows written per second
+         */
+        class FldProgress {
+          private:
+            std::ostream* _writer;
+            std::size_t _total, _rows;
+            scalar _start, _reported;
+
+          public:
+            FldProgress(std::ostream* writer, std::size_t total) :
+                _writer(writer),
+                _total(total),
+                _rows(0),
+                _start(seconds()),
+                _reported(_start) {}
+
+            void add(std::size_t rows, bool finished) {
+                _rows += rows;
+                if (not _writer)
+                    return;
+                const scalar now = seconds();
+                if (not finished and now - _reported < 1.0)
+                    return;
+                _reported = now;
+                const scalar elapsed = now - _start;
+                std::ostringstream report;
+                report << "[fld] " << _rows;
+                if (_total > 0)
+                    report << "/" << _total << " rows (" << Op::str(100.0 * _rows / _total, 1) << "%)";
+                else
+                    report << " rows";
+                report << " in " << Op::str(elapsed, 3) << " s";
+                if (elapsed > 0.0)
+                    report << " at " << Op::str(_rows / elapsed, 0) << " rows/s";
+                (*_writer) << report.str() << std::endl;
+            }
+        };
+
+        /**
+          Evaluates the chunks on the given number of threads, and writes them
+          in order as soon as they are evaluated, keeping at most two chunks
+          per thread in memory
+         */
+        void writeChunks(
+            const FldEvaluator& evaluator,
+            FldChunks& chunks,
+            std::ostream& writer,
+            int threads,
+            FldProgress& progress
+        ) {
+#ifdef FL_CPP98
+            FL_IUNUSED(threads);
+            EngineState state(evaluator.initialState());
+            FldChunk chunk;
+            while (chunks.next(chunk)) {
+                evaluator.evaluate(chunk, state);
+                writer.write(chunk.output.data(), std::streamsize(chunk.output.size()));
+                progress.add(chunk.rows, false);
+                chunk = FldChunk();
+            }
+            progress.add(0, true);
+#else
+            std::mutex mutex;
+            std::condition_variable pendingChanged, evaluatedChanged;
+            std::deque<std::pair<std::size_t, FldChunk> > pending;
+            std::map<std::size_t, FldChunk> evaluated;
+            std::exception_ptr failure;
+            bool finished = false;
+
+            auto work = [&]() {
+                EngineState state(evaluator.initialState());
+                while (true) {
+                    std::pair<std::size_t, FldChunk> task;
+                    {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        pendingChanged.wait(lock, [&] { return finished or failure or not pending.empty(); });
+                        if (failure or pending.empty())
+                            return;
+                        task = std::move(pending.front());
+                        pending.pop_front();
+                    }
+                    try {
+                        evaluator.evaluate(task.second, state);
+                    } catch (...) {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        if (not failure)
+                            failure = std::current_exception();
+                        evaluatedChanged.notify_all();
+                        pendingChanged.notify_all();
+                        return;
+                    }
+                    std::lock_guard<std::mutex> lock(mutex);
+                    evaluated[task.first] = std::move(task.second);
+                    evaluatedChanged.notify_all();
+                }
+            };
+
+            std::vector<std::thread> workers;
+            for (int i = 0; i < threads; ++i)
+                workers.push_back(std::thread(work));
+            auto stop = [&]() {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    finished = true;
+                }
+                pendingChanged.notify_all();
+                for (std::size_t i = 0; i < workers.size(); ++i)
+                    workers.at(i).join();
+            };
+
+            try {
+                const std::size_t window = 2 * std::size_t(threads);
+                std::size_t produced = 0, written = 0;
+                bool exhausted = false;
+                while (true) {
+                    while (not exhausted and produced - written < window) {
+                        FldChunk chunk;
+                        if (not chunks.next(chunk)) {
+                            exhausted = true;
+                            break;
+                        }
+                        std::lock_guard<std::mutex> lock(mutex);
+                        pending.push_back(std::make_pair(produced++, std::move(chunk)));
+                        pendingChanged.notify_one();
+                    }
+                    if (exhausted and written == produced)
+                        break;
+
+                    FldChunk chunk;
+                    {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        evaluatedChanged.wait(lock, [&] { return failure or evaluated.count(written) > 0; });
+                        if (failure)
+                            break;
+                        chunk = std::move(evaluated[written]);
+                        evaluated.erase(written);
+                    }
+                    writer.write(chunk.output.data(), std::streamsize(chunk.output.size()));
+                    ++written;
+                    progress.add(chunk.rows, false);
+                }
+            } catch (...) {
+                stop();
+                throw;
+            }
+            stop();
+            if (failure)
+                std::rethrow_exception(failure);
+            progress.add(0, true);
+#endif
+        }
+
+        /**
+          Indicates whether the exporter evaluates the engine itself row by
+          row, as opposed to evaluating chunks of rows on engine states
+         */
+        bool evaluatesEngine(const FldExporter& exporter) {
+            return exporter.getThreads() == 1 and exporter.getFormat() == FldExporter::Text
+                   and not exporter.getProgress();
+        }
+
+        void writeDataset(
+            const FldExporter& exporter,
+            const Engine* engine,
+            const FldEvaluator& evaluator,
+            FldChunks& chunks,
+            std::ostream& writer,
+            std::size_t rows
+        ) {
+            int threads = exporter.getThreads();
+#ifndef FL_CPP98
+            if (threads <= 0)
+                threads = int(std::max(1u, std::thread::hardware_concurrency()));
+#endif
+            threads = std::max(1, threads);
+            if (exporter.getFormat() == FldExporter::Binary)
+                exporter.writeBinaryHeader(engine, writer);
+            FldProgress progress(exporter.getProgress(), rows);
+            writeChunks(evaluator, chunks, writer, threads, progress);
+            if (exporter.getFormat() == FldExporter::Binary)
+                writeWord(writer, 0);
+        }
+    }
+
     FldExporter::FldExporter(const std::string& separator) :
         Exporter(),
         _separator(separator),
         _exportHeaders(true),
         _exportInputValues(true),
-        _exportOutputValues(true) {}
+        _exportOutputValues(true),
+        _threads(1),
+        _chunkSize(1024),
+        _format(Text),
+        _progress(fl::null) {}
 
     FldExporter::~FldExporter() {}
 
@@ -72,6 +523,38 @@ namespace fuzzylite {
         return this->_exportOutputValues;
     }
 
+    void FldExporter::setThreads(int threads) {
+        this->_threads = threads;
+    }
+
+    int FldExporter::getThreads() const {
+        return this->_threads;
+    }
+
+    void FldExporter::setChunkSize(std::size_t chunkSize) {
+        this->_chunkSize = chunkSize;
+    }
+
+    std::size_t FldExporter::getChunkSize() const {
+        return this->_chunkSize;
+    }
+
+    void FldExporter::setFormat(Format format) {
+        this->_format = format;
+    }
+
+    FldExporter::Format FldExporter::getFormat() const {
+        return this->_format;
+    }
+
+    void FldExporter::setProgress(std::ostream* progress) {
+        this->_progress = progress;
+    }
+
+    std::ostream* FldExporter::getProgress() const {
+        return this->_progress;
+    }
+
     std::string FldExporter::header(const Engine* engine) const {
         std::vector<std::string> result;
         if (_exportInputValues) {
@@ -107,26 +590,7 @@ namespace fuzzylite {
 
     std::string FldExporter::toString(Engine* engine, std::istream& reader) const {
         std::ostringstream writer;
-        if (_exportHeaders)
-            writer << header(engine) << "\n";
-        std::string line;
-        int lineNumber = 0;
-        while (std::getline(reader, line)) {
-            ++lineNumber;
-            line = Op::trim(line);
-            if (not line.empty() and line.at(0) == '#')
-                continue;  // comments are ignored, blank lines are retained
-            std::vector<scalar> inputValues;
-            if (lineNumber == 1) {  // automatic detection of header.
-                try {
-                    inputValues = parse(line);
-                } catch (std::exception&) { continue; }
-            } else {
-                inputValues = parse(line);
-            }
-
-            write(engine, writer, inputValues, engine->inputVariables());
-        }
+        write(engine, writer, reader);
         return writer.str();
     }
 
@@ -141,7 +605,7 @@ namespace fuzzylite {
         ScopeOfValues scope,
         const std::vector<InputVariable*>& activeVariables
     ) const {
-        std::ofstream writer(path.c_str());
+        std::ofstream writer(path.c_str(), _format == Binary ? std::ios::out | std::ios::binary : std::ios::out);
         if (not writer.is_open())
             throw Exception("[file error] file <" + path + "> could not be created", FL_AT);
         write(engine, writer, values, scope, activeVariables);
@@ -149,30 +613,10 @@ namespace fuzzylite {
     }
 
     void FldExporter::toFile(const std::string& path, Engine* engine, std::istream& reader) const {
-        std::ofstream writer(path.c_str());
+        std::ofstream writer(path.c_str(), _format == Binary ? std::ios::out | std::ios::binary : std::ios::out);
         if (not writer.is_open())
             throw Exception("[file error] file <" + path + "> could not be created", FL_AT);
-        if (_exportHeaders)
-            writer << header(engine) << "\n";
-
-        std::string line;
-        int lineNumber = 0;
-        while (std::getline(reader, line)) {
-            ++lineNumber;
-            line = Op::trim(line);
-            if (not line.empty() and line.at(0) == '#')
-                continue;  // comments are ignored, blank lines are retained
-            std::vector<scalar> inputValues;
-            if (lineNumber == 1) {  // automatic detection of header.
-                try {
-                    inputValues = parse(line);
-                } catch (std::exception&) { continue; }
-            } else {
-                inputValues = parse(line);
-            }
-
-            write(engine, writer, inputValues, engine->inputVariables());
-        }
+        write(engine, writer, reader);
         writer.close();
     }
 
@@ -183,6 +627,66 @@ namespace fuzzylite {
         return inputValues;
     }
 
+    void FldExporter::writeBinaryHeader(const Engine* engine, std::ostream& writer) const {
+        const std::string magic("FLD\0", 4);
+        writer.write(magic.data(), std::streamsize(magic.size()));
+        writeWord(writer, 1);
+        writeWord(writer, sizeof(scalar));
+        const scalar marker = FlbExporter::byteOrderMarker();
+        writer.write(reinterpret_cast<const char*>(&marker), sizeof(scalar));
+        std::vector<std::string> columns;
+        if (_exportInputValues) {
+            for (std::size_t i = 0; i < engine->numberOfInputVariables(); ++i)
+                columns.push_back(engine->getInputVariable(i)->getName());
+        }
+        if (_exportOutputValues) {
+            for (std::size_t i = 0; i < engine->numberOfOutputVariables(); ++i)
+                columns.push_back(engine->getOutputVariable(i)->getName());
+        }
+        writeWord(writer, columns.size());
+        for (std::size_t i = 0; i < columns.size(); ++i) {
+            writeWord(writer, columns.at(i).size());
+            writer.write(columns.at(i).data(), std::streamsize(columns.at(i).size()));
+        }
+    }
+
+    std::vector<std::vector<scalar> >
+    FldExporter::readBinary(std::istream& reader, std::vector<std::string>* columns) const {
+        char magic[4];
+        if (not reader.read(magic, 4) or std::string(magic, 4) != std::string("FLD\0", 4))
+            throw Exception("[import error] the dataset does not start with the magic of binary FLD", FL_AT);
+        const std::size_t version = readWord(reader);
+        if (version != 1)
+            throw Exception("[import error] binary dataset in unknown version <" + Op::str(version) + ">", FL_AT);
+        if (readWord(reader) != sizeof(scalar))
+            throw Exception("[import error] binary dataset has scalars of a different size", FL_AT);
+        const scalar marker = readScalar(reader), expected = FlbExporter::byteOrderMarker();
+        if (std::memcmp(&marker, &expected, sizeof(scalar)) != 0)
+            throw Exception(
+                "[import error] binary dataset was created in a machine with a different byte order", FL_AT
+            );
+
+        const std::size_t numberOfColumns = readWord(reader);
+        for (std::size_t i = 0; i < numberOfColumns; ++i) {
+            std::string column(readWord(reader), '\0');
+            if (not column.empty() and not reader.read(&column[0], std::streamsize(column.size())))
+                throw Exception("[import error] the binary dataset is truncated", FL_AT);
+            if (columns)
+                columns->push_back(column);
+        }
+
+        std::vector<std::vector<scalar> > result;
+        for (std::size_t rows = readWord(reader); rows > 0; rows = readWord(reader)) {
+            const std::size_t offset = result.size();
+            result.resize(offset + rows, std::vector<scalar>(numberOfColumns));
+            for (std::size_t c = 0; c < numberOfColumns; ++c) {
+                for (std::size_t r = 0; r < rows; ++r)
+                    result[offset + r][c] = readScalar(reader);
+            }
+        }
+        return result;
+    }
+
     void FldExporter::write(Engine* engine, std::ostream& writer, int values, ScopeOfValues scope) const {
         write(engine, writer, values, scope, engine->inputVariables());
     }
@@ -194,7 +698,7 @@ namespace fuzzylite {
         ScopeOfValues scope,
         const std::vector<InputVariable*>& activeVariables
     ) const {
-        if (_exportHeaders)
+        if (_exportHeaders and _format == Text)
             writer << header(engine) << "\n";
 
         if (activeVariables.size() != engine->inputVariables().size()) {
@@ -214,6 +718,16 @@ namespace fuzzylite {
         else  // if (scope == EachVariable)
             resolution = values - 1;
 
+        if (not evaluatesEngine(*this)) {
+            FldEvaluator evaluator(*this, engine, activeVariables, resolution);
+            const std::size_t rows = evaluator.gridSize();
+            if (rows == 0)
+                throw Exception("[exporter error] the number of rows exceeds the size of the dataset", FL_AT);
+            FldGridChunks chunks(rows, std::max(std::size_t(1), _chunkSize));
+            writeDataset(*this, engine, evaluator, chunks, writer, rows);
+            return;
+        }
+
         std::vector<int> sampleValues, minSampleValues, maxSampleValues;
         for (std::size_t i = 0; i < engine->numberOfInputVariables(); ++i) {
             sampleValues.push_back(0);
@@ -240,9 +754,16 @@ namespace fuzzylite {
     }
 
     void FldExporter::write(Engine* engine, std::ostream& writer, std::istream& reader) const {
-        if (_exportHeaders)
+        if (_exportHeaders and _format == Text)
             writer << header(engine) << "\n";
 
+        if (not evaluatesEngine(*this)) {
+            FldEvaluator evaluator(*this, engine, engine->inputVariables(), 0);
+            FldReaderChunks chunks(*this, reader, std::max(std::size_t(1), _chunkSize));
+            writeDataset(*this, engine, evaluator, chunks, writer, 0);
+            return;
+        }
+
         std::string line;
         std::size_t lineNumber = 0;
         while (std::getline(reader, line)) {
@@ -0,0 +1,732 @@
+/*
+fuzzylite (R), a fuzzy logic control library in C++.
+
+Copyright (C) 2010-2024 FuzzyLite Limited. All rights reserved.
+Author: Juan Rada-Vilela, PhD <jcrada@fuzzylite.com>.
+
+This file is part of fuzzylite.
+
+fuzzylite is free software: you can redistribute it and/or modify it under
+the terms of the FuzzyLite License included with the software.
+
+You should have received a copy of the FuzzyLite License along with
+fuzzylite. If not, see <https://github.com/fuzzylite/fuzzylite/>.
+
+fuzzylite is a registered trademark of FuzzyLite Limited.
+*/
+
+#include "fuzzylite/imex/NativeExporter.h"
+
+#include <algorithm>
+#include <cctype>
+#include <iomanip>
+#include <limits>
+
+#include "fuzzylite/Headers.h"
+
+namespace fuzzylite {
+
+    NativeExporter::NativeExporter(const std::string& namespaceName) : Exporter(), _namespace(namespaceName) {}
+
+    NativeExporter::~NativeExporter() {}
+
+    std::string NativeExporter::name() const {
+        return "NativeExporter";
+    }
+
+    void NativeExporter::setNamespace(const std::string& namespaceName) {
+        this->_namespace = namespaceName;
+    }
+
+    std::string NativeExporter::getNamespace() const {
+        return this->_namespace;
+    }
+
+    std::string NativeExporter::toString(const Engine* engine) const {
+        const std::string space = Op::validName(_namespace.empty() ? engine->getName() : _namespace);
+
+        // the aggregated terms are clipped (Minimum) or scaled (AlgebraicProduct) by the implication
+        std::string implication;
+        for (std::size_t b = 0; b < engine->numberOfRuleBlocks(); ++b) {
+            const RuleBlock* ruleBlock = engine->getRuleBlock(b);
+            if (not ruleBlock->isEnabled())
+                continue;
+            if (ruleBlock->getActivation() and not dynamic_cast<const General*>(ruleBlock->getActivation()))
+                throw Exception(
+                    "[exporter error] activation <" + ruleBlock->getActivation()->className()
+                        + "> is not supported in rule block <" + ruleBlock->getName() + ">",
+                    FL_AT
+                );
+            const TNorm* norm = ruleBlock->getImplication();
+            if (not(dynamic_cast<const Minimum*>(norm) or dynamic_cast<const AlgebraicProduct*>(norm)))
+                throw Exception(
+                    "[exporter error] implication <" + (norm ? norm->className() : std::string("none"))
+                        + "> is not supported in rule block <" + ruleBlock->getName() + ">",
+                    FL_AT
+                );
+            if (not implication.empty() and implication != norm->className())
+                throw Exception("[exporter error] expected the same implication in every rule block", FL_AT);
+            implication = norm->className();
+        }
+        const bool clipping = implication != AlgebraicProduct().className();
+
+        // the consequents are aggregated in the same order as in Aggregated
+        std::ostringstream rules;
+        std::set<std::pair<std::size_t, std::size_t> > memberships;
+        std::vector<std::size_t> activations(engine->numberOfOutputVariables(), 0);
+        for (std::size_t b = 0; b < engine->numberOfRuleBlocks(); ++b) {
+            const RuleBlock* ruleBlock = engine->getRuleBlock(b);
+            if (not ruleBlock->isEnabled())
+                continue;
+            rules << "\n        // RuleBlock: " << ruleBlock->getName() << "\n";
+            for (std::size_t r = 0; r < ruleBlock->numberOfRules(); ++r) {
+                const Rule* rule = ruleBlock->getRule(r);
+                // rules that are not loaded or not enabled are never triggered
+                if (not(rule->isLoaded() and rule->isEnabled()))
+                    continue;
+                std::string degree = antecedent(rule->getAntecedent()->getExpression(), engine, ruleBlock, memberships);
+                if (rule->getWeight() != 1.0)
+                    degree = toString(rule->getWeight()) + " * " + degree;
+                rules << "        // " << rule->getText() << "\n";
+                rules << "        {\n";
+                rules << "            double degree = " << degree << ";\n";
+                rules << "            if (detail::isGt(degree, 0.0)) {\n";
+                const std::vector<Proposition*>& conclusions = rule->getConsequent()->conclusions();
+                for (std::size_t c = 0; c < conclusions.size(); ++c) {
+                    const Proposition* proposition = conclusions.at(c);
+                    const OutputVariable* outputVariable = dynamic_cast<const OutputVariable*>(proposition->variable);
+                    if (not(outputVariable and outputVariable->isEnabled()))
+                        continue;
+                    const std::vector<OutputVariable*>& outputVariables = engine->outputVariables();
+                    const std::size_t o = std::distance(
+                        outputVariables.begin(),
+                        std::find(outputVariables.begin(), outputVariables.end(), outputVariable)
+                    );
+                    const std::size_t t = std::distance(
+                        outputVariable->terms().begin(),
+                        std::find(outputVariable->terms().begin(), outputVariable->terms().end(), proposition->term)
+                    );
+                    // the hedges of a conclusion also apply to the conclusions that follow (see Rule::trigger)
+                    for (std::vector<Hedge*>::const_reverse_iterator rit = proposition->hedges.rbegin();
+                         rit != proposition->hedges.rend();
+                         ++rit) {
+                        rules << "                degree = " << hedge(*rit, "degree") << ";\n";
+                    }
+                    rules << "                activations" << o << "[count" << o << "].term = " << t << ";\n";
+                    rules << "                activations" << o << "[count" << o << "++].degree = degree;\n";
+                    ++activations.at(o);
+                }
+                rules << "            }\n";
+                rules << "        }\n";
+            }
+        }
+
+        std::ostringstream cpp;
+        cpp << "//Code automatically generated with " << fuzzylite::library() << ".\n";
+        cpp << "//Standalone evaluation of engine <" << engine->getName()
+            << ">, equivalent to fl::Engine::process().\n\n";
+        std::string guard = "FL_NATIVE_" + space + "_H";
+        std::transform(guard.begin(), guard.end(), guard.begin(), ::toupper);
+        cpp << "#ifndef " << guard << "\n";
+        cpp << "#define " << guard << "\n\n";
+        cpp << "#include <algorithm>\n";
+        cpp << "#include <cmath>\n";
+        cpp << "#include <cstddef>\n";
+        cpp << "#include <limits>\n\n";
+        cpp << "namespace " << space << " {\n";
+        cpp << "    namespace detail {\n";
+        cpp << "        const double macheps = " << toString(fuzzylite::macheps()) << ";\n";
+        cpp << helpers();
+        cpp << "    }\n\n";
+
+        cpp << "    const std::size_t numberOfInputVariables = " << engine->numberOfInputVariables() << ";\n";
+        cpp << "    const std::size_t numberOfOutputVariables = " << engine->numberOfOutputVariables() << ";\n";
+        if (engine->numberOfInputVariables() > 0) {
+            std::vector<std::string> names;
+            for (std::size_t i = 0; i < engine->numberOfInputVariables(); ++i)
+                names.push_back("\"" + engine->getInputVariable(i)->getName() + "\"");
+            cpp << "    const char* const inputVariables[] = {" << Op::join(names, ", ") << "};\n";
+        }
+        if (engine->numberOfOutputVariables() > 0) {
+            std::vector<std::string> names;
+            for (std::size_t i = 0; i < engine->numberOfOutputVariables(); ++i)
+                names.push_back("\"" + engine->getOutputVariable(i)->getName() + "\"");
+            cpp << "    const char* const outputVariables[] = {" << Op::join(names, ", ") << "};\n";
+        }
+        cpp << "\n";
+
+        cpp << "    /*\n";
+        cpp << "      Processes the engine on the values of the input variables, storing the\n";
+        cpp << "      values of the output variables in `output` and their previous values in\n";
+        cpp << "      `previous`. Both `output` and `previous` must contain the values from the\n";
+        cpp << "      last call (or fl::nan initially).\n";
+        cpp << "     */\n";
+        cpp << "    inline void process(const double* input, double* output, double* previous) {\n";
+
+        cpp << "        // InputVariables\n";
+        std::set<std::size_t> inputs;
+        for (std::set<std::pair<std::size_t, std::size_t> >::const_iterator it = memberships.begin();
+             it != memberships.end();
+             ++it) {
+            inputs.insert(it->first);
+        }
+        if (inputs.empty())
+            cpp << "        (void)input;\n";
+        for (std::set<std::size_t>::const_iterator it = inputs.begin(); it != inputs.end(); ++it) {
+            const InputVariable* inputVariable = engine->getInputVariable(*it);
+            cpp << "        const double x" << *it << " = ";
+            if (inputVariable->isLockValueInRange())
+                cpp << "detail::bound(input[" << *it << "], " << toString(inputVariable->getMinimum()) << ", "
+                    << toString(inputVariable->getMaximum()) << ");\n";
+            else
+                cpp << "input[" << *it << "];\n";
+        }
+        for (std::set<std::pair<std::size_t, std::size_t> >::const_iterator it = memberships.begin();
+             it != memberships.end();
+             ++it) {
+            const std::string x = "x" + Op::str(it->first);
+            cpp << "        const double m" << it->first << "_" << it->second << " = "
+                << membership(engine->getInputVariable(it->first)->getTerm(it->second), x) << ";\n";
+        }
+
+        cpp << "\n        // OutputVariables\n";
+        for (std::size_t o = 0; o < engine->numberOfOutputVariables(); ++o) {
+            if (activations.at(o) == 0)
+                continue;
+            cpp << "        detail::Activation activations" << o << "[" << activations.at(o) << "];\n";
+            cpp << "        std::size_t count" << o << " = 0;\n";
+        }
+
+        cpp << rules.str();
+
+        for (std::size_t o = 0; o < engine->numberOfOutputVariables(); ++o) {
+            const OutputVariable* outputVariable = engine->getOutputVariable(o);
+            if (not outputVariable->isEnabled())
+                continue;
+            if (not dynamic_cast<const Maximum*>(outputVariable->fuzzyOutput()->getAggregation()))
+                throw Exception(
+                    "[exporter error] expected aggregation Maximum in output variable <" + outputVariable->getName()
+                        + ">",
+                    FL_AT
+                );
+            if (not dynamic_cast<const Centroid*>(outputVariable->getDefuzzifier()))
+                throw Exception(
+                    "[exporter error] expected defuzzifier Centroid in output variable <" + outputVariable->getName()
+                        + ">",
+                    FL_AT
+                );
+
+            cpp << "\n        // OutputVariable: " << outputVariable->getName() << "\n";
+            cpp << "        {\n";
+            if (activations.at(o) == 0) {
+                cpp << "            double value = detail::nan;\n";
+            } else {
+                std::vector<std::string> shapes;
+                for (std::size_t t = 0; t < outputVariable->numberOfTerms(); ++t)
+                    shapes.push_back(shape(outputVariable->getTerm(t)));
+                cpp << "            static const detail::Shape terms[] = {\n";
+                cpp << "                " << Op::join(shapes, ",\n                ") << "\n";
+                cpp << "            };\n";
+                cpp << "            double value = detail::centroid(terms, activations" << o << ", count" << o << ", "
+                    << (clipping ? "true" : "false") << ", " << toString(outputVariable->getMinimum()) << ", "
+                    << toString(outputVariable->getMaximum()) << ");\n";
+            }
+            if (outputVariable->isLockPreviousValue())
+                cpp << "            if (value != value)\n"
+                    << "                value = previous[" << o << "];\n";
+            if (not Op::isNaN(outputVariable->getDefaultValue()))
+                cpp << "            if (value != value)\n"
+                    << "                value = " << toString(outputVariable->getDefaultValue()) << ";\n";
+            cpp << "            previous[" << o << "] = output[" << o << "];\n";
+            if (outputVariable->isLockValueInRange())
+                cpp << "            output[" << o << "] = detail::bound(value, "
+                    << toString(outputVariable->getMinimum()) << ", " << toString(outputVariable->getMaximum())
+                    << ");\n";
+            else
+                cpp << "            output[" << o << "] = value;\n";
+            cpp << "        }\n";
+        }
+        cpp << "    }\n";
+        cpp << "}\n\n";
+        cpp << "#endif /* " << guard << " */\n";
+        return cpp.str();
+    }
+
+    std::string NativeExporter::antecedent(
+        const Expression* node,
+        const Engine* engine,
+        const RuleBlock* ruleBlock,
+        std::set<std::pair<std::size_t, std::size_t> >& memberships
+    ) const {
+        if (node->type() == Expression::Proposition) {
+            const Proposition* proposition = static_cast<const Proposition*>(node);
+            const std::vector<InputVariable*>& inputVariables = engine->inputVariables();
+            const std::vector<InputVariable*>::const_iterator variable
+                = std::find(inputVariables.begin(), inputVariables.end(), proposition->variable);
+            if (variable == inputVariables.end())
+                throw Exception(
+                    "[exporter error] expected an input variable in proposition <" + proposition->toString() + ">",
+                    FL_AT
+                );
+            if (not(*variable)->isEnabled())
+                return toString(0.0);
+
+            const std::vector<Hedge*>& hedges = proposition->hedges;
+            if (not hedges.empty() and dynamic_cast<const Any*>(hedges.back())) {
+                // the degree does not depend on the input value
+                scalar result = hedges.back()->hedge(fl::nan);
+                for (std::vector<Hedge*>::const_reverse_iterator rit = hedges.rbegin() + 1; rit != hedges.rend(); ++rit)
+                    result = (*rit)->hedge(result);
+                return toString(result);
+            }
+
+            const std::size_t i = std::distance(inputVariables.begin(), variable);
+            const std::size_t t = std::distance(
+                (*variable)->terms().begin(),
+                std::find((*variable)->terms().begin(), (*variable)->terms().end(), proposition->term)
+            );
+            memberships.insert(std::make_pair(i, t));
+            std::string result = "m" + Op::str(i) + "_" + Op::str(t);
+            for (std::vector<Hedge*>::const_reverse_iterator rit = hedges.rbegin(); rit != hedges.rend(); ++rit)
+                result = hedge(*rit, result);
+            return result;
+        }
+
+        const Operator* fuzzyOperator = static_cast<const Operator*>(node);
+        if (not(fuzzyOperator->left and fuzzyOperator->right))
+            throw Exception("[syntax error] left and right operands must exist", FL_AT);
+        const std::string left = antecedent(fuzzyOperator->left, engine, ruleBlock, memberships);
+        const std::string right = antecedent(fuzzyOperator->right, engine, ruleBlock, memberships);
+        if (fuzzyOperator->name == Rule::andKeyword()) {
+            const TNorm* conjunction = ruleBlock->getConjunction();
+            if (dynamic_cast<const Minimum*>(conjunction))
+                return "detail::min(" + left + ", " + right + ")";
+            if (dynamic_cast<const AlgebraicProduct*>(conjunction))
+                return "(" + left + " * " + right + ")";
+            throw Exception(
+                "[exporter error] conjunction <" + (conjunction ? conjunction->className() : std::string("none"))
+                    + "> is not supported in rule block <" + ruleBlock->getName() + ">",
+                FL_AT
+            );
+        }
+        if (fuzzyOperator->name == Rule::orKeyword()) {
+            const SNorm* disjunction = ruleBlock->getDisjunction();
+            if (dynamic_cast<const Maximum*>(disjunction))
+                return "detail::max(" + left + ", " + right + ")";
+            if (dynamic_cast<const AlgebraicSum*>(disjunction))
+                return "(" + left + " + " + right + " - (" + left + " * " + right + "))";
+            throw Exception(
+                "[exporter error] disjunction <" + (disjunction ? disjunction->className() : std::string("none"))
+                    + "> is not supported in rule block <" + ruleBlock->getName() + ">",
+                FL_AT
+            );
+        }
+        throw Exception("[syntax error] operator <" + fuzzyOperator->name + "> not recognized", FL_AT);
+    }
+
+    std::string NativeExporter::membership(const Term* term, const std::string& x) const {
+        std::vector<std::string> parameters(1, x);
+        std::string function;
+        if (const Triangle* triangle = dynamic_cast<const Triangle*>(term)) {
+            function = "triangle";
+            parameters.push_back(toString(triangle->getVertexA()));
+            parameters.push_back(toString(triangle->getVertexB()));
+            parameters.push_back(toString(triangle->getVertexC()));
+        } else if (const Trapezoid* trapezoid = dynamic_cast<const Trapezoid*>(term)) {
+            function = "trapezoid";
+            parameters.push_back(toString(trapezoid->getVertexA()));
+            parameters.push_back(toString(trapezoid->getVertexB()));
+            parameters.push_back(toString(trapezoid->getVertexC()));
+            parameters.push_back(toString(trapezoid->getVertexD()));
+        } else if (const Rectangle* rectangle = dynamic_cast<const Rectangle*>(term)) {
+            function = "rectangle";
+            parameters.push_back(toString(rectangle->getStart()));
+            parameters.push_back(toString(rectangle->getEnd()));
+        } else if (const Ramp* ramp = dynamic_cast<const Ramp*>(term)) {
+            function = "ramp";
+            parameters.push_back(toString(ramp->getStart()));
+            parameters.push_back(toString(ramp->getEnd()));
+        } else if (const Gaussian* gaussian = dynamic_cast<const Gaussian*>(term)) {
+            function = "gaussian";
+            parameters.push_back(toString(gaussian->getMean()));
+            parameters.push_back(toString(gaussian->getStandardDeviation()));
+        } else if (const Bell* bell = dynamic_cast<const Bell*>(term)) {
+            function = "bell";
+            parameters.push_back(toString(bell->getCenter()));
+            parameters.push_back(toString(bell->getWidth()));
+            parameters.push_back(toString(bell->getSlope()));
+        } else if (const Sigmoid* sigmoid = dynamic_cast<const Sigmoid*>(term)) {
+            function = "sigmoid";
+            parameters.push_back(toString(sigmoid->getInflection()));
+            parameters.push_back(toString(sigmoid->getSlope()));
+        } else if (const Constant* constant = dynamic_cast<const Constant*>(term)) {
+            return toString(constant->getValue());
+        } else {
+            throw Exception(
+                "[exporter error] term <" + (term ? term->toString() : std::string("null")) + "> is not supported",
+                FL_AT
+            );
+        }
+        parameters.push_back(toString(term->getHeight()));
+        return "detail::" + function + "(" + Op::join(parameters, ", ") + ")";
+    }
+
+    std::string NativeExporter::hedge(const Hedge* hedge, const std::string& x) const {
+        std::string function;
+        if (dynamic_cast<const Not*>(hedge))
+            function = "hedgeNot";
+        else if (dynamic_cast<const Very*>(hedge))
+            function = "hedgeVery";
+        else if (dynamic_cast<const Somewhat*>(hedge))
+            function = "hedgeSomewhat";
+        else if (dynamic_cast<const Extremely*>(hedge))
+            function = "hedgeExtremely";
+        else if (dynamic_cast<const Seldom*>(hedge))
+            function = "hedgeSeldom";
+        else
+            throw Exception(
+                "[exporter error] hedge <" + (hedge ? hedge->name() : std::string("null")) + "> is not supported",
+                FL_AT
+            );
+        return "detail::" + function + "(" + x + ")";
+    }
+
+    std::string NativeExporter::shape(const Term* term) const {
+        std::string kind;
+        std::vector<scalar> vertices;
+        if (const Triangle* triangle = dynamic_cast<const Triangle*>(term)) {
+            kind = "Triangle";
+            vertices.push_back(triangle->getVertexA());
+            vertices.push_back(triangle->getVertexB());
+            vertices.push_back(triangle->getVertexC());
+        } else if (const Trapezoid* trapezoid = dynamic_cast<const Trapezoid*>(term)) {
+            kind = "Trapezoid";
+            vertices.push_back(trapezoid->getVertexA());
+            vertices.push_back(trapezoid->getVertexB());
+            vertices.push_back(trapezoid->getVertexC());
+            vertices.push_back(trapezoid->getVertexD());
+        } else if (const Rectangle* rectangle = dynamic_cast<const Rectangle*>(term)) {
+            kind = "Rectangle";
+            vertices.push_back(rectangle->getStart());
+            vertices.push_back(rectangle->getEnd());
+        } else if (const Ramp* ramp = dynamic_cast<const Ramp*>(term)) {
+            if (not Op::isEq(ramp->getStart(), ramp->getEnd())) {
+                kind = "Ramp";
+                vertices.push_back(ramp->getStart());
+                vertices.push_back(ramp->getEnd());
+            }
+        }
+        bool finite = not kind.empty() and Op::isFinite(term->getHeight());
+        for (std::size_t i = 0; i < vertices.size(); ++i)
+            finite = finite and Op::isFinite(vertices.at(i));
+        if (not finite)
+            throw Exception(
+                "[exporter error] expected a piecewise linear term, but got <"
+                    + (term ? term->toString() : std::string("null")) + ">",
+                FL_AT
+            );
+
+        vertices.resize(4, 0.0);
+        std::ostringstream ss;
+        ss << "{detail::Shape::" << kind;
+        for (std::size_t i = 0; i < vertices.size(); ++i)
+            ss << ", " << toString(vertices.at(i));
+        ss << ", " << toString(term->getHeight()) << "}";
+        return ss.str();
+    }
+
+    std::string NativeExporter::toString(scalar value) const {
+        if (Op::isNaN(value))
+            return "detail::nan";
+        if (Op::isInf(value))
+            return value > 0 ? "detail::inf" : "-detail::inf";
+#ifdef FL_CPP98
+        const int digits = std::numeric_limits<scalar>::digits10 + 3;
+#else
+        const int digits = std::numeric_limits<scalar>::max_digits10;
+#endif
+        std::ostringstream ss;
+        ss << std::setprecision(digits) << value;
+        const std::string result = ss.str();
+        // ensures the value is a floating-point literal
+        if (result.find_first_of(".eE") == std::string::npos)
+            return result + ".0";
+        return result;
+    }
+
+    std::string NativeExporter::helpers() const {
+        std::ostringstream ss;
+        ss << "        const double nan = std::numeric_limits<double>::quiet_NaN();\n";
+        ss << "        const double inf = std::numeric_limits<double>::infinity();\n";
+        ss << "\n";
+        ss << "        inline bool isEq(double a, double b) {\n";
+        ss << "            return a == b or std::abs(a - b) < macheps or (a != a and b != b);\n";
+        ss << "        }\n";
+        ss << "\n";
+        ss << "        inline bool isLt(double a, double b) {\n";
+        ss << "            return not isEq(a, b) and a < b;\n";
+        ss << "        }\n";
+        ss << "\n";
+        ss << "        inline bool isGt(double a, double b) {\n";
+        ss << "            return not isEq(a, b) and a > b;\n";
+        ss << "        }\n";
+        ss << "\n";
+        ss << "        inline bool isLE(double a, double b) {\n";
+        ss << "            return isEq(a, b) or a < b;\n";
+        ss << "        }\n";
+        ss << "\n";
+        ss << "        inline bool isGE(double a, double b) {\n";
+        ss << "            return isEq(a, b) or a > b;\n";
+        ss << "        }\n";
+        ss << "\n";
+        ss << "        inline double min(double a, double b) {\n";
+        ss << "            return (a != a or b != b) ? nan : (b < a ? b : a);\n";
+        ss << "        }\n";
+        ss << "\n";
+        ss << "        inline double max(double a, double b) {\n";
+        ss << "            return (a != a or b != b) ? nan : (a < b ? b : a);\n";
+        ss << "        }\n";
+        ss << "\n";
+        ss << "        inline double bound(double x, double minimum, double maximum) {\n";
+        ss << "            return x > maximum ? maximum : (x < minimum ? minimum : x);\n";
+        ss << "        }\n";
+        ss << "\n";
+        ss << "        inline double triangle(double x, double a, double b, double c, double height) {\n";
+        ss << "            if (x != x)\n";
+        ss << "                return nan;\n";
+        ss << "            if (isLt(x, a) or isGt(x, c))\n";
+        ss << "                return height * 0.0;\n";
+        ss << "            if (isEq(x, b))\n";
+        ss << "                return height * 1.0;\n";
+        ss << "            if (isLt(x, b))\n";
+        ss << "                return a == -inf ? height * 1.0 : height * (x - a) / (b - a);\n";
+        ss << "            return c == inf ? height * 1.0 : height * (c - x) / (c - b);\n";
+        ss << "        }\n";
+        ss << "\n";
+        ss << "        inline double trapezoid(double x, double a, double b, double c, double d, double height) {\n";
+        ss << "            if (x != x)\n";
+        ss << "                return nan;\n";
+        ss << "            if (isLt(x, a) or isGt(x, d))\n";
+        ss << "                return height * 0.0;\n";
+        ss << "            if (isLt(x, b))\n";
+        ss << "                return a == -inf ? height * 1.0 : height * min(1.0, (x - a) / (b - a));\n";
+        ss << "            if (isLE(x, c))\n";
+        ss << "                return height * 1.0;\n";
+        ss << "            if (isLt(x, d))\n";
+        ss << "                return d == inf ? height * 1.0 : height * (d - x) / (d - c);\n";
+        ss << "            return d == inf ? height * 1.0 : height * 0.0;\n";
+        ss << "        }\n";
+        ss << "\n";
+        ss << "        inline double rectangle(double x, double start, double end, double height) {\n";
+        ss << "            if (x != x)\n";
+        ss << "                return nan;\n";
+        ss << "            return (isGE(x, start) and isLE(x, end)) ? height * 1.0 : height * 0.0;\n";
+        ss << "        }\n";
+        ss << "\n";
+        ss << "        inline double ramp(double x, double start, double end, double height) {\n";
+        ss << "            if (x != x or isEq(start, end))\n";
+        ss << "                return nan;\n";
+        ss << "            if (isLt(start, end)) {\n";
+        ss << "                if (isLE(x, start))\n";
+        ss << "                    return height * 0.0;\n";
+        ss << "                if (isGE(x, end))\n";
+        ss << "                    return height * 1.0;\n";
+        ss << "                return height * (x - start) / (end - start);\n";
+        ss << "            }\n";
+        ss << "            if (isGE(x, start))\n";
+        ss << "                return height * 0.0;\n";
+        ss << "            if (isLE(x, end))\n";
+        ss << "                return height * 1.0;\n";
+        ss << "            return height * (start - x) / (start - end);\n";
+        ss << "        }\n";
+        ss << "\n";
+        ss << "        inline double gaussian(double x, double mean, double deviation, double height) {\n";
+        ss << "            if (x != x)\n";
+        ss << "                return nan;\n";
+        ss << "            return height * std::exp((-(x - mean) * (x - mean)) / (2.0 * deviation * deviation));\n";
+        ss << "        }\n";
+        ss << "\n";
+        ss << "        inline double bell(double x, double center, double width, double slope, double height) {\n";
+        ss << "            if (x != x)\n";
+        ss << "                return nan;\n";
+        ss << "            return height * (1.0 / (1.0 + std::pow(std::abs((x - center) / width), 2.0 * slope)));\n";
+        ss << "        }\n";
+        ss << "\n";
+        ss << "        inline double sigmoid(double x, double inflection, double slope, double height) {\n";
+        ss << "            if (x != x)\n";
+        ss << "                return nan;\n";
+        ss << "            return height * 1.0 / (1.0 + std::exp(-slope * (x - inflection)));\n";
+        ss << "        }\n";
+        ss << "\n";
+        ss << "        inline double hedgeNot(double x) {\n";
+        ss << "            return 1.0 - x;\n";
+        ss << "        }\n";
+        ss << "\n";
+        ss << "        inline double hedgeVery(double x) {\n";
+        ss << "            return x * x;\n";
+        ss << "        }\n";
+        ss << "\n";
+        ss << "        inline double hedgeSomewhat(double x) {\n";
+        ss << "            return std::sqrt(x);\n";
+        ss << "        }\n";
+        ss << "\n";
+        ss << "        inline double hedgeExtremely(double x) {\n";
+        ss << "            return isLE(x, 0.5) ? 2.0 * x * x : (1.0 - 2.0 * (1.0 - x) * (1.0 - x));\n";
+        ss << "        }\n";
+        ss << "\n";
+        ss << "        inline double hedgeSeldom(double x) {\n";
+        ss << "            return isLE(x, 0.5) ? std::sqrt(0.5 * x) : (1.0 - std::sqrt(0.5 * (1.0 - x)));\n";
+        ss << "        }\n";
+        ss << "\n";
+        ss << "        struct Shape {\n";
+        ss << "            enum Kind { Triangle, Trapezoid, Rectangle, Ramp };\n";
+        ss << "\n";
+        ss << "            Kind kind;\n";
+        ss << "            double a, b, c, d, height;\n";
+        ss << "        };\n";
+        ss << "\n";
+        ss << "        inline double membership(const Shape& shape, double x) {\n";
+        ss << "            switch (shape.kind) {\n";
+        ss << "                case Shape::Triangle:\n";
+        ss << "                    return triangle(x, shape.a, shape.b, shape.c, shape.height);\n";
+        ss << "                case Shape::Trapezoid:\n";
+        ss << "                    return trapezoid(x, shape.a, shape.b, shape.c, shape.d, shape.height);\n";
+        ss << "                case Shape::Rectangle:\n";
+        ss << "                    return rectangle(x, shape.a, shape.b, shape.height);\n";
+        ss << "                default:\n";
+        ss << "                    return ramp(x, shape.a, shape.b, shape.height);\n";
+        ss << "            }\n";
+        ss << "        }\n";
+        ss << "\n";
+        ss << "        inline std::size_t vertices(const Shape& shape, double* result) {\n";
+        ss << "            result[0] = shape.a;\n";
+        ss << "            result[1] = shape.b;\n";
+        ss << "            result[2] = shape.c;\n";
+        ss << "            result[3] = shape.d;\n";
+        ss << "            switch (shape.kind) {\n";
+        ss << "                case Shape::Triangle:\n";
+        ss << "                    return 3;\n";
+        ss << "                case Shape::Trapezoid:\n";
+        ss << "                    return 4;\n";
+        ss << "                default:\n";
+        ss << "                    return 2;\n";
+        ss << "            }\n";
+        ss << "        }\n";
+        ss << "\n";
+        ss << "        struct Activation {\n";
+        ss << "            std::size_t term;\n";
+        ss << "            double degree;\n";
+        ss << "        };\n";
+        ss << "\n";
+        ss << "        // mirrors fl::Centroid::piecewiseLinear() on the first n activations of the terms\n";
+        ss << "        template <std::size_t N, std::size_t K>\n";
+        ss << "        inline double centroid(\n";
+        ss << "            const Shape (&terms)[N],\n";
+        ss << "            const Activation (&activations)[K],\n";
+        ss << "            std::size_t n,\n";
+        ss << "            bool clipping,\n";
+        ss << "            double minimum,\n";
+        ss << "            double maximum\n";
+        ss << "        ) {\n";
+        ss << "            if (not std::isfinite(minimum + maximum))\n";
+        ss << "                return nan;\n";
+        ss << "\n";
+        ss << "            const Shape* active[K];\n";
+        ss << "            double degree[K];\n";
+        ss << "            for (std::size_t i = 0; i < n; ++i) {\n";
+        ss << "                active[i] = &terms[activations[i].term];\n";
+        ss << "                degree[i] = activations[i].degree;\n";
+        ss << "            }\n";
+        ss << "\n";
+        ss << "            double breakpoints[2 + 4 * K + (1 + 4 * K) * K];\n";
+        ss << "            double vertex[4];\n";
+        ss << "            std::size_t size = 0;\n";
+        ss << "            breakpoints[size++] = minimum;\n";
+        ss << "            for (std::size_t i = 0; i < n; ++i) {\n";
+        ss << "                const std::size_t count = vertices(*active[i], vertex);\n";
+        ss << "                for (std::size_t v = 0; v < count; ++v) {\n";
+        ss << "                    if (vertex[v] > minimum and vertex[v] < maximum)\n";
+        ss << "                        breakpoints[size++] = vertex[v];\n";
+        ss << "                }\n";
+        ss << "            }\n";
+        ss << "            breakpoints[size++] = maximum;\n";
+        ss << "            std::sort(breakpoints, breakpoints + size);\n";
+        ss << "            size = std::unique(breakpoints, breakpoints + size) - breakpoints;\n";
+        ss << "\n";
+        ss << "            if (clipping) {\n";
+        ss << "                const std::size_t numberOfVertices = size;\n";
+        ss << "                for (std::size_t v = 0; v + 1 < numberOfVertices; ++v) {\n";
+        ss << "                    const double a = breakpoints[v], b = breakpoints[v + 1];\n";
+        ss << "                    const double x1 = a + (b - a) / 3.0, x2 = a + 2.0 * (b - a) / 3.0;\n";
+        ss << "                    for (std::size_t i = 0; i < n; ++i) {\n";
+        ss << "                        const double y1 = membership(*active[i], x1);\n";
+        ss << "                        const double y2 = membership(*active[i], x2);\n";
+        ss << "                        if (y1 == y2)\n";
+        ss << "                            continue;\n";
+        ss << "                        const double x = x1 + (degree[i] - y1) * (x2 - x1) / (y2 - y1);\n";
+        ss << "                        if (x > a and x < b)\n";
+        ss << "                            breakpoints[size++] = x;\n";
+        ss << "                    }\n";
+        ss << "                }\n";
+        ss << "                std::sort(breakpoints, breakpoints + size);\n";
+        ss << "                size = std::unique(breakpoints, breakpoints + size) - breakpoints;\n";
+        ss << "            }\n";
+        ss << "\n";
+        ss << "            double slopes[K], intercepts[K], points[2 + K * (K - 1) / 2];\n";
+        ss << "            double area = 0.0, centroid = 0.0;\n";
+        ss << "            for (std::size_t v = 0; v + 1 < size; ++v) {\n";
+        ss << "                const double a = breakpoints[v], b = breakpoints[v + 1];\n";
+        ss << "                const double x1 = a + (b - a) / 3.0, x2 = a + 2.0 * (b - a) / 3.0;\n";
+        ss << "                for (std::size_t i = 0; i < n; ++i) {\n";
+        ss << "                    const double m1 = membership(*active[i], x1), m2 = membership(*active[i], x2);\n";
+        ss << "                    const double y1 = clipping ? min(m1, degree[i]) : m1 * degree[i];\n";
+        ss << "                    const double y2 = clipping ? min(m2, degree[i]) : m2 * degree[i];\n";
+        ss << "                    slopes[i] = (y2 - y1) / (x2 - x1);\n";
+        ss << "                    intercepts[i] = y1 - slopes[i] * x1;\n";
+        ss << "                }\n";
+        ss << "\n";
+        ss << "                std::size_t numberOfPoints = 0;\n";
+        ss << "                points[numberOfPoints++] = a;\n";
+        ss << "                points[numberOfPoints++] = b;\n";
+        ss << "                for (std::size_t i = 0; i < n; ++i) {\n";
+        ss << "                    for (std::size_t j = i + 1; j < n; ++j) {\n";
+        ss << "                        if (slopes[i] == slopes[j])\n";
+        ss << "                            continue;\n";
+        ss << "                        const double x = (intercepts[j] - intercepts[i]) / (slopes[i] - slopes[j]);\n";
+        ss << "                        if (x > a and x < b)\n";
+        ss << "                            points[numberOfPoints++] = x;\n";
+        ss << "                    }\n";
+        ss << "                }\n";
+        ss << "                std::sort(points, points + numberOfPoints);\n";
+        ss << "\n";
+        ss << "                for (std::size_t p = 0; p + 1 < numberOfPoints; ++p) {\n";
+        ss << "                    const double left = points[p], right = points[p + 1];\n";
+        ss << "                    if (not(right > left))\n";
+        ss << "                        continue;\n";
+        ss << "                    const double middle = 0.5 * (left + right);\n";
+        ss << "                    double slope = 0.0, intercept = 0.0;\n";
+        ss << "                    for (std::size_t i = 0; i < n; ++i) {\n";
+        ss << "                        if (slopes[i] * middle + intercepts[i] > slope * middle + intercept) {\n";
+        ss << "                            slope = slopes[i];\n";
+        ss << "                            intercept = intercepts[i];\n";
+        ss << "                        }\n";
+        ss << "                    }\n";
+        ss << "                    const double yLeft = slope * left + intercept;\n";
+        ss << "                    const double yRight = slope * right + intercept;\n";
+        ss << "                    const double dx = right - left;\n";
+        ss << "                    area += dx * (yLeft + yRight) / 2.0;\n";
+        ss << "                    const double moment = yLeft * (2.0 * left + right)"
+              " + yRight * (left + 2.0 * right);\n";
+        ss << "                    centroid += dx * moment / 6.0;\n";
+        ss << "                }\n";
+        ss << "            }\n";
+        ss << "            return centroid / area;\n";
+        ss << "        }\n";
+        return ss.str();
+    }
+
+    NativeExporter* NativeExporter::clone() const {
+        return new NativeExporter(*this);
+    }
+
+}
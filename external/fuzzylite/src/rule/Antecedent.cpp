@@ -20,6 +20,7 @@ fuzzylite is a registered trademark of FuzzyLite Limited.
 #include <stack>
 
 #include "fuzzylite/Engine.h"
+#include "fuzzylite/Instrumentation.h"
 #include "fuzzylite/factory/FactoryManager.h"
 #include "fuzzylite/factory/HedgeFactory.h"
 #include "fuzzylite/hedge/Any.h"
@@ -84,6 +85,11 @@ namespace fuzzylite {
             scalar result = fl::nan;
             Variable::Type variableType = proposition->variable->type();
             if (variableType == Variable::Input) {
+#ifdef FL_INSTRUMENTED
+                Instrumentation::Timer timer(Instrumentation::Fuzzification);
+                if (Instrumentation* instrumentation = Instrumentation::current())
+                    instrumentation->recordMembership(proposition->term);
+#endif
                 result = proposition->term->membership(proposition->variable->getValue());
             } else if (variableType == Variable::Output) {
                 result = static_cast<OutputVariable*>(proposition->variable)
@@ -18,6 +18,7 @@ fuzzylite is a registered trademark of FuzzyLite Limited.
 #include "fuzzylite/rule/Rule.h"
 
 #include "fuzzylite/Exception.h"
+#include "fuzzylite/Instrumentation.h"
 #include "fuzzylite/Operation.h"
 #include "fuzzylite/imex/FllExporter.h"
 #include "fuzzylite/norm/Norm.h"
@@ -126,6 +127,9 @@ namespace fuzzylite {
             throw Exception("[rule error] the following rule is not loaded: " + getText(), FL_AT);
         if (isEnabled() and Op::isGt(getActivationDegree(), 0.0)) {
             FL_DBG("[firing with " << Op::str(getActivationDegree()) << "] " << toString());
+#ifdef FL_INSTRUMENTED
+            Instrumentation::Timer timer(Instrumentation::Aggregation);
+#endif
             getConsequent()->modify(getActivationDegree(), implication);
             setTriggered(true);
         }
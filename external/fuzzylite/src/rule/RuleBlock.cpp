@@ -17,12 +17,18 @@ fuzzylite is a registered trademark of FuzzyLite Limited.
 
 #include "fuzzylite/rule/RuleBlock.h"
 
+#include <map>
+
 #include "fuzzylite/Operation.h"
 #include "fuzzylite/activation/General.h"
 #include "fuzzylite/imex/FllExporter.h"
 #include "fuzzylite/norm/SNorm.h"
 #include "fuzzylite/norm/TNorm.h"
+#include "fuzzylite/rule/Consequent.h"
+#include "fuzzylite/rule/Expression.h"
 #include "fuzzylite/rule/Rule.h"
+#include "fuzzylite/term/Aggregated.h"
+#include "fuzzylite/variable/OutputVariable.h"
 
 namespace fuzzylite {
 
@@ -100,17 +106,25 @@ namespace fuzzylite {
     void RuleBlock::loadRules(const Engine* engine) {
         std::ostringstream exceptions;
         bool throwException = false;
+        std::map<OutputVariable*, std::size_t> conclusions;
         for (std::size_t i = 0; i < _rules.size(); ++i) {
             Rule* rule = _rules.at(i);
             if (rule->isLoaded())
                 rule->unload();
             try {
                 rule->load(engine);
+                const std::vector<Proposition*>& propositions = rule->getConsequent()->conclusions();
+                for (std::size_t c = 0; c < propositions.size(); ++c)
+                    ++conclusions[static_cast<OutputVariable*>(propositions.at(c)->variable)];
             } catch (std::exception& ex) {
                 throwException = true;
                 exceptions << ex.what() << "\n";
             }
         }
+        // the fuzzy outputs can hold the conclusions of the rules without allocating memory
+        std::map<OutputVariable*, std::size_t>::const_iterator it;
+        for (it = conclusions.begin(); it != conclusions.end(); ++it)
+            it->first->fuzzyOutput()->reserve(it->second);
         if (throwException) {
             Exception exception(
                 "[ruleblock error] the following "
@@ -17,6 +17,7 @@ fuzzylite is a registered trademark of FuzzyLite Limited.
 
 #include "fuzzylite/term/Activated.h"
 
+#include "fuzzylite/Instrumentation.h"
 #include "fuzzylite/imex/FllExporter.h"
 
 namespace fuzzylite {
@@ -52,6 +53,10 @@ namespace fuzzylite {
                     + getTerm()->toString(),
                 FL_AT
             );
+#ifdef FL_INSTRUMENTED
+        if (Instrumentation* instrumentation = Instrumentation::current())
+            instrumentation->recordMembership(_term);
+#endif
         return _implication->compute(_term->membership(x), _height);
     }
 
@@ -56,6 +56,7 @@ namespace fuzzylite {
         if (source._aggregation.get())
             _aggregation.reset(source._aggregation->clone());
 
+        _terms.reserve(source._terms.capacity());
         for (std::size_t i = 0; i < source._terms.size(); ++i)
             _terms.push_back(source._terms.at(i));
     }
@@ -247,6 +248,20 @@ namespace fuzzylite {
         _terms.clear();
     }
 
+    void Aggregated::reserve(std::size_t terms) {
+        _terms.reserve(terms);
+    }
+
+    std::size_t Aggregated::capacity() const {
+        return _terms.capacity();
+    }
+
+    std::vector<scalar>& Aggregated::workspace(std::size_t index) const {
+        if (index >= WorkspaceBuffers)
+            throw Exception("[aggregated error] workspace buffer <" + Op::str(index) + "> does not exist", FL_AT);
+        return _workspace[index];
+    }
+
     const Activated& Aggregated::getTerm(std::size_t index) const {
         return _terms.at(index);
     }
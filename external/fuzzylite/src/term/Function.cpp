@@ -350,7 +350,8 @@ namespace fuzzylite {
         Term(other),
         _root(fl::null),
         _formula(other._formula),
-        _engine(other._engine) {
+        _engine(other._engine),
+        _program(other._program) {
         if (other._root.get())
             _root.reset(other._root->clone());
         variables = other.variables;
@@ -363,6 +364,7 @@ namespace fuzzylite {
             Term::operator=(other);
             _formula = other._formula;
             _engine = other._engine;
+            _program = other._program;
             if (other._root.get())
                 _root.reset(other._root->clone());
             variables = other.variables;
@@ -379,6 +381,35 @@ namespace fuzzylite {
     scalar Function::membership(scalar x) const {
         if (not _root.get())
             throw Exception("[function error] function <" + _formula + "> not loaded.", FL_AT);
+        if (not _program.empty()) {
+            scalar stack[MaximumStackSize];
+            std::size_t size = 0;
+            for (std::size_t i = 0; i < _program.size(); ++i) {
+                const Instruction& instruction = _program[i];
+                switch (instruction.code) {
+                    case Instruction::Constant:
+                        stack[size++] = instruction.constant;
+                        break;
+                    case Instruction::Argument:
+                        stack[size++] = x;
+                        break;
+                    case Instruction::InputValue:
+                        stack[size++] = _engine->getInputVariable(instruction.index)->getValue();
+                        break;
+                    case Instruction::OutputValue:
+                        stack[size++] = _engine->getOutputVariable(instruction.index)->getValue();
+                        break;
+                    case Instruction::UnaryCall:
+                        stack[size - 1] = instruction.unary(stack[size - 1]);
+                        break;
+                    case Instruction::BinaryCall:
+                        --size;
+                        stack[size - 1] = instruction.binary(stack[size - 1], stack[size]);
+                        break;
+                }
+            }
+            return stack[0];
+        }
         if (_engine) {
             for (std::size_t i = 0; i < _engine->numberOfInputVariables(); ++i) {
                 InputVariable* input = _engine->getInputVariable(i);
@@ -426,8 +457,17 @@ namespace fuzzylite {
         return this->_root.get() != fl::null;
     }
 
+    bool Function::isCompiled() const {
+        return not this->_program.empty();
+    }
+
+    const std::vector<Function::Instruction>& Function::program() const {
+        return this->_program;
+    }
+
     void Function::unload() {
         this->_root.reset(fl::null);
+        this->_program.clear();
         this->variables.clear();
     }
 
@@ -443,6 +483,7 @@ namespace fuzzylite {
         setFormula(formula);
         setEngine(engine);
         this->_root.reset(parse(formula));
+        compile();
         // TODO: Remove execution of membership because it does not allow to pass variables different from x
         membership(0.0);  // make sure function evaluates without throwing exception.
     }
@@ -457,6 +498,70 @@ namespace fuzzylite {
 
     void Function::setEngine(const Engine* engine) {
         this->_engine = engine;
+        // the program is bound to the variables of the engine
+        this->_program.clear();
+    }
+
+    void Function::compile() {
+        _program.clear();
+        if (_root.get() and not compile(_root.get(), 1))
+            _program.clear();
+    }
+
+    bool Function::compile(const Node* node, std::size_t depth) {
+        // mirrors Function::Node::evaluate(), the nodes that would throw exceptions are not compiled
+        if (depth > MaximumStackSize)
+            return false;
+
+        Instruction instruction;
+        instruction.code = Instruction::Constant;
+        instruction.constant = fl::nan;
+        instruction.index = 0;
+        instruction.unary = fl::null;
+        instruction.binary = fl::null;
+        if (node->element.get()) {
+            if (node->element->unary) {
+                const Node* operand = node->left.get() ? node->left.get() : node->right.get();
+                if (not(operand and compile(operand, depth)))
+                    return false;
+                instruction.code = Instruction::UnaryCall;
+                instruction.unary = node->element->unary;
+            } else if (node->element->binary) {
+                if (not(node->left.get() and node->right.get()))
+                    return false;
+                if (not(compile(node->left.get(), depth) and compile(node->right.get(), depth + 1)))
+                    return false;
+                instruction.code = Instruction::BinaryCall;
+                instruction.binary = node->element->binary;
+            } else {
+                return false;
+            }
+        } else if (not node->variable.empty()) {
+            // same precedence as in Function::membership(): x, output variables, input variables (last ones first)
+            bool bound = node->variable == "x";
+            instruction.code = Instruction::Argument;
+            for (std::size_t i = _engine ? _engine->numberOfOutputVariables() : 0; not bound and i-- > 0;) {
+                if (_engine->getOutputVariable(i)->getName() == node->variable) {
+                    instruction.code = Instruction::OutputValue;
+                    instruction.index = i;
+                    bound = true;
+                }
+            }
+            for (std::size_t i = _engine ? _engine->numberOfInputVariables() : 0; not bound and i-- > 0;) {
+                if (_engine->getInputVariable(i)->getName() == node->variable) {
+                    instruction.code = Instruction::InputValue;
+                    instruction.index = i;
+                    bound = true;
+                }
+            }
+            // other variables are only available in the map of variables
+            if (not bound)
+                return false;
+        } else {
+            instruction.constant = node->constant;
+        }
+        _program.push_back(instruction);
+        return true;
     }
 
     const Engine* Function::getEngine() const {
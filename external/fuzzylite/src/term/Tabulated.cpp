@@ -0,0 +1,259 @@
+/*
+fuzzylite (R), a fuzzy logic control library in C++.
+
+Copyright (C) 2010-2024 FuzzyLite Limited. All rights reserved.
+Author: Juan Rada-Vilela, PhD <jcrada@fuzzylite.com>.
+
+This file is part of fuzzylite.
+
+fuzzylite is free software: you can redistribute it and/or modify it under
+the terms of the FuzzyLite License included with the software.
+
+You should have received a copy of the FuzzyLite License along with
+fuzzylite. If not, see <https://github.com/fuzzylite/fuzzylite/>.
+
+fuzzylite is a registered trademark of FuzzyLite Limited.
+*/
+
+#include "fuzzylite/term/Tabulated.h"
+
+#include "fuzzylite/factory/FactoryManager.h"
+#include "fuzzylite/term/Bell.h"
+#include "fuzzylite/term/Cosine.h"
+#include "fuzzylite/term/Discrete.h"
+#include "fuzzylite/term/Function.h"
+#include "fuzzylite/term/Gaussian.h"
+#include "fuzzylite/term/GaussianProduct.h"
+#include "fuzzylite/term/PiShape.h"
+#include "fuzzylite/term/Sigmoid.h"
+#include "fuzzylite/term/SigmoidDifference.h"
+#include "fuzzylite/term/SigmoidProduct.h"
+
+namespace fuzzylite {
+
+    Tabulated::Tabulated(const std::string& name, Term* term, scalar minimum, scalar maximum, int resolution) :
+        Term(name),
+        _term(term),
+        _minimum(minimum),
+        _maximum(maximum),
+        _resolution(resolution),
+        _error(fl::nan) {
+        tabulate();
+    }
+
+    Tabulated::Tabulated(const Tabulated& other) : Term(other) {
+        copyFrom(other);
+    }
+
+    Tabulated& Tabulated::operator=(const Tabulated& other) {
+        if (this != &other) {
+            _term.reset(fl::null);
+
+            Term::operator=(other);
+            copyFrom(other);
+        }
+        return *this;
+    }
+
+    Tabulated::~Tabulated() {}
+
+    void Tabulated::copyFrom(const Tabulated& source) {
+        if (source._term.get())
+            _term.reset(source._term->clone());
+        _minimum = source._minimum;
+        _maximum = source._maximum;
+        _resolution = source._resolution;
+        // the table is shared with the source
+        _table = source._table;
+        _error = source._error;
+    }
+
+    std::string Tabulated::className() const {
+        return "Tabulated";
+    }
+
+    std::string Tabulated::parameters() const {
+        std::ostringstream ss;
+        ss << _resolution << " " << Op::str(_minimum) << " " << Op::str(_maximum);
+        if (_term.get()) {
+            ss << " " << _term->className();
+            const std::string parameters = _term->parameters();
+            if (not parameters.empty())
+                ss << " " << parameters;
+        }
+        return ss.str();
+    }
+
+    void Tabulated::configure(const std::string& parameters) {
+        if (parameters.empty())
+            return;
+        std::vector<std::string> values = Op::split(parameters, " ");
+        std::size_t required = 4;
+        if (values.size() < required) {
+            std::ostringstream ex;
+            ex << "[configuration error] term <" << className() << ">" << " requires <" << required << "> parameters";
+            throw Exception(ex.str(), FL_AT);
+        }
+        FL_unique_ptr<Term> term(FactoryManager::instance()->term()->constructObject(values.at(3)));
+        term->setName(getName());
+        term->configure(Op::join(std::vector<std::string>(values.begin() + required, values.end()), " "));
+
+        _term.reset(term.release());
+        _resolution = (int)Op::toScalar(values.at(0));
+        _minimum = Op::toScalar(values.at(1));
+        _maximum = Op::toScalar(values.at(2));
+        tabulate();
+    }
+
+    const std::vector<scalar>& Tabulated::table() const {
+#ifdef FL_CPP98
+        return _table;
+#else
+        return *_table;
+#endif
+    }
+
+    scalar Tabulated::membership(scalar x) const {
+        if (Op::isNaN(x))
+            return fl::nan;
+        if (not isTabulated() or x < _minimum or x > _maximum) {
+            if (not _term.get())
+                throw Exception("[tabulated error] expected a term to tabulate, but got null", FL_AT);
+            return _term->membership(x);
+        }
+        const std::vector<scalar>& values = table();
+        const scalar position = (x - _minimum) / (_maximum - _minimum) * _resolution;
+        const std::size_t index = std::min(static_cast<std::size_t>(position), values.size() - 2);
+        const scalar fraction = position - index;
+        return values[index] + fraction * (values[index + 1] - values[index]);
+    }
+
+    void Tabulated::updateReference(const Engine* engine) {
+        if (_term.get()) {
+            _term->updateReference(engine);
+            if (not isTabulated())
+                tabulate();
+        }
+    }
+
+    void Tabulated::tabulate() {
+        _error = fl::nan;
+#ifdef FL_CPP98
+        _table.clear();
+#else
+        _table.reset();
+#endif
+        if (not _term.get() or _resolution < 1 or not Op::isFinite(_minimum) or not Op::isFinite(_maximum)
+            or not(_minimum < _maximum))
+            return;
+
+        const scalar dx = (_maximum - _minimum) / _resolution;
+        std::vector<scalar> values(_resolution + 1);
+        for (int i = 0; i < _resolution; ++i)
+            values.at(i) = _term->membership(_minimum + i * dx);
+        values.back() = _term->membership(_maximum);
+
+        scalar error = 0.0;
+        for (int i = 0; i < _resolution; ++i) {
+            for (int k = 1; k <= 3; ++k) {
+                const scalar fraction = k / 4.0;
+                const scalar approximation = values.at(i) + fraction * (values.at(i + 1) - values.at(i));
+                const scalar difference = std::abs(_term->membership(_minimum + (i + fraction) * dx) - approximation);
+                // the error remains nan once any difference is nan
+                if (Op::isNaN(difference) or difference > error)
+                    error = difference;
+            }
+        }
+        _error = error;
+#ifdef FL_CPP98
+        _table.swap(values);
+#else
+        _table.reset(new std::vector<scalar>(values));
+#endif
+    }
+
+    void Tabulated::setTerm(Term* term) {
+        _term.reset(term);
+        tabulate();
+    }
+
+    Term* Tabulated::getTerm() const {
+        return _term.get();
+    }
+
+    void Tabulated::setRange(scalar minimum, scalar maximum) {
+        _minimum = minimum;
+        _maximum = maximum;
+        tabulate();
+    }
+
+    scalar Tabulated::getMinimum() const {
+        return _minimum;
+    }
+
+    scalar Tabulated::getMaximum() const {
+        return _maximum;
+    }
+
+    void Tabulated::setResolution(int resolution) {
+        _resolution = resolution;
+        tabulate();
+    }
+
+    int Tabulated::getResolution() const {
+        return _resolution;
+    }
+
+    scalar Tabulated::getError() const {
+        return _error;
+    }
+
+    bool Tabulated::isTabulated() const {
+#ifdef FL_CPP98
+        return not _table.empty();
+#else
+        return _table.get() and not _table->empty();
+#endif
+    }
+
+    bool Tabulated::sharesTable(const Tabulated& other) const {
+#ifdef FL_CPP98
+        (void)other;
+        return false;
+#else
+        return isTabulated() and _table == other._table;
+#endif
+    }
+
+    bool Tabulated::isExpensive(const Term* term) {
+        if (const Function* function = dynamic_cast<const Function*>(term)) {
+            if (not function->isCompiled())
+                return false;
+            const std::vector<Function::Instruction>& program = function->program();
+            for (std::size_t i = 0; i < program.size(); ++i) {
+                if (program.at(i).code == Function::Instruction::InputValue
+                    or program.at(i).code == Function::Instruction::OutputValue)
+                    return false;
+            }
+            return true;
+        }
+        return dynamic_cast<const Bell*>(term) or dynamic_cast<const Cosine*>(term)
+               or dynamic_cast<const Discrete*>(term) or dynamic_cast<const Gaussian*>(term)
+               or dynamic_cast<const GaussianProduct*>(term) or dynamic_cast<const PiShape*>(term)
+               or dynamic_cast<const Sigmoid*>(term) or dynamic_cast<const SigmoidDifference*>(term)
+               or dynamic_cast<const SigmoidProduct*>(term);
+    }
+
+    int Tabulated::defaultResolution() {
+        return 1000;
+    }
+
+    Tabulated* Tabulated::clone() const {
+        return new Tabulated(*this);
+    }
+
+    Term* Tabulated::constructor() {
+        return new Tabulated;
+    }
+
+}
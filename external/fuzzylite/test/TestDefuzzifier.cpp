@@ -210,6 +210,59 @@ namespace fuzzylite { namespace test {
         DefuzzifierAssert<Centroid>().defuzzifies(-1, 1, {{new NaN(), nan}});
     }
 
+    TEST_CASE("Centroid of piecewise linear terms", "[defuzzifier][centroid]") {
+        FL_unique_ptr<Minimum> minimum(new Minimum());
+        FL_unique_ptr<AlgebraicProduct> algebraicProduct(new AlgebraicProduct());
+        FL_unique_ptr<Ramp> low(new Ramp("low", 0.5, 0.0));
+        FL_unique_ptr<Triangle> medium(new Triangle("medium", 0.0, 0.5, 1.0));
+        FL_unique_ptr<Ramp> high(new Ramp("high", 0.5, 1.0));
+        FL_unique_ptr<Trapezoid> wide(new Trapezoid("wide", 0.1, 0.3, 0.6, 0.9));
+        FL_unique_ptr<Rectangle> block(new Rectangle("block", 0.65, 0.8));
+        FL_unique_ptr<Gaussian> smooth(new Gaussian("smooth", 0.5, 0.2));
+
+        const auto midpoint = [](const Term* term, scalar minimum, scalar maximum) {
+            const int resolution = 1000000;
+            const scalar dx = (maximum - minimum) / resolution;
+            scalar area = 0.0, centroid = 0.0;
+            for (int i = 0; i < resolution; ++i) {
+                const scalar x = minimum + (i + 0.5) * dx;
+                const scalar y = term->membership(x);
+                centroid += y * x;
+                area += y;
+            }
+            return centroid / area;
+        };
+
+        const std::vector<std::vector<Activated> > aggregations = {
+            {Activated(low.get(), 0.3, minimum.get()), Activated(high.get(), 0.7, minimum.get())},
+            {Activated(low.get(), 0.3, algebraicProduct.get()),
+             Activated(medium.get(), 0.9, algebraicProduct.get()),
+             Activated(high.get(), 0.6, algebraicProduct.get())},
+            {Activated(medium.get(), 0.4, minimum.get()),
+             Activated(wide.get(), 0.8, algebraicProduct.get()),
+             Activated(block.get(), 0.5, minimum.get())},
+            {Activated(high.get(), 0.2, minimum.get()), Activated(high.get(), 0.9, minimum.get())},
+        };
+        Centroid centroid(100);
+        for (const std::vector<Activated>& terms : aggregations) {
+            Aggregated aggregated("", 0.0, 1.0, new Maximum, terms);
+            CAPTURE(aggregated.toString());
+            CHECK(Centroid::isPiecewiseLinear(&aggregated));
+            CHECK_THAT(centroid.defuzzify(&aggregated, 0.0, 1.0), Approximates(midpoint(&aggregated, 0.0, 1.0)));
+            CHECK_THAT(centroid.defuzzify(&aggregated, 0.25, 0.75), Approximates(midpoint(&aggregated, 0.25, 0.75)));
+        }
+
+        Aggregated empty("", 0.0, 1.0, new Maximum);
+        CHECK(Centroid::isPiecewiseLinear(&empty));
+        CHECK(Op::isNaN(centroid.defuzzify(&empty, 0.0, 1.0)));
+
+        Aggregated unbounded("", 0.0, 1.0, new UnboundedSum, {Activated(medium.get(), 0.5, minimum.get())});
+        CHECK_FALSE(Centroid::isPiecewiseLinear(&unbounded));
+        Aggregated gaussian("", 0.0, 1.0, new Maximum, {Activated(smooth.get(), 0.5, minimum.get())});
+        CHECK_FALSE(Centroid::isPiecewiseLinear(&gaussian));
+        CHECK_FALSE(Centroid::isPiecewiseLinear(medium.get()));
+    }
+
     TEST_CASE("SmallestOfMaximum", "[defuzzifier][som]") {
         SECTION("SmallestOfMaximum") {
             DefuzzifierAssert<SmallestOfMaximum>()
@@ -0,0 +1,522 @@
+/*
+fuzzylite (R), a fuzzy logic control library in C++.
+
+Copyright (C) 2010-2024 FuzzyLite Limited. All rights reserved.
+Author: Juan Rada-Vilela, PhD <jcrada@fuzzylite.com>.
+
+This file is part of fuzzylite.
+
+fuzzylite is free software: you can redistribute it and/or modify it under
+the terms of the FuzzyLite License included with the software.
+
+You should have received a copy of the FuzzyLite License along with
+fuzzylite. If not, see <https://github.com/fuzzylite/fuzzylite/>.
+
+fuzzylite is a registered trademark of FuzzyLite Limited.
+*/
+
+#include <chrono>
+#include <thread>
+
+#include "Headers.h"
+
+namespace fuzzylite { namespace test {
+
+    static std::string tipper() {
+        return R""(Engine: tipper
+InputVariable: service
+  enabled: true
+  range: 0.000 10.000
+  lock-range: true
+  term: poor Gaussian 0.000 1.500
+  term: good Gaussian 5.000 1.500
+  term: excellent Gaussian 10.000 1.500
+InputVariable: food
+  enabled: true
+  range: 0.000 10.000
+  lock-range: false
+  term: rancid Trapezoid 0.000 0.000 1.000 3.000
+  term: delicious Trapezoid 7.000 9.000 10.000 10.000
+OutputVariable: tip
+  enabled: true
+  range: 0.000 30.000
+  lock-range: false
+  aggregation: Maximum
+  defuzzifier: Centroid 200
+  default: nan
+  lock-previous: false
+  term: cheap Triangle 0.000 5.000 10.000
+  term: average Triangle 10.000 15.000 20.000
+  term: generous Triangle 20.000 25.000 30.000
+OutputVariable: mood
+  enabled: true
+  range: 0.000 1.000
+  lock-range: false
+  aggregation: Maximum
+  defuzzifier: Centroid 100
+  default: 0.500
+  lock-previous: true
+  term: bad Ramp 1.000 0.000
+  term: great Ramp 0.000 1.000
+RuleBlock: mamdani
+  enabled: true
+  conjunction: Minimum
+  disjunction: Maximum
+  implication: AlgebraicProduct
+  activation: General
+  rule: if service is poor or food is rancid then tip is cheap
+  rule: if service is good then tip is average
+  rule: if service is excellent or food is delicious then tip is generous and mood is very great
+  rule: if service is not poor and food is somewhat delicious then mood is great with 0.5
+  rule: if tip is generous and food is any then mood is great
+)"";
+    }
+
+    TEST_CASE("Engine processes states equivalent to itself", "[engine][state]") {
+        FL_unique_ptr<Engine> engine(FllImporter().fromString(tipper()));
+        FL_unique_ptr<Engine> expected(engine->clone());
+        const std::string fll = engine->toString();
+
+        EngineState state(engine.get());
+        for (int service = -2; service <= 12; ++service) {
+            for (int food = 0; food <= 10; food += 2) {
+                expected->getInputVariable(0)->setValue(service);
+                expected->getInputVariable(1)->setValue(food);
+                expected->process();
+
+                state.setInputValue(0, service);
+                state.setInputValue(1, food);
+                engine->process(state);
+
+                CAPTURE(service, food);
+                CHECK_THAT(state.getInputValue(0), Approximates(expected->getInputVariable(0)->getValue()));
+                for (std::size_t i = 0; i < expected->numberOfOutputVariables(); ++i) {
+                    const OutputVariable* outputVariable = expected->getOutputVariable(i);
+                    CHECK_THAT(state.getOutputValue(i), Approximates(outputVariable->getValue()));
+                    CHECK_THAT(state.getPreviousOutputValue(i), Approximates(outputVariable->getPreviousValue()));
+                    CHECK(state.fuzzyOutput(i)->toString() == outputVariable->fuzzyOutput()->toString());
+                }
+                for (std::size_t r = 0; r < expected->getRuleBlock(0)->numberOfRules(); ++r)
+                    CHECK_THAT(
+                        state.getActivationDegree(0, r),
+                        Approximates(expected->getRuleBlock(0)->getRule(r)->getActivationDegree())
+                    );
+            }
+        }
+        // the engine is not modified
+        CHECK(engine->toString() == fll);
+        CHECK(Op::isNaN(engine->getOutputVariable(0)->getValue()));
+    }
+
+    TEST_CASE("Engine states are independent of each other", "[engine][state]") {
+        FL_unique_ptr<Engine> engine(FllImporter().fromString(tipper()));
+        EngineState a(engine.get());
+        a.setInputValue(0, 2.0);
+        a.setInputValue(1, 8.0);
+        engine->process(a);
+
+        EngineState b(a);
+        b.setInputValue(0, 9.0);
+        engine->process(b);
+        CHECK(a.getInputValue(0) == 2.0);
+        CHECK(b.getPreviousOutputValue(0) == a.getOutputValue(0));
+        CHECK_FALSE(a.getOutputValue(0) == b.getOutputValue(0));
+
+        b.restart();
+        CHECK(Op::isNaN(b.getInputValue(0)));
+        CHECK(Op::isNaN(b.getOutputValue(0)));
+        CHECK(b.fuzzyOutput(0)->isEmpty());
+        CHECK_FALSE(a.fuzzyOutput(0)->isEmpty());
+
+        FL_unique_ptr<Engine> other(engine->clone());
+        CHECK_THROWS_AS(other->process(a), fl::Exception);
+    }
+
+    TEST_CASE("Engine states skip rules whose antecedents are zero", "[engine][state]") {
+        FL_unique_ptr<Engine> engine(FllImporter().fromString(tipper()));
+        FL_unique_ptr<Engine> expected(engine->clone());
+        EngineState state(engine.get());
+        // the food is neither rancid nor delicious, so the conjunction of rule 4 is zero
+        const scalar values[][2] = {{0.0, 5.0}, {0.0, 5.0}, {5.0, 5.0}, {5.0, 9.0}, {10.0, 5.0}, {5.0, 5.0}};
+        for (std::size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i) {
+            expected->getInputVariable(0)->setValue(values[i][0]);
+            expected->getInputVariable(1)->setValue(values[i][1]);
+            expected->process();
+
+            state.setInputValue(0, values[i][0]);
+            state.setInputValue(1, values[i][1]);
+            engine->process(state);
+
+            CAPTURE(i);
+            for (std::size_t o = 0; o < expected->numberOfOutputVariables(); ++o)
+                CHECK_THAT(state.getOutputValue(o), Approximates(expected->getOutputVariable(o)->getValue()));
+            for (std::size_t r = 0; r < expected->getRuleBlock(0)->numberOfRules(); ++r)
+                CHECK_THAT(
+                    state.getActivationDegree(0, r),
+                    Approximates(expected->getRuleBlock(0)->getRule(r)->getActivationDegree())
+                );
+        }
+        CHECK(state.getActivationDegree(0, 3) == 0.0);
+
+        // propositions of nan are not assumed to be zero
+        state.setInputValue(1, fl::nan);
+        engine->process(state);
+        CHECK(Op::isNaN(state.getActivationDegree(0, 3)));
+
+        // zero is not absorbing for every formula, so the rules are evaluated
+        engine->getRuleBlock(0)->setConjunction(new TNormFunction("a + b"));
+        expected->getRuleBlock(0)->setConjunction(new TNormFunction("a + b"));
+        EngineState formula(engine.get());
+        expected->setInputValue("service", 0.0);
+        expected->setInputValue("food", 9.0);
+        expected->process();
+        formula.setInputValue(0, 0.0);
+        formula.setInputValue(1, 9.0);
+        engine->process(formula);
+        CHECK(expected->getRuleBlock(0)->getRule(3)->getActivationDegree() > 0.0);
+        CHECK_THAT(
+            formula.getActivationDegree(0, 3),
+            Approximates(expected->getRuleBlock(0)->getRule(3)->getActivationDegree())
+        );
+    }
+
+    TEST_CASE("Engine updates states equivalent to processing them", "[engine][state][update]") {
+        // rule 4 contains an output variable, so the state is always updated in full
+        for (int outputDependent = 1; outputDependent >= 0; --outputDependent) {
+            FL_unique_ptr<Engine> engine(FllImporter().fromString(tipper()));
+            if (not outputDependent)
+                delete engine->getRuleBlock(0)->removeRule(4);
+            EngineState expected(engine.get()), state(engine.get());
+            CHECK_THROWS_AS(FL_unique_ptr<Engine>(engine->clone())->update(state), fl::Exception);
+
+            // only one input changes at a time
+            const scalar values[][2] = {
+                {0.0, 5.0}, {0.0, 5.0}, {3.0, 5.0}, {3.0, 9.0}, {3.0, fl::nan}, {12.0, 9.0}, {12.0, 1.0}, {5.0, 1.0}
+            };
+            for (std::size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i) {
+                expected.setInputValue(0, values[i][0]);
+                expected.setInputValue(1, values[i][1]);
+                engine->process(expected);
+
+                state.setInputValue(0, values[i][0]);
+                state.setInputValue(1, values[i][1]);
+                engine->update(state);
+
+                CAPTURE(outputDependent, i);
+                for (std::size_t o = 0; o < engine->numberOfOutputVariables(); ++o) {
+                    CHECK_THAT(state.getOutputValue(o), Approximates(expected.getOutputValue(o)));
+                    CHECK_THAT(state.getPreviousOutputValue(o), Approximates(expected.getPreviousOutputValue(o)));
+                    CHECK(state.fuzzyOutput(o)->toString() == expected.fuzzyOutput(o)->toString());
+                }
+                for (std::size_t r = 0; r < engine->getRuleBlock(0)->numberOfRules(); ++r)
+                    CHECK_THAT(state.getActivationDegree(0, r), Approximates(expected.getActivationDegree(0, r)));
+            }
+
+            // updates after processing and restarting are computed in full
+            engine->process(state);
+            engine->process(expected);
+            state.setInputValue(0, 7.0);
+            engine->update(state);
+            expected.setInputValue(0, 7.0);
+            engine->process(expected);
+            CHECK_THAT(state.getOutputValue(0), Approximates(expected.getOutputValue(0)));
+            CHECK_THAT(state.getPreviousOutputValue(0), Approximates(expected.getPreviousOutputValue(0)));
+
+            state.restart();
+            expected.restart();
+            state.setInputValue(0, 7.0);
+            state.setInputValue(1, 7.0);
+            engine->update(state);
+            expected.setInputValue(0, 7.0);
+            expected.setInputValue(1, 7.0);
+            engine->process(expected);
+            CHECK_THAT(state.getOutputValue(0), Approximates(expected.getOutputValue(0)));
+            CHECK_THAT(state.getOutputValue(1), Approximates(expected.getOutputValue(1)));
+        }
+    }
+
+    TEST_CASE("Engine reserves the fuzzy outputs for the conclusions of the rules", "[engine][state]") {
+        // the rule blocks of a clone load their rules at once
+        FL_unique_ptr<Engine> imported(FllImporter().fromString(tipper()));
+        FL_unique_ptr<Engine> engine(imported->clone());
+        EngineState state(engine.get());
+        // tip and mood are concluded by three rules each
+        for (std::size_t i = 0; i < engine->numberOfOutputVariables(); ++i) {
+            CHECK(engine->getOutputVariable(i)->fuzzyOutput()->capacity() >= 3);
+            CHECK(state.fuzzyOutput(i)->capacity() >= 3);
+        }
+
+        engine->getInputVariable(0)->setValue(6.0);
+        engine->getInputVariable(1)->setValue(8.0);
+        engine->process();
+        state.setInputValue(0, 6.0);
+        state.setInputValue(1, 8.0);
+        engine->process(state);
+        const std::size_t capacity = state.fuzzyOutput(0)->capacity();
+        const scalar value = state.getOutputValue(0);
+
+        // the storage of the fuzzy outputs and the workspace of the defuzzifier are reused
+        state.restart();
+        CHECK(state.fuzzyOutput(0)->capacity() == capacity);
+        CHECK_FALSE(state.fuzzyOutput(0)->workspace(0).empty());
+        state.setInputValue(0, 6.0);
+        state.setInputValue(1, 8.0);
+        engine->process(state);
+        CHECK(state.fuzzyOutput(0)->capacity() == capacity);
+        CHECK(state.getOutputValue(0) == value);
+        CHECK_THAT(engine->getOutputVariable(0)->getValue(), Approximates(value));
+
+        EngineState copy(state);
+        CHECK(copy.fuzzyOutput(0)->capacity() >= state.fuzzyOutput(0)->numberOfTerms());
+        CHECK(copy.fuzzyOutput(0)->workspace(0).empty());
+        CHECK_THROWS_AS(copy.fuzzyOutput(0)->workspace(Aggregated::WorkspaceBuffers), fl::Exception);
+    }
+
+    TEST_CASE("Engine tabulates the terms that are expensive to compute", "[engine][tabulated]") {
+        FL_unique_ptr<Engine> engine(FllImporter().fromString(tipper()));
+        FL_unique_ptr<Engine> expected(engine->clone());
+
+        const scalar error = engine->tabulate(500);
+        CHECK(error > 0.0);
+        CHECK(error < 1e-4);
+        // the Gaussian terms of service are replaced and the rules refer to them
+        for (std::size_t t = 0; t < engine->getInputVariable(0)->numberOfTerms(); ++t) {
+            const Tabulated* tabulated = dynamic_cast<const Tabulated*>(engine->getInputVariable(0)->getTerm(t));
+            REQUIRE(tabulated);
+            CHECK(tabulated->getName() == expected->getInputVariable(0)->getTerm(t)->getName());
+            CHECK(tabulated->getError() <= error);
+        }
+        CHECK(engine->getInputVariable(1)->getTerm(0)->className() == "Trapezoid");
+        CHECK(engine->getRuleBlock(0)->getRule(0)->isLoaded());
+
+        // the tables are shared amongst clones
+        FL_unique_ptr<Engine> clone(engine->clone());
+        CHECK(dynamic_cast<const Tabulated*>(clone->getInputVariable(0)->getTerm(1))
+                  ->sharesTable(*dynamic_cast<const Tabulated*>(engine->getInputVariable(0)->getTerm(1))));
+        FL_unique_ptr<Engine> imported(FllImporter().fromString(engine->toString()));
+        CHECK(imported->toString() == engine->toString());
+
+        for (scalar service = 0.0; service <= 10.0; service += 0.7) {
+            expected->setInputValue("service", service);
+            expected->setInputValue("food", 4.0);
+            expected->process();
+            clone->setInputValue("service", service);
+            clone->setInputValue("food", 4.0);
+            clone->process();
+            CAPTURE(service);
+            CHECK_THAT(clone->getOutputValue("tip"), Approximates(expected->getOutputValue("tip"), 1e-3));
+        }
+
+        CHECK(clone->tabulate(500) == 0.0);
+    }
+
+    TEST_CASE("Engine instrumentation merges the counters of clones", "[engine][instrumentation]") {
+        FL_unique_ptr<Engine> engine(FllImporter().fromString(tipper()));
+        EngineState state(engine.get());
+        state.setInputValue(0, 0.0);
+        state.setInputValue(1, 5.0);
+        engine->process(state);
+
+        Instrumentation a(engine.get());
+        a.recordProcess(&state);
+        a.recordDefuzzification(1, 10.0);
+        a.recordStage(Instrumentation::Activation, 30.0);
+        a.recordMembership(engine->getInputVariable(0)->getTerm(0));
+        // terms that do not belong to the engine are ignored
+        FL_unique_ptr<Term> other(engine->getInputVariable(0)->getTerm(0)->clone());
+        a.recordMembership(other.get());
+        CHECK(a.processes() == 1);
+        CHECK(a.activations(0, 0) == 1);
+        CHECK(a.firings(0, 0) == 1);
+        CHECK(a.firings(0, 3) == 0);
+        CHECK_THAT(a.meanActivationDegree(0, 0), Approximates(state.getActivationDegree(0, 0)));
+        CHECK(a.memberships(0, 0) == 1);
+        CHECK(a.memberships(0, 1) == 0);
+        CHECK_THAT(a.stageFraction(Instrumentation::Defuzzification), Approximates(0.25));
+
+        // instrumentations are merged by the index of the components in clones of the engine
+        FL_unique_ptr<Engine> clone(engine->clone());
+        Instrumentation b(clone.get());
+        b.merge(a);
+        b.merge(a);
+        CHECK(b.processes() == 2);
+        CHECK(b.firings(0, 0) == 2);
+        CHECK(b.defuzzifications(1) == 2);
+        CHECK_THAT(b.defuzzificationTime(1), Approximates(20.0));
+        CHECK(b.memberships(0, 0) == 2);
+        CHECK_THAT(b.meanActivationDegree(0, 0), Approximates(a.meanActivationDegree(0, 0)));
+        CHECK(b.rulesNeverFired().size() == a.rulesNeverFired().size());
+
+        Instrumentation unbound;
+        unbound.merge(b);
+        CHECK(unbound.getEngine() == clone.get());
+        CHECK(unbound.processes() == 2);
+
+        clone->getRuleBlock(0)->addRule(Rule::parse("if service is good then tip is cheap", clone.get()));
+        CHECK_FALSE(b.isBoundTo(clone.get()));
+        CHECK_THROWS_AS(b.merge(Instrumentation(clone.get())), fl::Exception);
+    }
+
+    TEST_CASE("Engine instrumentation counts the same for processes and states", "[engine][instrumentation]") {
+        FL_unique_ptr<Engine> engine(FllImporter().fromString(tipper()));
+        EngineState state(engine.get());
+        EngineState updated(engine.get());
+        int processes = 0;
+        for (int service = 0; service <= 10; service += 2) {
+            for (int food = 0; food <= 10; food += 5) {
+                engine->setInputValue("service", service);
+                engine->setInputValue("food", food);
+                engine->process();
+                state.setInputValue(0, service);
+                state.setInputValue(1, food);
+                engine->process(state);
+                updated.setInputValue(0, service);
+                updated.setInputValue(1, food);
+                engine->update(updated);
+                ++processes;
+            }
+        }
+        if (not Instrumentation::isEnabled()) {
+            CHECK(engine->instrumentation().processes() == 0);
+            CHECK(state.instrumentation().processes() == 0);
+            return;
+        }
+
+        const Instrumentation& expected = engine->instrumentation();
+        CHECK(expected.processes() == (unsigned long)processes);
+        for (std::size_t r = 0; r < engine->getRuleBlock(0)->numberOfRules(); ++r) {
+            CAPTURE(r);
+            CHECK(expected.activations(0, r) == (unsigned long)processes);
+            CHECK(state.instrumentation().firings(0, r) == expected.firings(0, r));
+            CHECK(updated.instrumentation().firings(0, r) == expected.firings(0, r));
+            CHECK_THAT(
+                state.instrumentation().meanActivationDegree(0, r), Approximates(expected.meanActivationDegree(0, r))
+            );
+        }
+        CHECK(expected.firings(0, 0) > 0);
+        CHECK(expected.firings(0, 0) < (unsigned long)processes);
+        CHECK(expected.defuzzifications(0) == (unsigned long)processes);
+        CHECK(state.instrumentation().defuzzifications(0) == (unsigned long)processes);
+        CHECK(expected.memberships(0, 0) > 0);
+        CHECK(state.instrumentation().memberships(0, 0) > 0);
+        CHECK(state.instrumentation().memberships(2, 0) > 0);
+        CHECK(expected.stageTime(Instrumentation::Fuzzification) > 0.0);
+        CHECK(expected.stageTime(Instrumentation::Defuzzification) > 0.0);
+        CHECK(state.instrumentation().stageTime(Instrumentation::Activation) > 0.0);
+
+        engine->resetInstrumentation();
+        CHECK(engine->instrumentation().processes() == 0);
+    }
+
+    TEST_CASE("Engine processes the same in parallel as serially", "[engine][parallel]") {
+        // the second block concludes on tip like the first one, and the third one reads mood, so only
+        // the fourth block (on the new output) and the outputs are processed in parallel with the rest
+        FL_unique_ptr<Engine> engine(FllImporter().fromString(
+            tipper()
+            + "OutputVariable: speed\n"
+              "  enabled: true\n"
+              "  range: 0.000 10.000\n"
+              "  aggregation: AlgebraicSum\n"
+              "  defuzzifier: Bisector 500\n"
+              "  default: 0.000\n"
+              "  term: slow Ramp 5.000 0.000\n"
+              "  term: fast Ramp 5.000 10.000\n"
+              "RuleBlock: tips\n"
+              "  conjunction: Minimum\n"
+              "  disjunction: Maximum\n"
+              "  implication: Minimum\n"
+              "  activation: General\n"
+              "  rule: if food is delicious then tip is generous with 0.5\n"
+              "RuleBlock: moods\n"
+              "  conjunction: Minimum\n"
+              "  implication: Minimum\n"
+              "  activation: General\n"
+              "  rule: if mood is great and service is good then mood is bad with 0.25\n"
+              "RuleBlock: speeds\n"
+              "  conjunction: AlgebraicProduct\n"
+              "  implication: AlgebraicProduct\n"
+              "  activation: General\n"
+              "  rule: if service is poor then speed is slow\n"
+              "  rule: if service is excellent and food is not rancid then speed is fast\n"
+        ));
+        FL_unique_ptr<Engine> parallel(engine->clone());
+        TaskPool taskPool(3);
+        parallel->setTaskPool(&taskPool);
+        parallel->setParallelThreshold(0);
+        CHECK(parallel->getTaskPool() == &taskPool);
+
+        for (int service = 0; service <= 10; ++service) {
+            for (int food = 0; food <= 10; food += 2) {
+                engine->setInputValue("service", service);
+                engine->setInputValue("food", food);
+                parallel->setInputValue("service", service);
+                parallel->setInputValue("food", food);
+                engine->process();
+                parallel->process();
+                CAPTURE(service, food);
+                for (std::size_t i = 0; i < engine->numberOfOutputVariables(); ++i) {
+                    const scalar expected = engine->getOutputVariable(i)->getValue();
+                    const scalar obtained = parallel->getOutputVariable(i)->getValue();
+                    CHECK((expected == obtained or (Op::isNaN(expected) and Op::isNaN(obtained))));
+                }
+            }
+        }
+
+        // the rule blocks are regrouped when the enabled ones change after setting the task pool
+        for (Engine* each : {engine.get(), parallel.get()}) {
+            each->getRuleBlock("tips")->setEnabled(false);
+            each->setInputValue("service", 8.0);
+            each->setInputValue("food", 3.0);
+            each->process();
+        }
+        for (std::size_t i = 0; i < engine->numberOfOutputVariables(); ++i) {
+            const scalar expected = engine->getOutputVariable(i)->getValue();
+            const scalar obtained = parallel->getOutputVariable(i)->getValue();
+            CHECK((expected == obtained or (Op::isNaN(expected) and Op::isNaN(obtained))));
+        }
+    }
+
+    TEST_CASE("Task pools run every task once", "[engine][parallel]") {
+        class Counter : public TaskPool::Job {
+          public:
+            std::vector<int> runs;
+
+            explicit Counter(std::size_t tasks) : runs(tasks, 0) {}
+
+            void run(std::size_t index) FL_IOVERRIDE {
+                if (index % 7 == 0)  // uneven tasks, so the idle threads steal the rest
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                ++runs.at(index);
+            }
+        };
+        TaskPool taskPool(3);
+        CHECK(taskPool.getThreads() == 3);
+        for (std::size_t tasks = 0; tasks <= 100; tasks += 25) {
+            Counter counter(tasks);
+            taskPool.run(counter, tasks);
+            CAPTURE(tasks);
+            CHECK(counter.runs == std::vector<int>(tasks, 1));
+        }
+    }
+
+    TEST_CASE("Task pools rethrow the exceptions of the tasks", "[engine][parallel]") {
+        class Failure : public TaskPool::Job {
+          public:
+            void run(std::size_t index) FL_IOVERRIDE {
+                if (index == 5)
+                    throw Exception("[task error] task 5 failed", FL_AT);
+            }
+        };
+        TaskPool taskPool(2);
+        Failure failure;
+        CHECK_THROWS_AS(taskPool.run(failure, 10), fl::Exception);
+        CHECK_NOTHROW(taskPool.run(failure, 5));
+    }
+
+    TEST_CASE("Engine states do not support other activation methods", "[engine][state]") {
+        FL_unique_ptr<Engine> engine(FllImporter().fromString(tipper()));
+        engine->getRuleBlock(0)->setActivation(new Highest);
+        CHECK_THROWS_AS(EngineState(engine.get()), fl::Exception);
+    }
+
+}}
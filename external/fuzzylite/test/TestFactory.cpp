@@ -398,6 +398,7 @@ namespace fuzzylite { namespace test {
                 {"SigmoidDifference", SigmoidDifference::constructor, "term: _ SigmoidDifference nan nan nan nan"},
                 {"SigmoidProduct", SigmoidProduct::constructor, "term: _ SigmoidProduct nan nan nan nan"},
                 {"Spike", Spike::constructor, "term: _ Spike nan nan"},
+                {"Tabulated", Tabulated::constructor, "term: _ Tabulated 1000 nan nan"},
                 {"SShape", SShape::constructor, "term: _ SShape nan nan"},
                 {"Trapezoid", Trapezoid::constructor, "term: _ Trapezoid nan nan nan nan"},
                 {"Triangle", Triangle::constructor, "term: _ Triangle nan nan nan"},
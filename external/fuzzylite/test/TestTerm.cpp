@@ -2043,6 +2043,136 @@ namespace fuzzylite { namespace test {
         CHECK(f.toString() == constFunction.toString());
     }
 
+    TEST_CASE("Function compiles formulas equivalent to the expression tree", "[term][function]") {
+        Engine engine(
+            "A", "Engine A", {new InputVariable("i_A"), new InputVariable("x")}, {new OutputVariable("o_A")}
+        );
+        const std::vector<std::string> formulas = {
+            "2*i_A + o_A + x",
+            "sin(i_A * x)^2 / x - cos(o_A)",
+            "max(i_A, x) - min(o_A, 1) + pow(x, 3) % 2",
+            "~x + ~i_A * fabs(0 - o_A) + ge(x, 0.5) * le(i_A, o_A)",
+            "(((((x + 1) * 2) + 3) * 4) + 5) / (x - (i_A - (o_A - (x - (i_A - 1)))))",
+            "log(x) + exp(i_A) + sqrt(o_A) + atan2(x, i_A)",
+        };
+        for (const std::string& formula : formulas) {
+            CAPTURE(formula);
+            FL_unique_ptr<Function> f(Function::create("f", formula, &engine));
+            CHECK(f->isCompiled());
+            FL_unique_ptr<Function> copy(f->clone());
+            CHECK(copy->isCompiled());
+            for (scalar i = -1.0; i <= 1.0; i += 0.5) {
+                for (scalar o : {-0.75, 0.0, 0.3, nan, inf}) {
+                    for (scalar x : {-2.0, -0.5, 0.0, 0.5, 1.0, 10.0, nan, -inf}) {
+                        engine.getInputVariable(0)->setValue(i);
+                        engine.getInputVariable(1)->setValue(-x);
+                        engine.getOutputVariable(0)->setValue(o);
+                        std::map<std::string, scalar> variables = {{"i_A", i}, {"o_A", o}, {"x", x}};
+                        CAPTURE(i, o, x);
+                        // the expression tree is the reference
+                        CHECK_THAT(f->membership(x), Approximates(f->root()->evaluate(&variables)));
+                        CHECK_THAT(copy->membership(x), Approximates(f->root()->evaluate(&variables)));
+                    }
+                }
+            }
+        }
+
+        // deeply nested formulas do not fit in the stack
+        std::string nested = "x";
+        for (std::size_t i = 0; i < Function::MaximumStackSize; ++i)
+            nested = "1 + (" + nested + ")";
+        CHECK_FALSE(FL_unique_ptr<Function>(Function::create("f", nested, &engine))->isCompiled());
+        nested = "x";
+        for (std::size_t i = 0; i < Function::MaximumStackSize; ++i)
+            nested = "(" + nested + ") + 1";
+        CHECK(FL_unique_ptr<Function>(Function::create("f", nested, &engine))->isCompiled());
+
+        // variables that are not in the engine are only evaluated with the expression tree
+        Function f("f", "2*x^3 + 2*y - 3", {{"y", 1.5}}, &engine, true);
+        CHECK_FALSE(f.isCompiled());
+        CHECK(f.membership(1.0) == 2.0);
+
+        f.setEngine(fl::null);
+        CHECK_FALSE(f.isCompiled());
+        f.load("x * 2");
+        CHECK(f.isCompiled());
+        CHECK(f.membership(3.0) == 6.0);
+        f.unload();
+        CHECK_FALSE(f.isCompiled());
+    }
+
+    TEST_CASE("Tabulated approximates terms within the measured error", "[term][tabulated]") {
+        Engine engine("A", "Engine A", {new InputVariable("i_A")}, {});
+        std::vector<Term*> terms = {
+            new Gaussian("gaussian", 5.0, 1.5),
+            new Bell("bell", 5.0, 2.0, 3.0),
+            new Sigmoid("sigmoid", 5.0, 2.0),
+            new Cosine("cosine", 5.0, 4.0, 0.5),
+            Discrete::create("discrete", 6, 0.0, 0.0, 2.5, 0.8, 10.0, 0.3),
+            Function::create("function", "exp(0 - x) * sin(x)^2", &engine),
+        };
+        for (Term* term : terms) {
+            CAPTURE(term->toString());
+            CHECK(Tabulated::isExpensive(term));
+            FL_unique_ptr<Term> reference(term->clone());
+            Tabulated tabulated(term->getName(), term, 0.0, 10.0, 200);
+            REQUIRE(tabulated.isTabulated());
+            CHECK(tabulated.getError() < 0.01);
+            for (scalar x = -1.0; x <= 11.0; x += 0.0137) {
+                CAPTURE(x);
+                const scalar difference = std::abs(tabulated.membership(x) - reference->membership(x));
+                CHECK(difference <= tabulated.getError() * 1.5 + 1e-12);
+                // outside the range the term is computed exactly
+                if (x < 0.0 or x > 10.0)
+                    CHECK(difference == 0.0);
+            }
+            CHECK(tabulated.membership(0.0) == reference->membership(0.0));
+            CHECK(tabulated.membership(10.0) == reference->membership(10.0));
+            CHECK(Op::isNaN(tabulated.membership(fl::nan)));
+
+            // copies share the table
+            FL_unique_ptr<Tabulated> copy(tabulated.clone());
+            CHECK(copy->sharesTable(tabulated));
+            CHECK(copy->getTerm() != tabulated.getTerm());
+            copy->setResolution(100);
+            CHECK_FALSE(copy->sharesTable(tabulated));
+        }
+        CHECK_FALSE(Tabulated::isExpensive(FL_unique_ptr<Term>(new Triangle("t", 0, 1, 2)).get()));
+        CHECK_FALSE(Tabulated::isExpensive(FL_unique_ptr<Term>(Function::create("f", "x + i_A", &engine)).get()));
+
+        // ranges that are not finite are not tabulated
+        Tabulated infinite("infinite", new Gaussian("gaussian", 0.0, 1.0), 0.0, fl::inf);
+        CHECK_FALSE(infinite.isTabulated());
+        CHECK(Op::isNaN(infinite.getError()));
+        CHECK(infinite.membership(0.0) == 1.0);
+
+        // the error remains nan after a nan sample, even if the later samples are finite
+        Tabulated undefined("undefined", Function::create("undefined", "sqrt(x - 5)", &engine), 0.0, 10.0, 10);
+        CHECK(undefined.isTabulated());
+        CHECK(Op::isNaN(undefined.getError()));
+    }
+
+    TEST_CASE("Tabulated is configured from parameters", "[term][tabulated]") {
+        FL_unique_ptr<Term> term(FactoryManager::instance()->term()->constructObject("Tabulated"));
+        term->setName("t");
+        term->configure("100 0.000 10.000 Gaussian 5.000 2.000 0.500");
+        const Tabulated* tabulated = dynamic_cast<const Tabulated*>(term.get());
+        REQUIRE(tabulated);
+        CHECK(tabulated->isTabulated());
+        CHECK(tabulated->getResolution() == 100);
+        CHECK(tabulated->getTerm()->className() == "Gaussian");
+        CHECK(tabulated->getTerm()->getHeight() == 0.5);
+        CHECK(FllExporter().toString(term.get()) == "term: t Tabulated 100 0.000 10.000 Gaussian 5.000 2.000 0.500");
+        CHECK_THAT(term->membership(5.0), Approximates(0.5));
+
+        term->configure("100 0.000 10.000 Function x * x");
+        CHECK(FllExporter().toString(term.get()) == "term: t Tabulated 100 0.000 10.000 Function x * x");
+        CHECK_THAT(term->membership(3.0), Approximates(9.0, 0.01));
+
+        CHECK_THROWS_AS(term->configure("100 0.000 10.000"), fl::Exception);
+        CHECK_THROWS_AS(term->configure("100 0.000 10.000 Unknown"), fl::Exception);
+    }
+
     TEST_CASE("FunctionElementOperator", "[term][function][element]") {
         SECTION("Base") {
             auto op = Function::Element("Name", "Description", Function::Element::Operator);
@@ -0,0 +1,173 @@
+/*
+fuzzylite (R), a fuzzy logic control library in C++.
+
+Copyright (C) 2010-2024 FuzzyLite Limited. All rights reserved.
+Author: Juan Rada-Vilela, PhD <jcrada@fuzzylite.com>.
+
+This file is part of fuzzylite.
+
+fuzzylite is free software: you can redistribute it and/or modify it under
+the terms of the FuzzyLite License included with the software.
+
+You should have received a copy of the FuzzyLite License along with
+fuzzylite. If not, see <https://github.com/fuzzylite/fuzzylite/>.
+
+fuzzylite is a registered trademark of FuzzyLite Limited.
+*/
+
+#include "../Headers.h"
+
+namespace fuzzylite {
+
+    static std::string snapshotEngine() {
+        return "Engine: snapshot\n"
+               "description: an engine with terms of every kind\n"
+               "InputVariable: Ambient\n"
+               "  enabled: true\n"
+               "  range: 0.000 1.000\n"
+               "  lock-range: true\n"
+               "  term: DARK Triangle 0.000 0.250 0.500\n"
+               "  term: MEDIUM Bell 0.500 0.250 3.000 0.900\n"
+               "  term: BRIGHT Discrete 0.500 0.000 0.750 0.500 1.000 1.000\n"
+               "InputVariable: Noise\n"
+               "  enabled: false\n"
+               "  range: -1.000 1.000\n"
+               "  lock-range: false\n"
+               "  term: QUIET Sigmoid 0.000 -10.000\n"
+               "  term: LOUD PiShape 0.000 0.500 0.750 1.000\n"
+               "  term: ANY Function 1 - abs(Ambient - 0.5)\n"
+               "OutputVariable: Power\n"
+               "  enabled: true\n"
+               "  range: 0.000 2.000\n"
+               "  lock-range: false\n"
+               "  aggregation: Maximum\n"
+               "  defuzzifier: Centroid 200\n"
+               "  default: nan\n"
+               "  lock-previous: true\n"
+               "  term: LOW Ramp 1.000 0.000\n"
+               "  term: MEDIUM Triangle 0.500 1.000 1.500\n"
+               "  term: HIGH Trapezoid 1.000 1.500 2.000 2.000\n"
+               "OutputVariable: Gain\n"
+               "  enabled: true\n"
+               "  range: -10.000 10.000\n"
+               "  lock-range: true\n"
+               "  aggregation: none\n"
+               "  defuzzifier: WeightedAverage TakagiSugeno\n"
+               "  default: 0.000\n"
+               "  lock-previous: false\n"
+               "  term: FLAT Constant 1.000\n"
+               "  term: SLOPE Linear 2.000 -1.000 0.500\n"
+               "RuleBlock: power\n"
+               "  enabled: true\n"
+               "  conjunction: Minimum\n"
+               "  disjunction: AlgebraicSum\n"
+               "  implication: Minimum\n"
+               "  activation: General\n"
+               "  rule: if Ambient is DARK then Power is HIGH\n"
+               "  rule: if Ambient is very MEDIUM or Ambient is not DARK then Power is MEDIUM with 0.5\n"
+               "  rule: if Ambient is BRIGHT and Ambient is any then Power is somewhat LOW\n"
+               "  rule: if Noise is ANY or Noise is LOUD then Power is LOW\n"
+               "RuleBlock: gain\n"
+               "  enabled: true\n"
+               "  conjunction: AlgebraicProduct\n"
+               "  disjunction: none\n"
+               "  implication: none\n"
+               "  activation: Highest 2\n"
+               "  rule: if Ambient is DARK then Gain is FLAT\n"
+               "  rule: if Ambient is BRIGHT then Gain is SLOPE\n"
+               "  rule: if Noise is QUIET then Gain is SLOPE\n";
+    }
+
+    TEST_CASE("FlbImporter restores the engines exported by FlbExporter", "[imex][flb]") {
+        FL_unique_ptr<Engine> engine(FllImporter().fromString(snapshotEngine()));
+        engine->getInputVariable(0)->addTerm(
+            new Tabulated("TABULATED", new Gaussian("", 0.5, 0.2), 0.0, 1.0, 64)
+        );
+        engine->getInputVariable(0)->setValue(0.123456789);
+        engine->getOutputVariable(0)->setPreviousValue(1.0 / 3.0);
+
+        const std::string snapshot = FlbExporter().toString(engine.get());
+        CHECK(snapshot.substr(0, 4) == FlbExporter::magic());
+
+        FL_unique_ptr<Engine> restored(FlbImporter().fromString(snapshot));
+        CHECK(FllExporter().toString(restored.get()) == FllExporter().toString(engine.get()));
+        CHECK(FlbExporter().toString(restored.get()) == snapshot);
+        CHECK(restored->isReady());
+
+        CHECK(restored->getInputVariable(0)->getValue() == 0.123456789);
+        CHECK(restored->getOutputVariable(0)->getPreviousValue() == 1.0 / 3.0);
+        for (std::size_t b = 0; b < restored->numberOfRuleBlocks(); ++b) {
+            for (std::size_t r = 0; r < restored->getRuleBlock(b)->numberOfRules(); ++r) {
+                const Rule* rule = restored->getRuleBlock(b)->getRule(r);
+                CHECK(rule->isLoaded());
+                CHECK(rule->toString() == engine->getRuleBlock(b)->getRule(r)->toString());
+            }
+        }
+    }
+
+    TEST_CASE("FlbImporter restores engines that process the same", "[imex][flb]") {
+        FL_unique_ptr<Engine> engine(FllImporter().fromString(snapshotEngine()));
+        FL_unique_ptr<Engine> restored(FlbImporter().fromString(FlbExporter().toString(engine.get())));
+        for (int i = 0; i <= 20; ++i) {
+            const scalar ambient = i / 20.0;
+            const scalar noise = 1.0 - i / 10.0;
+            engine->setInputValue("Ambient", ambient);
+            engine->setInputValue("Noise", noise);
+            restored->setInputValue("Ambient", ambient);
+            restored->setInputValue("Noise", noise);
+            engine->process();
+            restored->process();
+            CAPTURE(ambient);
+            for (std::size_t o = 0; o < engine->numberOfOutputVariables(); ++o) {
+                const scalar expected = engine->getOutputVariable(o)->getValue();
+                const scalar obtained = restored->getOutputVariable(o)->getValue();
+                CHECK((expected == obtained or (Op::isNaN(expected) and Op::isNaN(obtained))));
+            }
+        }
+    }
+
+    TEST_CASE("FlbImporter clones engines through snapshots", "[imex][flb]") {
+        FL_unique_ptr<Engine> engine(FllImporter().fromString(snapshotEngine()));
+        engine->setInputValue("Ambient", 0.3);
+        FL_unique_ptr<Engine> clone(FlbImporter().cloneEngine(engine.get()));
+        CHECK(clone.get() != engine.get());
+        CHECK(FllExporter().toString(clone.get()) == FllExporter().toString(engine.get()));
+        CHECK(clone->getInputVariable("Ambient")->getValue() == 0.3);
+
+        // the clone is independent of the engine
+        clone->setInputValue("Ambient", 0.7);
+        CHECK(engine->getInputVariable("Ambient")->getValue() == 0.3);
+        engine->process();
+        clone->setInputValue("Ambient", 0.3);
+        clone->process();
+        for (std::size_t o = 0; o < engine->numberOfOutputVariables(); ++o) {
+            const scalar expected = engine->getOutputVariable(o)->getValue();
+            const scalar obtained = clone->getOutputVariable(o)->getValue();
+            CHECK((expected == obtained or (Op::isNaN(expected) and Op::isNaN(obtained))));
+        }
+    }
+
+    TEST_CASE("FlbImporter rejects invalid snapshots", "[imex][flb]") {
+        FL_unique_ptr<Engine> engine(FllImporter().fromString(snapshotEngine()));
+        const std::string snapshot = FlbExporter().toString(engine.get());
+
+        CHECK_THROWS_AS(FlbImporter().fromString(""), fl::Exception);
+        CHECK_THROWS_AS(FlbImporter().fromString(FllExporter().toString(engine.get())), fl::Exception);
+        CHECK_THROWS_AS(FlbImporter().fromString(snapshot.substr(0, snapshot.size() / 2)), fl::Exception);
+        CHECK_THROWS_AS(FlbImporter().fromString(snapshot.substr(0, snapshot.size() - 1)), fl::Exception);
+        CHECK_THROWS_AS(FlbImporter().fromString(snapshot + '\0'), fl::Exception);
+
+        std::string otherVersion = snapshot;
+        otherVersion[4] = char(FlbExporter::version() + 1);
+        CHECK_THROWS_AS(FlbImporter().fromString(otherVersion), fl::Exception);
+
+        std::string otherScalar = snapshot;
+        otherScalar[8] = char(sizeof(scalar) / 2);
+        CHECK_THROWS_AS(FlbImporter().fromString(otherScalar), fl::Exception);
+
+        std::string otherByteOrder = snapshot;
+        std::reverse(otherByteOrder.begin() + 12, otherByteOrder.begin() + 12 + sizeof(scalar));
+        CHECK_THROWS_AS(FlbImporter().fromString(otherByteOrder), fl::Exception);
+    }
+
+}
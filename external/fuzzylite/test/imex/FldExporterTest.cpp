@@ -42,4 +42,61 @@ namespace fuzzylite {
         CHECK(int(linesAllVariables.size()) == expectedValues);
     }
 
+    TEST_CASE("Exports the same dataset on multiple threads", "[imex][fld]") {
+        FL_unique_ptr<Engine> engine(Console::mamdani());
+        engine->addInputVariable(new InputVariable("Dummy", 0, 1));
+        engine->getInputVariable(1)->setValue(0.5);
+        std::vector<InputVariable*> activeVariables(engine->inputVariables());
+        activeVariables.at(1) = fl::null;
+
+        FldExporter serial;
+        const std::string expected = serial.toString(engine.get(), 1000, FldExporter::EachVariable, activeVariables);
+        CHECK(Op::split(expected, "\n").size() == 1001);
+
+        FldExporter parallel;
+        parallel.setThreads(4);
+        parallel.setChunkSize(7);
+        CHECK(parallel.toString(engine.get(), 1000, FldExporter::EachVariable, activeVariables) == expected);
+
+        serial.setExportHeader(false);
+        std::istringstream serialReader(expected);
+        const std::string fromReader = serial.toString(engine.get(), serialReader);
+        std::istringstream parallelReader(expected);
+        parallel.setExportHeader(false);
+        CHECK(parallel.toString(engine.get(), parallelReader) == fromReader);
+    }
+
+    TEST_CASE("Exports datasets in binary", "[imex][fld]") {
+        FL_unique_ptr<Engine> engine(Console::mamdani());
+        FldExporter text;
+        text.setExportHeader(false);
+        const std::vector<std::string> lines
+            = Op::split(text.toString(engine.get(), 100, FldExporter::EachVariable), "\n");
+
+        FldExporter binary;
+        binary.setFormat(FldExporter::Binary);
+        binary.setThreads(3);
+        binary.setChunkSize(16);
+        std::ostringstream progress;
+        binary.setProgress(&progress);
+        std::stringstream dataset;
+        binary.write(engine.get(), dataset, 100, FldExporter::EachVariable);
+        CHECK(progress.str().find("[fld] 100/100 rows (100.0%)") != std::string::npos);
+
+        std::vector<std::string> columns;
+        const std::vector<std::vector<scalar> > rows = binary.readBinary(dataset, &columns);
+        CHECK(columns == std::vector<std::string>{"ambient", "power"});
+        REQUIRE(rows.size() == lines.size());
+        for (std::size_t r = 0; r < rows.size(); ++r) {
+            const std::vector<scalar> expected = Op::toScalars(lines.at(r));
+            REQUIRE(rows.at(r).size() == expected.size());
+            for (std::size_t c = 0; c < expected.size(); ++c)
+                CHECK_THAT(rows.at(r).at(c), test::Approximates(expected.at(c), 1e-3));
+        }
+
+        std::string truncated = dataset.str();
+        std::istringstream truncatedReader(truncated.substr(0, truncated.size() - 1));
+        CHECK_THROWS_AS(binary.readBinary(truncatedReader), fl::Exception);
+    }
+
 }
@@ -0,0 +1,106 @@
+/*
+fuzzylite (R), a fuzzy logic control library in C++.
+
+Copyright (C) 2010-2024 FuzzyLite Limited. All rights reserved.
+Author: Juan Rada-Vilela, PhD <jcrada@fuzzylite.com>.
+
+This file is part of fuzzylite.
+
+fuzzylite is free software: you can redistribute it and/or modify it under
+the terms of the FuzzyLite License included with the software.
+
+You should have received a copy of the FuzzyLite License along with
+fuzzylite. If not, see <https://github.com/fuzzylite/fuzzylite/>.
+
+fuzzylite is a registered trademark of FuzzyLite Limited.
+*/
+
+#include "../Headers.h"
+
+namespace fuzzylite {
+
+    static std::string nativeEngine() {
+        return "Engine: simple dimmer\n"
+               "InputVariable: Ambient\n"
+               "  enabled: true\n"
+               "  range: 0.000 1.000\n"
+               "  lock-range: true\n"
+               "  term: DARK Triangle 0.000 0.250 0.500\n"
+               "  term: MEDIUM Triangle 0.250 0.500 0.750\n"
+               "  term: BRIGHT Gaussian 1.000 0.250\n"
+               "OutputVariable: Power\n"
+               "  enabled: true\n"
+               "  range: 0.000 2.000\n"
+               "  lock-range: false\n"
+               "  aggregation: Maximum\n"
+               "  defuzzifier: Centroid 200\n"
+               "  default: 0.500\n"
+               "  lock-previous: true\n"
+               "  term: LOW Ramp 1.000 0.000\n"
+               "  term: MEDIUM Triangle 0.500 1.000 1.500\n"
+               "  term: HIGH Trapezoid 1.000 1.500 2.000 2.000\n"
+               "RuleBlock: \n"
+               "  enabled: true\n"
+               "  conjunction: Minimum\n"
+               "  disjunction: AlgebraicSum\n"
+               "  implication: Minimum\n"
+               "  activation: General\n"
+               "  rule: if Ambient is DARK then Power is HIGH\n"
+               "  rule: if Ambient is very MEDIUM or Ambient is not DARK then Power is MEDIUM with 0.5\n"
+               "  rule: if Ambient is BRIGHT and Ambient is any then Power is somewhat LOW\n";
+    }
+
+    TEST_CASE("NativeExporter unrolls the engine into standalone code", "[imex][native]") {
+        FL_unique_ptr<Engine> engine(FllImporter().fromString(nativeEngine()));
+        const std::string cpp = NativeExporter().toString(engine.get());
+        CAPTURE(cpp);
+
+        CHECK(cpp.find("namespace simpledimmer {") != std::string::npos);
+        CHECK(cpp.find("#include <fl/") == std::string::npos);
+        CHECK(cpp.find("inline void process(const double* input, double* output, double* previous)")
+              != std::string::npos);
+        CHECK(cpp.find("const double x0 = detail::bound(input[0], 0.0, 1.0);") != std::string::npos);
+        CHECK(cpp.find("const double m0_0 = detail::triangle(x0, 0.0, 0.25, 0.5, 1.0);") != std::string::npos);
+        CHECK(cpp.find("const double m0_2 = detail::gaussian(x0, 1.0, 0.25, 1.0);") != std::string::npos);
+        CHECK(
+            cpp.find("double degree = 0.5 * (detail::hedgeVery(m0_1) + detail::hedgeNot(m0_0) - "
+                     "(detail::hedgeVery(m0_1) * detail::hedgeNot(m0_0)));")
+            != std::string::npos
+        );
+        CHECK(cpp.find("double degree = detail::min(m0_2, 1.0);") != std::string::npos);
+        CHECK(cpp.find("degree = detail::hedgeSomewhat(degree);") != std::string::npos);
+        CHECK(cpp.find("{detail::Shape::Trapezoid, 1.0, 1.5, 2.0, 2.0, 1.0}") != std::string::npos);
+        CHECK(cpp.find("detail::centroid(terms, activations0, count0, true, 0.0, 2.0);") != std::string::npos);
+        CHECK(cpp.find("value = previous[0];") != std::string::npos);
+        CHECK(cpp.find("value = 0.5;") != std::string::npos);
+
+        NativeExporter exporter("dimmer");
+        CHECK(exporter.toString(engine.get()).find("namespace dimmer {") != std::string::npos);
+        CHECK(exporter.toString(0.1) == "0.10000000000000001");
+        CHECK(exporter.toString(-fl::inf) == "-detail::inf");
+    }
+
+    TEST_CASE("NativeExporter rejects components that are not supported", "[imex][native]") {
+        FL_unique_ptr<Engine> engine(FllImporter().fromString(nativeEngine()));
+        engine->getRuleBlock(0)->setActivation(new Highest);
+        CHECK_THROWS_AS(NativeExporter().toString(engine.get()), fl::Exception);
+
+        engine.reset(FllImporter().fromString(nativeEngine()));
+        engine->getRuleBlock(0)->setConjunction(new DrasticProduct);
+        CHECK_THROWS_AS(NativeExporter().toString(engine.get()), fl::Exception);
+
+        engine.reset(FllImporter().fromString(nativeEngine()));
+        engine->getOutputVariable(0)->setDefuzzifier(new Bisector);
+        CHECK_THROWS_AS(NativeExporter().toString(engine.get()), fl::Exception);
+
+        engine.reset(FllImporter().fromString(nativeEngine()));
+        delete engine->getOutputVariable(0)->removeTerm(0);
+        engine->getOutputVariable(0)->insertTerm(new Bell("LOW", 0.0, 0.5, 2.0), 0);
+        CHECK_THROWS_AS(NativeExporter().toString(engine.get()), fl::Exception);
+
+        engine.reset(FllImporter().fromString(nativeEngine()));
+        engine->getRuleBlock(0)->addRule(Rule::parse("if Power is HIGH then Power is LOW", engine.get()));
+        CHECK_THROWS_AS(NativeExporter().toString(engine.get()), fl::Exception);
+    }
+
+}
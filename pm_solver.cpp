@@ -8,11 +8,22 @@
 
 #include <fl/Headers.h>
 
+#ifdef PM_SOLVER_NATIVE_ENGINE
+#include "Baseline.h" // generated from Baseline.fll at build time by fuzzylite_native_engine()
+#endif
+
 #include <pagmo/algorithm.hpp>
+#include <pagmo/algorithms/nsga2.hpp>
 #include <pagmo/algorithms/sade.hpp>
 #include <pagmo/archipelago.hpp>
+#include <pagmo/bfe.hpp>
 #include <pagmo/problem.hpp>
 #include <pagmo/problems/schwefel.hpp>
+#include <pagmo/s11n.hpp>
+#include <pagmo/utils/multi_objective.hpp>
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
 
 using Stats = std::tuple<
     int, //0 strength
@@ -244,6 +255,71 @@ Stats sum_stats(const Stats& a, const Stats& b)
     return tuple_sum(a, b);
 }
 
+/** Same stats as Stats, but indexable at runtime, for the simulation loops */
+using StatsArray = std::array<int, std::tuple_size_v<Stats>>;
+
+StatsArray to_array(const Stats& stats)
+{
+    return std::apply([](auto... stat) { return StatsArray{ stat... }; }, stats);
+}
+
+Stats to_stats(const StatsArray& stats)
+{
+    return std::apply([](auto... stat) { return Stats{ stat... }; }, stats);
+}
+
+/** Stat changes of each action, indexed by the output variable of the engine that gives its priority */
+using ActionEffects = std::vector<StatsArray>;
+
+/**
+ * Binds the output variables of the engine to the actions once at load time,
+ * so the simulation steps do not look up the actions by name.
+ */
+ActionEffects bind_actions(const fl::Engine* engine)
+{
+    ActionEffects effects;
+    effects.reserve(engine->numberOfOutputVariables());
+    for (std::size_t i = 0; i < engine->numberOfOutputVariables(); ++i)
+    {
+        const std::string& name = engine->getOutputVariable(i)->getName();
+        const auto action = actions.find(name);
+        if (action == actions.end())
+        {
+            throw fl::Exception("[engine error] output variable <" + name + "> is not a known action");
+        }
+        effects.push_back(to_array(action->second));
+    }
+    return effects;
+}
+
+/**
+ * Index of the action with the highest priority, defaulting to 0 if the priority is NaN.
+ * The first action wins ties, i.e., if no rules fired (all priorities are 0).
+ */
+std::size_t choose_action_index(const double* priorities, std::size_t count)
+{
+    std::size_t chosen = 0;
+    double chosen_priority = std::isnan(priorities[0]) ? 0.0 : priorities[0];
+    for (std::size_t i = 1; i < count; ++i)
+    {
+        const double priority = std::isnan(priorities[i]) ? 0.0 : priorities[i];
+        if (priority > chosen_priority)
+        {
+            chosen = i;
+            chosen_priority = priority;
+        }
+    }
+    return chosen;
+}
+
+void apply_action(StatsArray& stats, const StatsArray& effects)
+{
+    for (std::size_t i = 0; i < stats.size(); ++i)
+    {
+        stats[i] += effects[i];
+    }
+}
+
 std::string choose_action(fl::Engine* engine, const Inclinations& inclinations, const Stats& stats)
 {
     // Load the specimen into the engine - assume that inclinations are already set
@@ -280,9 +356,6 @@ std::string choose_action(fl::Engine* engine, const Inclinations& inclinations,
             // defaulting to 0 if the value is NaN
             const auto left_priority = std::isnan(a->getValue()) ? 0.0 : a->getValue();
             const auto right_priority = std::isnan(b->getValue()) ? 0.0 : b->getValue();
-
-            std::cout << "Comparing " << a->getName() << " with value " << left_priority
-                << " and " << b->getName() << " with value " << right_priority << "\n";
             return left_priority < right_priority;
         }
     );
@@ -296,11 +369,17 @@ std::string choose_action(fl::Engine* engine, const Inclinations& inclinations,
     return chosen_action_name;
 }
 
+const std::string engine_path{ "C:\\projects\\pm_solver\\Baseline.fll" };
+
 std::unique_ptr<fl::Engine> init()
 {
     // Initialize the engine
-    std::string path{ "C:\\projects\\pm_solver\\Baseline.fll" };
-    std::unique_ptr<fl::Engine> engine{ fl::FllImporter().fromFile(path) };
+#ifdef PM_SOLVER_SNAPSHOT
+    // binary snapshot of Baseline.fll generated at build time by fuzzylite_engine_snapshot(), loads without parsing
+    std::unique_ptr<fl::Engine> engine{ fl::FlbImporter().fromFile(PM_SOLVER_SNAPSHOT) };
+#else
+    std::unique_ptr<fl::Engine> engine{ fl::FllImporter().fromFile(engine_path) };
+#endif
     // Checking for errors in the engine loading.
     std::string status;
     if (not engine->isReady(&status))
@@ -323,7 +402,6 @@ std::string single_step(Stats& stats, const Inclinations& inclinations, fl::Engi
         std::cout << "No action chosen, exiting.\n";
         return "";
     }
-    std::cout << "Chosen action: " << chosen_action_name << "\n";
     // Apply the effects of the chosen action
     Stats stats_diff = actions.at(chosen_action_name);
     stats = sum_stats(stats, stats_diff);
@@ -331,286 +409,3457 @@ std::string single_step(Stats& stats, const Inclinations& inclinations, fl::Engi
     return chosen_action_name;
 }
 
-/** the lower the better (conforming to pagmo2 conventions) */
-double fitness_bak(const Stats& stats)
-{
-    // Social reputation > 100
-	const int social_reputation = std::get<3>(stats) + std::get<4>(stats) + std::get<5>(stats)
-        + std::get<15>(stats) + std::get<16>(stats) + std::get<17>(stats);
-
-    // Fighter reputation < 100
-    const int fighter_reputation = std::get<0>(stats) + std::get<1>(stats)
-		+ std::get<9>(stats) + std::get<10>(stats) + std::get<11>(stats);
-
-	// the higher the social reputation than the 100 the lower the fitness value
-	// the higher the fighter reputation than the 100 the higher the fitness value
-	// social reputation > 100, fighter reputation = 0 => fitness = 0
-    // social reputation < 100, fighter reputation = 0 => fitness > 0
-    // social reputation > 100, fighter reputation > 0 => fitness > 0
-	// social reputation < 100, fighter reputation > 0 => fitness >> 0
-	
-	double fitness_value = 0.0;
-	
-	// Penalty if social reputation is below 100
-	if (social_reputation < 100) {
-		fitness_value += (100 - social_reputation);
-	}
-	
-	// Penalty if fighter reputation is above 0
-	if (fighter_reputation > 0) {
-		fitness_value += fighter_reputation;
-	}
-	
-	return fitness_value;
-}
-
-double fitness(const Stats& stats)
+/**
+ * One of the endings of the game, as conditions on the stats at the end of the simulation, the lower the better.
+ * Every condition requires a weighted sum of the stats to reach a threshold: falling short of it adds the difference
+ * to the penalty of the ending, unless the condition is absolute, which makes the ending lost outright.
+ */
+struct ending
 {
-    // ``General'' ending
-    /*
-     Intelligence stat $ > 500$ and $ > $ than Sensitivity stat
-    Morality stat $ > 30$
-    Faith stat $ > 300$ and $ > $ than Sensitivity
-    ``Fighting reputation'' which is a sum of all fighting - related stats and skills, $ > 421$
-    */
-    const int fighter_reputation = std::get<0>(stats) + std::get<1>(stats)
-        + std::get<9>(stats) + std::get<10>(stats) + std::get<11>(stats);
-
-	// if sensitivity is higher than intelligence or faith, return an absolute instant loss
-    if (std::get<8>(stats) >= std::get<2>(stats) || std::get<8>(stats) >= std::get<6>(stats)) {
-        return std::numeric_limits<double>::max();
-	}
+    struct condition
+    {
+        StatsArray weights;
+        int threshold;
+        bool absolute = false;
+    };
 
-	double fitness_value = 0.0;
+    std::string name;
+    std::vector<condition> conditions;
 
-	// add penalty for intelligence below 500
-    if (std::get<2>(stats) < 500) {
-        fitness_value += (500 - std::get<2>(stats));
-	}
+    double penalty(const StatsArray& stats) const
+    {
+        double penalty = 0.0;
+        for (const auto& condition : conditions)
+        {
+            const int value = std::inner_product(stats.begin(), stats.end(), condition.weights.begin(), 0);
+            if (value >= condition.threshold)
+            {
+                continue;
+            }
+            if (condition.absolute)
+            {
+                return std::numeric_limits<double>::max();
+            }
+            penalty += condition.threshold - value;
+        }
+        return penalty;
+    }
+};
 
-	// add penalty for morality below 30
-    if (std::get<5>(stats) < 30) {
-        fitness_value += (30 - std::get<5>(stats));
-	}
+/** Weights of a condition of an ending, given as the indexes of the stats (see Stats) with their weights */
+StatsArray stat_weights(std::initializer_list<std::pair<std::size_t, int>> weights)
+{
+    StatsArray result{};
+    for (const auto& [stat, weight] : weights)
+    {
+        result[stat] += weight;
+    }
+    return result;
+}
 
-    // add penalty for faith below 300
-    if (std::get<6>(stats) < 300) {
-        fitness_value += (300 - std::get<6>(stats));
-	}
+/**
+ * Endings scored together from every trajectory by the multi-objective problem (see pm_endings_problem).
+ * The first one is the ending of the single-objective problem (see fitness).
+ */
+const std::vector<ending>& ending_registry()
+{
+    static const std::vector<ending> endings{
+        // intelligence > 500, morality > 30, faith > 300 and fighter reputation (the sum of all fighting-related stats
+        // and skills) > 421, losing outright if sensitivity is not below intelligence and faith;
+        // fitness_lower_bound bounds it for the pruning
+        { "General", {
+            { stat_weights({ { 2, 1 }, { 8, -1 } }), 1, true }, // intelligence > sensitivity
+            { stat_weights({ { 6, 1 }, { 8, -1 } }), 1, true }, // faith > sensitivity
+            { stat_weights({ { 2, 1 } }), 500 }, // intelligence
+            { stat_weights({ { 5, 1 } }), 30 }, // morality
+            { stat_weights({ { 6, 1 } }), 300 }, // faith
+            { stat_weights({ { 0, 1 }, { 1, 1 }, { 9, 1 }, { 10, 1 }, { 11, 1 } }), 421 }, // fighter reputation
+        } },
+        // social reputation (refinement, charisma, morality, decorum, art, eloquence) of 100 and no fighter reputation
+        { "Social", {
+            { stat_weights({ { 3, 1 }, { 4, 1 }, { 5, 1 }, { 15, 1 }, { 16, 1 }, { 17, 1 } }), 100 },
+            { stat_weights({ { 0, -1 }, { 1, -1 }, { 9, -1 }, { 10, -1 }, { 11, -1 } }), 0 },
+        } },
+    };
+    return endings;
+}
 
-	// add penalty for fighter reputation below 421
-    if (fighter_reputation < 421) {
-		fitness_value += (421 - fighter_reputation);
-	}
+/** Penalty of the ``General'' ending (see ending_registry), the lower the better */
+double fitness(const StatsArray& stats)
+{
+    return ending_registry().front().penalty(stats);
+}
 
-    return fitness_value;
+double fitness(const Stats& stats)
+{
+    return fitness(to_array(stats));
 }
 
 constexpr int T = 1200; // number of steps to take
 
-std::pair<std::vector<std::string>, double> simulate(const Inclinations& inclinations, fl::Engine* engine)
+/** Largest change in a single step, over all the actions, of each quantity that the fitness depends on */
+struct FitnessGains
 {
-    // Initialize a specimen
-    Stats stats{ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
-    std::vector<std::string> path{};
-
-    engine->restart();
+    int intelligence;
+    int morality;
+    int faith;
+    int fighter_reputation;
+    int intelligence_over_sensitivity;
+    int faith_over_sensitivity;
+};
 
-    // Set inclinations
-    engine->getInputVariable(0)->setValue(std::get<0>(inclinations));
-    engine->getInputVariable(1)->setValue(std::get<1>(inclinations));
-    engine->getInputVariable(2)->setValue(std::get<2>(inclinations));
-    engine->getInputVariable(3)->setValue(std::get<3>(inclinations));
-    engine->getInputVariable(4)->setValue(std::get<4>(inclinations));
+int fighter_reputation(const StatsArray& stats)
+{
+    return stats[0] + stats[1] + stats[9] + stats[10] + stats[11];
+}
 
-    for (int i = 0; i < T; ++i)
+FitnessGains fitness_gains(const ActionEffects& effects)
+{
+    constexpr int lowest = std::numeric_limits<int>::min();
+    FitnessGains gains{ lowest, lowest, lowest, lowest, lowest, lowest };
+    for (const auto& effect : effects)
     {
-        std::cout << "Step " << i + 1 << ":\n";
-        auto step = single_step(stats, inclinations, engine);
-
-        print_stats(stats);
-
-        path.push_back(step);
+        gains.intelligence = std::max(gains.intelligence, effect[2]);
+        gains.morality = std::max(gains.morality, effect[5]);
+        gains.faith = std::max(gains.faith, effect[6]);
+        gains.fighter_reputation = std::max(gains.fighter_reputation, fighter_reputation(effect));
+        gains.intelligence_over_sensitivity = std::max(gains.intelligence_over_sensitivity, effect[2] - effect[8]);
+        gains.faith_over_sensitivity = std::max(gains.faith_over_sensitivity, effect[6] - effect[8]);
     }
-
-    return std::make_pair(path, fitness(stats));
+    return gains;
 }
 
-using SimulationResult = std::pair<
-    /** Sequence of action names */
-    std::vector<std::string>,
-    /** Fitness value */
-    double>;
-
-void print_simulation_result(const SimulationResult& result)
+/**
+ * Lowest fitness that the specimen can still reach in the remaining steps, i.e., assuming
+ * that every penalty of the fitness is reduced as fast as the best action for it allows.
+ * Each step takes exactly one action, so the bound holds even if all the actions reduce a stat.
+ */
+double fitness_lower_bound(const StatsArray& stats, int remaining_steps, const FitnessGains& gains)
 {
-    std::cout << "Simulation Result:\n";
-    std::cout << "Fitness: " << result.second << "\n";
-    std::cout << "Actions taken:\n";
-    for (const auto& action : result.first)
+    // sensitivity can no longer end up below intelligence or faith: absolute instant loss
+    if (stats[2] - stats[8] + remaining_steps * gains.intelligence_over_sensitivity <= 0
+        || stats[6] - stats[8] + remaining_steps * gains.faith_over_sensitivity <= 0)
     {
-        std::cout << "- " << action << "\n";
+        return std::numeric_limits<double>::max();
     }
-}
 
+    const auto penalty = [remaining_steps](int target, int value, int gain) {
+        return std::max(0, target - (value + remaining_steps * gain));
+    };
+    return penalty(500, stats[2], gains.intelligence)
+        + penalty(30, stats[5], gains.morality)
+        + penalty(300, stats[6], gains.faith)
+        + penalty(421, fighter_reputation(stats), gains.fighter_reputation);
+}
 
-std::string choose_action_fast(fl::Engine* engine, const Stats& stats)
-{
-    // Load the specimen into the engine - assume that inclinations are already set
+/*
+ * Traces of the trajectories: every step of a traced trajectory is kept as a compact binary record in a buffer of
+ * the thread simulating it, and the trajectories that pass the trigger (see trace_trigger) are copied whole into
+ * a lock-free ring buffer of the thread, which a background thread drains into the trace file. The file is decoded
+ * offline to CSV or JSON by pm_solver --decode-trace FILE [--json] (see decode_trace).
+ * The records are written in the byte order of the host, like the messages between the islands.
+ */
 
-    engine->getInputVariable(5)->setValue(std::get<0>(stats));
-    engine->getInputVariable(6)->setValue(std::get<1>(stats));
-    engine->getInputVariable(7)->setValue(std::get<2>(stats));
-    engine->getInputVariable(8)->setValue(std::get<3>(stats));
-    engine->getInputVariable(9)->setValue(std::get<4>(stats));
-    engine->getInputVariable(10)->setValue(std::get<5>(stats));
-    engine->getInputVariable(11)->setValue(std::get<6>(stats));
-    engine->getInputVariable(12)->setValue(std::get<7>(stats));
-    engine->getInputVariable(13)->setValue(std::get<8>(stats));
-    engine->getInputVariable(14)->setValue(std::get<9>(stats));
-    engine->getInputVariable(15)->setValue(std::get<10>(stats));
-    engine->getInputVariable(16)->setValue(std::get<11>(stats));
-    engine->getInputVariable(17)->setValue(std::get<12>(stats));
-    engine->getInputVariable(18)->setValue(std::get<13>(stats));
-    engine->getInputVariable(19)->setValue(std::get<14>(stats));
-    engine->getInputVariable(20)->setValue(std::get<15>(stats));
-    engine->getInputVariable(21)->setValue(std::get<16>(stats));
-    engine->getInputVariable(22)->setValue(std::get<17>(stats));
-    engine->getInputVariable(23)->setValue(std::get<18>(stats));
-    engine->getInputVariable(24)->setValue(std::get<19>(stats));
-    engine->getInputVariable(25)->setValue(std::get<20>(stats));
+constexpr std::size_t max_traced_actions = 32;
 
-    // Get action priorities
-    engine->process();
+constexpr std::array<const char*, std::tuple_size_v<Stats>> stat_names{
+    "str", "con", "int", "ref", "cha", "mor", "fai", "sin", "sen",
+    "cs", "ca", "cd", "ms", "ma", "md", "dec", "art", "elo", "coo", "cle", "tem" };
 
-    const auto& output_vars = engine->outputVariables();
-    auto it = std::max_element(
-        output_vars.begin(), output_vars.end(),
-        [](const auto* a, const auto* b) {
-            // defaulting to 0 if the value is NaN
-            const auto left_priority = std::isnan(a->getValue()) ? 0.0 : a->getValue();
-            const auto right_priority = std::isnan(b->getValue()) ? 0.0 : b->getValue();
+/** A step of a traced trajectory: the action chosen, the priorities of all the actions and the stat changes */
+struct trace_step
+{
+    std::uint16_t step;
+    std::uint8_t action;
+    /** Fast-forwarded by trajectory_cycles without evaluating the engine, so without priorities */
+    std::uint8_t fast_forwarded;
+    std::array<std::int8_t, std::tuple_size_v<Stats>> deltas;
+    /** Always zero, in place of the padding before the priorities, whose bytes would be unspecified in the file */
+    std::array<std::uint8_t, 3> reserved{};
+    std::array<float, max_traced_actions> priorities;
+};
 
-            return left_priority < right_priority;
-        }
-    );
+// the records are copied to the trace file byte by byte, so every byte of them must be a member
+static_assert(sizeof(trace_step) == 4 + std::tuple_size_v<Stats> + 3 + max_traced_actions * sizeof(float));
 
-    // Either return the name of the action with the highest priority,
-    // or the first action if no rules fired (i.e., all priorities are 0).
-    std::string chosen_action_name = (it != output_vars.end())
-        ? (*it)->getName()
-        : (*output_vars.begin())->getName();
+/** A traced trajectory in the trace file, followed by its steps */
+struct trace_trajectory
+{
+    std::uint64_t id;
+    std::array<double, std::tuple_size_v<Inclinations>> inclinations;
+    /** Fitness at the end, or the lower bound of the fitness if the trajectory was pruned before T steps */
+    double fitness;
+    std::uint32_t steps;
+    /** Always zero, in place of the padding at the end, whose bytes would be unspecified in the file */
+    std::uint32_t reserved = 0;
+};
 
-    return chosen_action_name;
-}
+static_assert(sizeof(trace_trajectory) == 8 * (2 + std::tuple_size_v<Inclinations>) + 2 * sizeof(std::uint32_t));
 
-void single_step_fast(Stats& stats, fl::Engine* engine)
+/** Which trajectories are written to the trace file, all of them by default */
+struct trace_trigger
 {
-    // Choose an action based on the current stats and inclinations
-    std::string chosen_action_name = choose_action_fast(engine, stats);
-    // Apply the effects of the chosen action
-    Stats stats_diff = actions.at(chosen_action_name);
-    stats = sum_stats(stats, stats_diff);
-}
+    /** Only one in every sample_every trajectories, chosen before simulating them */
+    std::uint32_t sample_every = 1;
+    /** Only the trajectories ending with a fitness below this */
+    double fitness_below = std::numeric_limits<double>::infinity();
+    /** Only the trajectories better than all the ones traced before, i.e., the successive champions */
+    bool champions_only = false;
+};
 
-double simulate_fast(const Inclinations& inclinations, fl::Engine* engine)
+/**
+ * Writes the traced trajectories of all the threads to a trace file. Each thread commits its trajectories into a
+ * ring buffer of its own without locks, and drops them (counting them) if the ring is full.
+ */
+class trace_recorder
 {
-    // Initialize a specimen
-    Stats stats{ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+public:
+    ~trace_recorder()
+    {
+        stop();
+    }
 
-    engine->restart();
+    /** Starts tracing into the file, which keeps the names of the actions of the engine for the decoder */
+    void start(const std::string& path, const fl::Engine* engine, const trace_trigger& new_trigger)
+    {
+        if (engine->numberOfOutputVariables() > max_traced_actions)
+        {
+            throw std::invalid_argument("cannot trace more than " + std::to_string(max_traced_actions) + " actions");
+        }
+        file.open(path, std::ios::binary | std::ios::trunc);
+        if (!file)
+        {
+            throw std::runtime_error("cannot write the trace " + path);
+        }
+        file.write(magic, sizeof(magic));
+        write(version);
+        write(static_cast<std::uint32_t>(sizeof(trace_step)));
+        write(static_cast<std::uint32_t>(stat_names.size()));
+        write(static_cast<std::uint32_t>(engine->numberOfOutputVariables()));
+        for (const auto* output : engine->outputVariables())
+        {
+            write(static_cast<std::uint32_t>(output->getName().size()));
+            file.write(output->getName().data(), static_cast<std::streamsize>(output->getName().size()));
+        }
 
-    // Set inclinations
-    engine->getInputVariable(0)->setValue(std::get<0>(inclinations));
-    engine->getInputVariable(1)->setValue(std::get<1>(inclinations));
-    engine->getInputVariable(2)->setValue(std::get<2>(inclinations));
-    engine->getInputVariable(3)->setValue(std::get<3>(inclinations));
-    engine->getInputVariable(4)->setValue(std::get<4>(inclinations));
+        trigger = new_trigger;
+        enabled.store(true, std::memory_order_release);
+        flusher = std::jthread([this](std::stop_token stop) {
+            std::mutex wait_mutex;
+            std::condition_variable_any wake;
+            std::unique_lock lock(wait_mutex);
+            while (!stop.stop_requested())
+            {
+                wake.wait_for(lock, stop, std::chrono::milliseconds(20), [] { return false; });
+                drain();
+            }
+        });
+    }
 
-    for (int i = 0; i < T; ++i)
+    /** Stops tracing, writing what is left in the rings to the file */
+    void stop()
     {
-        single_step_fast(stats, engine);
+        if (!enabled.exchange(false))
+        {
+            return;
+        }
+        flusher = {};
+        drain();
+        file.close();
     }
 
-    return fitness(stats);
-}
-
-static auto engine = init(); // this is super slow but fuzzylite is not prepared for multithreading so we need to create a new engine for each call
+    bool active() const
+    {
+        return enabled.load(std::memory_order_relaxed);
+    }
 
-// Pagmo2-compatible problem definition
-struct pm_problem {
+    /** Identifies the next trajectory, and tells whether the sampling traces it */
+    std::optional<std::uint64_t> sample()
+    {
+        const auto id = next_id.fetch_add(1, std::memory_order_relaxed);
+        return id % trigger.sample_every == 0 ? std::optional(id) : std::nullopt;
+    }
 
-    // Implementation of the objective function.
-    pagmo::vector_double fitness(const pagmo::vector_double& dv) const
+    /** Writes the trajectory to the file if it passes the trigger */
+    void commit(const trace_trajectory& trajectory, const std::vector<trace_step>& steps)
     {
-        const Inclinations specimen{ dv[0], dv[1], dv[2], dv[3], dv[4] };
+        if (!(trajectory.fitness < trigger.fitness_below))
+        {
+            return;
+        }
+        if (trigger.champions_only)
+        {
+            double best = best_traced.load();
+            do
+            {
+                if (!(trajectory.fitness < best))
+                {
+                    return;
+                }
+            } while (!best_traced.compare_exchange_weak(best, trajectory.fitness));
+        }
 
-        std::unique_ptr<fl::Engine> engine_copy(engine.get()->clone()); // wrap in unique_ptr for automatic cleanup
+        if (thread_ring().push(trajectory, steps))
+        {
+            recorded_count.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            dropped_count.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
 
-        return { simulate_fast(specimen, engine_copy.get())};
+    std::uint64_t recorded() const
+    {
+        return recorded_count.load();
     }
 
-    /**
-     * Implementation of the box bounds.
-     * First element is the lower bound, second is the upper bound.
-     * Bounds are inclination values for five our inclinations.
-     * 
-     * (Range is 0.0 - 1.0, we hope that Pagmo2 will correctly interpolate between them)
-     */
-    std::pair<pagmo::vector_double, pagmo::vector_double> get_bounds() const
+    std::uint64_t dropped() const
     {
-        return { {0., 0., 0., 0., 0.}, {1., 1., 1., 1., 1.} };
+        return dropped_count.load();
     }
-};
 
-void test_simulation(const Inclinations &specimen)
-{
-    std::unique_ptr<fl::Engine> engine_clone(engine.get()->clone());
-    const auto& result = simulate(
-        specimen,
-        engine_clone.get()
-    );
-    print_simulation_result(result);
-}
+    static constexpr char magic[4]{ 'P', 'M', 'T', 'R' };
+    static constexpr std::uint32_t version = 1;
 
-int main_debug()
-{
-    //// Example specimen with balanced inclinations
-    const Inclinations specimen{ 0.01, 0.2, 0.7, 0.9, 0.1 };
-    test_simulation(specimen);
-    return 0;
-}
+private:
+    /** Ring buffer of bytes with a single producer (its thread) and a single consumer (drain) */
+    class ring
+    {
+    public:
+        static constexpr std::size_t capacity = 1u << 22;
 
-int main()
-{
-    pagmo::problem prob(pm_problem{});
+        bool push(const trace_trajectory& trajectory, const std::vector<trace_step>& steps)
+        {
+            const std::size_t size = sizeof(trajectory) + steps.size() * sizeof(trace_step);
+            const auto head = write_position.load(std::memory_order_relaxed);
+            if (size > capacity - (head - read_position.load(std::memory_order_acquire)))
+            {
+                return false;
+            }
+            copy_in(head, &trajectory, sizeof(trajectory));
+            copy_in(head + sizeof(trajectory), steps.data(), steps.size() * sizeof(trace_step));
+            write_position.store(head + size, std::memory_order_release);
+            return true;
+        }
 
-    pagmo::algorithm algo(pagmo::sade(100));
+        void pop_into(std::ostream& out)
+        {
+            const auto tail = read_position.load(std::memory_order_relaxed);
+            const auto head = write_position.load(std::memory_order_acquire);
+            const std::size_t begin = tail % capacity;
+            const std::size_t size = head - tail;
+            const std::size_t first = std::min(size, capacity - begin);
+            out.write(bytes.get() + begin, static_cast<std::streamsize>(first));
+            out.write(bytes.get(), static_cast<std::streamsize>(size - first));
+            read_position.store(head, std::memory_order_release);
+        }
 
-    pagmo::archipelago archi(16u, algo, prob, 20u);
+    private:
+        void copy_in(std::uint64_t position, const void* data, std::size_t size)
+        {
+            const std::size_t begin = position % capacity;
+            const std::size_t first = std::min(size, capacity - begin);
+            std::memcpy(bytes.get() + begin, data, first);
+            std::memcpy(bytes.get(), static_cast<const char*>(data) + first, size - first);
+        }
 
-    archi.evolve(10);
+        std::unique_ptr<char[]> bytes = std::make_unique<char[]>(capacity);
+        std::atomic<std::uint64_t> write_position{ 0 };
+        std::atomic<std::uint64_t> read_position{ 0 };
+    };
 
-    archi.wait_check();
+    /** Ring of the calling thread, kept by the recorder after the thread ends so it is still drained */
+    ring& thread_ring()
+    {
+        thread_local ring* mine = nullptr;
+        if (!mine)
+        {
+            std::lock_guard lock(mutex);
+            mine = rings.emplace_back(std::make_unique<ring>()).get();
+        }
+        return *mine;
+    }
 
-    pagmo::vector_double best_champion;
-	double best_fitness = std::numeric_limits<double>::max();
+    void drain()
+    {
+        std::lock_guard lock(mutex);
+        for (const auto& thread : rings)
+        {
+            thread->pop_into(file);
+        }
+        file.flush();
+    }
 
-    for (const auto& isl : archi)
+    template <typename T>
+    void write(const T& value)
     {
-        const auto& champion = isl.get_population().champion_x();
-        std::cout << "island champion: {" << champion[0] << ", " << champion[1] << ", " << champion[2] << ", " << champion[3] << ", " << champion[4] << "}";
-		std::cout << " with fitness: " << isl.get_population().champion_f()[0] << "\n";
+        file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
 
-        if (isl.get_population().champion_f()[0] < best_fitness)
+    trace_trigger trigger;
+    std::atomic<bool> enabled{ false };
+    std::atomic<std::uint64_t> next_id{ 0 };
+    std::atomic<double> best_traced{ std::numeric_limits<double>::infinity() };
+    std::atomic<std::uint64_t> recorded_count{ 0 };
+    std::atomic<std::uint64_t> dropped_count{ 0 };
+    std::mutex mutex; // guards the rings and the file
+    std::deque<std::unique_ptr<ring>> rings;
+    std::ofstream file;
+    std::jthread flusher; // last, so it stops before the rest is destroyed
+};
+
+trace_recorder& shared_trace_recorder()
+{
+    static trace_recorder recorder;
+    return recorder;
+}
+
+/** Steps of the trajectory being simulated by a thread, committed to the recorder when it ends */
+class trajectory_trace
+{
+public:
+    /** Starts tracing the trajectory of the specimen if the recorder is tracing and samples it */
+    bool start(const Inclinations& specimen)
+    {
+        auto& recorder = shared_trace_recorder();
+        const auto id = recorder.active() ? recorder.sample() : std::nullopt;
+        if (!id)
         {
-            best_fitness = isl.get_population().champion_f()[0];
-            best_champion = champion;
+            return false;
         }
+        trajectory = { *id, { std::get<0>(specimen), std::get<1>(specimen), std::get<2>(specimen),
+            std::get<3>(specimen), std::get<4>(specimen) }, 0.0, 0 };
+        steps.clear();
+        steps.reserve(T);
+        return true;
     }
 
-
-    test_simulation({ best_champion[0], best_champion[1], best_champion[2], best_champion[3], best_champion[4] });
+    /** Records a step, without priorities if the engine was not evaluated for it */
+    void step(int step, std::size_t action, const StatsArray& deltas, const double* priorities = nullptr,
+        std::size_t count = 0)
+    {
+        trace_step& record = steps.emplace_back();
+        record.step = static_cast<std::uint16_t>(step);
+        record.action = static_cast<std::uint8_t>(action);
+        record.fast_forwarded = priorities == nullptr;
+        for (std::size_t i = 0; i < deltas.size(); ++i)
+        {
+            record.deltas[i] = static_cast<std::int8_t>(std::clamp(deltas[i], -128, 127));
+        }
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            record.priorities[i] = static_cast<float>(priorities[i]);
+        }
+    }
+
+    void finish(double fitness)
+    {
+        trajectory.fitness = fitness;
+        trajectory.steps = static_cast<std::uint32_t>(steps.size());
+        shared_trace_recorder().commit(trajectory, steps);
+    }
+
+private:
+    trace_trajectory trajectory{};
+    std::vector<trace_step> steps;
+};
+
+/**
+ * Writes the trace file as CSV (a row per step, with the trajectory it belongs to) or JSON (the trajectories
+ * with their steps) to the output, with the actions and the stats by name.
+ */
+int decode_trace(const std::string& path, bool json, std::ostream& out)
+{
+    std::ifstream file(path, std::ios::binary);
+    const auto read = [&file, &path](auto& value) {
+        if (!file.read(reinterpret_cast<char*>(&value), sizeof(value)))
+        {
+            throw std::runtime_error("truncated trace " + path);
+        }
+    };
+    char magic[4]{};
+    std::uint32_t version = 0, step_size = 0, stat_count = 0, action_count = 0;
+    read(magic);
+    read(version);
+    read(step_size);
+    read(stat_count);
+    read(action_count);
+    if (!std::equal(std::begin(magic), std::end(magic), std::begin(trace_recorder::magic))
+        || version != trace_recorder::version || step_size != sizeof(trace_step) || stat_count != stat_names.size()
+        || action_count > max_traced_actions)
+    {
+        throw std::runtime_error("not a trace of this version of pm_solver: " + path);
+    }
+    std::vector<std::string> action_names(action_count);
+    for (auto& name : action_names)
+    {
+        std::uint32_t length = 0;
+        read(length);
+        name.resize(length);
+        if (!file.read(name.data(), length))
+        {
+            throw std::runtime_error("truncated trace " + path);
+        }
+    }
+
+    if (json)
+    {
+        out << "{\"actions\": [";
+        for (std::size_t a = 0; a < action_names.size(); ++a)
+            out << (a ? ", " : "") << std::quoted(action_names[a]);
+        out << "], \"stats\": [";
+        for (std::size_t s = 0; s < stat_names.size(); ++s)
+            out << (s ? ", " : "") << std::quoted(stat_names[s]);
+        out << "], \"trajectories\": [";
+    }
+    else
+    {
+        out << "trajectory,fighting,magic,housekeeping,artistry,sinfulness,fitness,step,action,fast_forwarded";
+        for (const auto* stat : stat_names)
+            out << ",delta_" << stat;
+        for (const auto& action : action_names)
+            out << ",priority_" << action;
+        out << "\n";
+    }
+
+    out << std::setprecision(std::numeric_limits<float>::max_digits10);
+    trace_trajectory trajectory{};
+    trace_step record{};
+    for (bool first = true; file.peek() != std::ifstream::traits_type::eof(); first = false)
+    {
+        read(trajectory);
+        if (json)
+        {
+            out << (first ? "" : ",") << "\n  {\"id\": " << trajectory.id << ", \"inclinations\": [";
+            for (std::size_t i = 0; i < trajectory.inclinations.size(); ++i)
+                out << (i ? ", " : "") << trajectory.inclinations[i];
+            out << "], \"fitness\": " << trajectory.fitness << ", \"steps\": [";
+        }
+        for (std::uint32_t s = 0; s < trajectory.steps; ++s)
+        {
+            read(record);
+            if (record.action >= action_count)
+            {
+                throw std::runtime_error("corrupt trace " + path);
+            }
+            if (json)
+            {
+                out << (s ? "," : "") << "\n    {\"step\": " << record.step << ", \"action\": "
+                    << std::quoted(action_names[record.action]) << ", \"fast_forwarded\": "
+                    << (record.fast_forwarded ? "true" : "false") << ", \"deltas\": [";
+                for (std::size_t i = 0; i < record.deltas.size(); ++i)
+                    out << (i ? ", " : "") << int{ record.deltas[i] };
+                out << "], \"priorities\": ";
+                if (record.fast_forwarded)
+                {
+                    out << "null}";
+                    continue;
+                }
+                out << "[";
+                for (std::size_t i = 0; i < action_count; ++i)
+                    out << (i ? ", " : "") << (std::isnan(record.priorities[i]) ? 0.0f : record.priorities[i]);
+                out << "]}";
+            }
+            else
+            {
+                out << trajectory.id;
+                for (const double inclination : trajectory.inclinations)
+                    out << "," << inclination;
+                out << "," << trajectory.fitness << "," << record.step << "," << action_names[record.action] << ","
+                    << int{ record.fast_forwarded };
+                for (const auto delta : record.deltas)
+                    out << "," << int{ delta };
+                for (std::size_t i = 0; i < action_count; ++i)
+                {
+                    out << ",";
+                    if (!record.fast_forwarded)
+                        out << record.priorities[i];
+                }
+                out << "\n";
+            }
+        }
+        if (json)
+        {
+            out << (trajectory.steps ? "\n  " : "") << "]}";
+        }
+    }
+    if (json)
+    {
+        out << "\n]}\n";
+    }
+    return 0;
+}
+
+/** Trajectory of the specimen step by step, traced if the trace recorder is tracing (see trace_recorder) */
+std::pair<std::vector<std::string>, double> simulate(const Inclinations& inclinations, fl::Engine* engine)
+{
+    // Initialize a specimen
+    Stats stats{ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+    std::vector<std::string> path{};
+    trajectory_trace trace;
+    const bool traced = trace.start(inclinations);
+    std::vector<double> priorities(engine->numberOfOutputVariables());
+
+    engine->restart();
+
+    // Set inclinations
+    engine->getInputVariable(0)->setValue(std::get<0>(inclinations));
+    engine->getInputVariable(1)->setValue(std::get<1>(inclinations));
+    engine->getInputVariable(2)->setValue(std::get<2>(inclinations));
+    engine->getInputVariable(3)->setValue(std::get<3>(inclinations));
+    engine->getInputVariable(4)->setValue(std::get<4>(inclinations));
+
+    for (int i = 0; i < T; ++i)
+    {
+        auto step = single_step(stats, inclinations, engine);
+        if (traced)
+        {
+            std::size_t action = 0;
+            for (std::size_t o = 0; o < priorities.size(); ++o)
+            {
+                priorities[o] = engine->getOutputVariable(o)->getValue();
+                if (engine->getOutputVariable(o)->getName() == step)
+                {
+                    action = o;
+                }
+            }
+            trace.step(i, action, to_array(actions.at(step)), priorities.data(), priorities.size());
+        }
+
+        path.push_back(step);
+    }
+
+    const double result = fitness(stats);
+    if (traced)
+    {
+        trace.finish(result);
+    }
+    return std::make_pair(path, result);
+}
+
+using SimulationResult = std::pair<
+    /** Sequence of action names */
+    std::vector<std::string>,
+    /** Fitness value */
+    double>;
+
+void print_simulation_result(const SimulationResult& result)
+{
+    std::cout << "Simulation Result:\n";
+    std::cout << "Fitness: " << result.second << "\n";
+    std::cout << "Actions taken:\n";
+    for (const auto& action : result.first)
+    {
+        std::cout << "- " << action << "\n";
+    }
+}
+
+
+std::size_t choose_action_fast(const fl::Engine* engine, fl::EngineState& state, const StatsArray& stats)
+{
+    // Load the specimen into the engine state after the inclinations - assume that inclinations are already set
+    for (std::size_t i = 0; i < stats.size(); ++i)
+    {
+        state.setInputValue(5 + i, stats[i]);
+    }
+
+    // Get action priorities, the shared engine itself is not modified.
+    // Only the stats changed by the previous action are re-evaluated, the state caches the rest
+    engine->update(state);
+
+    const auto& priorities = state.outputValues();
+    return choose_action_index(priorities.data(), priorities.size());
+}
+
+void single_step_fast(StatsArray& stats, const fl::Engine* engine, fl::EngineState& state, const ActionEffects& effects)
+{
+    // Choose an action based on the current stats and inclinations, and apply its effects
+    apply_action(stats, effects[choose_action_fast(engine, state, stats)]);
+}
+
+/**
+ * Values of each stat that the engine cannot tell apart: the membership of every term of its input variable is the
+ * same for all the values up to below, and for all the values from above (e.g., beyond the ends of the ramps).
+ * The stats have no such values when the engine may see them otherwise (e.g., through Linear or Function terms).
+ */
+struct StatSaturation
+{
+    std::array<double, std::tuple_size_v<StatsArray>> below;
+    std::array<double, std::tuple_size_v<StatsArray>> above;
+
+    /** No stat has such values, so no cycle is fast-forwarded (see trajectory_cycles) */
+    static StatSaturation none()
+    {
+        constexpr double infinity = std::numeric_limits<double>::infinity();
+        StatSaturation saturation;
+        saturation.below.fill(-infinity);
+        saturation.above.fill(infinity);
+        return saturation;
+    }
+
+    /** Whether any stat has such values */
+    bool any() const
+    {
+        return std::ranges::any_of(below, [](double value) { return !std::isinf(value); })
+            || std::ranges::any_of(above, [](double value) { return !std::isinf(value); });
+    }
+};
+
+StatSaturation saturation_bounds(const fl::Engine* engine)
+{
+    constexpr double infinity = std::numeric_limits<double>::infinity();
+    StatSaturation saturation = StatSaturation::none();
+
+    // the priorities must depend only on the memberships of the inputs, and not on the previous priorities
+    for (const auto* output : engine->outputVariables())
+    {
+        if (output->isLockPreviousValue())
+            return saturation;
+        for (const auto* term : output->terms())
+        {
+            if (dynamic_cast<const fl::Linear*>(term) || dynamic_cast<const fl::Function*>(term))
+                return saturation;
+        }
+    }
+    for (const auto* input : engine->inputVariables())
+    {
+        for (const auto* term : input->terms())
+        {
+            if (dynamic_cast<const fl::Function*>(term))
+                return saturation;
+        }
+    }
+
+    for (std::size_t i = 0; i < saturation.below.size(); ++i)
+    {
+        const fl::InputVariable* input = engine->getInputVariable(5 + i);
+        // constant everywhere until a term says otherwise, the bounds of the shapes other than ramps are excluded
+        double below = infinity;
+        double above = -infinity;
+        const auto exclusive = [&](double start, double end) {
+            below = std::min(below, std::nextafter(start, -infinity));
+            above = std::max(above, std::nextafter(end, infinity));
+        };
+        for (const auto* term : input->terms())
+        {
+            if (const auto* ramp = dynamic_cast<const fl::Ramp*>(term))
+            {
+                below = std::min({ below, ramp->getStart(), ramp->getEnd() });
+                above = std::max({ above, ramp->getStart(), ramp->getEnd() });
+            }
+            else if (const auto* triangle = dynamic_cast<const fl::Triangle*>(term))
+                exclusive(triangle->getVertexA(), triangle->getVertexC());
+            else if (const auto* trapezoid = dynamic_cast<const fl::Trapezoid*>(term))
+                exclusive(trapezoid->getVertexA(), trapezoid->getVertexD());
+            else if (const auto* rectangle = dynamic_cast<const fl::Rectangle*>(term))
+                exclusive(rectangle->getStart(), rectangle->getEnd());
+            else if (!dynamic_cast<const fl::Constant*>(term))
+            {
+                below = -infinity;
+                above = infinity;
+                break;
+            }
+        }
+        // the values out of a locked range are the same as its ends
+        if (input->isLockValueInRange())
+        {
+            below = std::max(below, input->getMinimum());
+            above = std::min(above, input->getMaximum());
+        }
+        saturation.below[i] = below;
+        saturation.above[i] = above;
+    }
+    return saturation;
+}
+
+/**
+ * Detects the trajectories that repeat a cycle of actions so that the next cycles need no engine evaluations.
+ * The stats before each step of a cycle repeat as well, shifted by the sum of the effects of the cycle, so if every
+ * stat that the cycle changes stays where the engine cannot tell its values apart (see StatSaturation), the engine
+ * chooses the same actions in the next cycles as in the last one, and the results do not change.
+ * The engine is evaluated again once the remaining steps are fewer than a cycle, or a stat would leave its bounds.
+ * Looking for the cycles costs every step, while about 1% of the steps are in cycles: it saves about as much as it
+ * costs on the engine state, and costs more than it saves on the native engine (see the simulate_*_cycles stages of
+ * pm_solver_bench), so the solver only fast-forwards the cycles with --fast-forward.
+ */
+class trajectory_cycles
+{
+public:
+    static constexpr std::size_t max_length = 8;
+
+    explicit trajectory_cycles(const StatSaturation& saturation) : saturation(saturation) {}
+
+    /** Records the action about to be taken from the given stats */
+    void record(const StatsArray& stats, std::size_t action)
+    {
+        actions[recorded % actions.size()] = action;
+        stats_before[recorded % stats_before.size()] = stats;
+        ++recorded;
+    }
+
+    /**
+     * Number of steps that can be taken from the given stats, after the last recorded action, repeating the cycle
+     * given by action(), or 0 if the trajectory is not in such a cycle
+     */
+    int skippable_steps(const StatsArray& stats, int remaining_steps)
+    {
+        for (std::size_t length = 1; length <= max_length; ++length)
+        {
+            if (recorded < 2 * length || remaining_steps < static_cast<int>(length))
+                break;
+            bool repeats = true;
+            for (std::size_t k = 0; repeats && k < length; ++k)
+                repeats = recent_action(k) == recent_action(k + length);
+            if (!repeats)
+                continue;
+
+            const StatsArray& start = recent_stats(length - 1);
+            double cycles = remaining_steps / static_cast<int>(length);
+            for (std::size_t s = 0; cycles > 0 && s < stats.size(); ++s)
+            {
+                const int delta = stats[s] - start[s];
+                for (std::size_t step = 0; delta != 0 && cycles > 0 && step < length; ++step)
+                    cycles = std::min(cycles, saturated_cycles(recent_stats(step)[s], delta, s));
+            }
+            if (cycles >= 1)
+            {
+                for (std::size_t step = 0; step < length; ++step)
+                    cycle[step] = recent_action(length - 1 - step);
+                cycle_length = length;
+                recorded = 0;
+                return static_cast<int>(cycles) * static_cast<int>(length);
+            }
+        }
+        return 0;
+    }
+
+    /** Action of the given step, counted from the first skippable step */
+    std::size_t action(int step) const
+    {
+        return cycle[static_cast<std::size_t>(step) % cycle_length];
+    }
+
+private:
+    std::size_t recent_action(std::size_t ago) const
+    {
+        return actions[(recorded - 1 - ago) % actions.size()];
+    }
+
+    const StatsArray& recent_stats(std::size_t ago) const
+    {
+        return stats_before[(recorded - 1 - ago) % stats_before.size()];
+    }
+
+    /** Number of cycles that the stat can change by delta without leaving the bound where its value is */
+    double saturated_cycles(int value, int delta, std::size_t stat) const
+    {
+        if (value <= saturation.below[stat])
+            return delta < 0 ? std::numeric_limits<double>::infinity() : std::floor((saturation.below[stat] - value) / delta);
+        if (value >= saturation.above[stat])
+            return delta > 0 ? std::numeric_limits<double>::infinity() : std::floor((value - saturation.above[stat]) / -delta);
+        return 0;
+    }
+
+    const StatSaturation& saturation;
+    std::array<std::size_t, 2 * max_length> actions{};
+    std::array<StatsArray, max_length> stats_before{};
+    std::size_t recorded = 0;
+    std::array<std::size_t, max_length> cycle{};
+    std::size_t cycle_length = 1;
+};
+
+/** Stats after T steps extrapolated linearly from the stats after the given steps, for the cheaper simulations */
+StatsArray extrapolate(StatsArray stats, int steps)
+{
+    if (steps < T)
+    {
+        for (int& stat : stats)
+        {
+            stat = static_cast<int>(std::lround(static_cast<double>(stat) * T / steps));
+        }
+    }
+    return stats;
+}
+
+/**
+ * Fitness of the specimen after T steps, where choose_action gives the action of the engine for the stats, whose
+ * inclinations are already set, leaving the priorities of the actions in priorities.
+ * The simulation stops early once the specimen provably cannot end up with a fitness better than (or equal to) the
+ * cutoff, returning std::numeric_limits<double>::max() instead, like a lost simulation: the result is the fitness if
+ * it is not worse than the cutoff and the maximum otherwise, whatever the step the simulation stopped at, so the
+ * specimens worse than the cutoff all rank last, and never ahead of those that are simulated in full.
+ * The cycles of actions that the engine would repeat are fast-forwarded without it (see trajectory_cycles), unless no
+ * stat saturates, in which case the cycles are not even looked for.
+ * A horizon shorter than T simulates fewer steps, and their stats are extrapolated to T (see fidelity_level), without
+ * stopping early whatever the cutoff.
+ * The stats at the end are also given in end_stats if any, unless the simulation stopped early, to score other endings.
+ * Every step is recorded in the trace if any, the fast-forwarded ones without their priorities.
+ */
+template <typename ChooseAction>
+double simulate_trajectory(
+    const ActionEffects& effects, const StatSaturation& saturation, double cutoff, int horizon, StatsArray* end_stats,
+    trajectory_trace* trace, std::span<const double> priorities, ChooseAction&& choose_action)
+{
+    StatsArray stats{};
+    // the bounds hold for the stats after T steps, not for those extrapolated from a shorter horizon
+    const bool pruning = cutoff < std::numeric_limits<double>::max() && horizon == T;
+    const FitnessGains gains = fitness_gains(effects);
+    const bool fast_forward = saturation.any();
+    trajectory_cycles cycles(saturation);
+    for (int i = 0; i < horizon; ++i)
+    {
+        const std::size_t action = choose_action(stats);
+        if (trace)
+        {
+            trace->step(i, action, effects[action], priorities.data(), priorities.size());
+        }
+        if (fast_forward)
+        {
+            cycles.record(stats, action);
+        }
+        apply_action(stats, effects[action]);
+
+        // the steps of the cycles are taken one by one, so the pruning stops at the same step as without them
+        const int skipped = fast_forward ? cycles.skippable_steps(stats, horizon - i - 1) : 0;
+        for (int step = 0; step <= skipped; ++step)
+        {
+            if (step > 0)
+            {
+                apply_action(stats, effects[cycles.action(step - 1)]);
+                ++i;
+                if (trace)
+                {
+                    trace->step(i, cycles.action(step - 1), effects[cycles.action(step - 1)]);
+                }
+            }
+            if (pruning)
+            {
+                if (fitness_lower_bound(stats, T - i - 1, gains) > cutoff)
+                {
+                    return std::numeric_limits<double>::max();
+                }
+            }
+        }
+    }
+
+    stats = extrapolate(stats, horizon);
+    if (end_stats)
+    {
+        *end_stats = stats;
+    }
+    return fitness(stats);
+}
+
+/** Fitness of the specimen after T steps on the engine state (see simulate_trajectory) */
+double simulate_fast(
+    const Inclinations& inclinations, const fl::Engine* engine, fl::EngineState& state, const ActionEffects& effects,
+    const StatSaturation& saturation, double cutoff = std::numeric_limits<double>::max(), int horizon = T,
+    StatsArray* end_stats = nullptr, trajectory_trace* trace = nullptr)
+{
+    state.restart();
+
+    // Set inclinations
+    state.setInputValue(0, std::get<0>(inclinations));
+    state.setInputValue(1, std::get<1>(inclinations));
+    state.setInputValue(2, std::get<2>(inclinations));
+    state.setInputValue(3, std::get<3>(inclinations));
+    state.setInputValue(4, std::get<4>(inclinations));
+
+    return simulate_trajectory(effects, saturation, cutoff, horizon, end_stats, trace, state.outputValues(),
+        [&](const StatsArray& stats) { return choose_action_fast(engine, state, stats); });
+}
+
+#ifdef PM_SOLVER_NATIVE_ENGINE
+/**
+ * Same as simulate_fast, but evaluates the engine compiled to native code from Baseline.fll,
+ * which gives the same priorities as Engine::process without virtual calls or allocations.
+ */
+double simulate_native(
+    const Inclinations& inclinations, const ActionEffects& effects, const StatSaturation& saturation,
+    double cutoff = std::numeric_limits<double>::max(), int horizon = T, StatsArray* end_stats = nullptr,
+    trajectory_trace* trace = nullptr)
+{
+    double inputs[Baseline::numberOfInputVariables]{
+        std::get<0>(inclinations),
+        std::get<1>(inclinations),
+        std::get<2>(inclinations),
+        std::get<3>(inclinations),
+        std::get<4>(inclinations),
+    };
+    double priorities[Baseline::numberOfOutputVariables];
+    double previous_priorities[Baseline::numberOfOutputVariables];
+    std::fill(std::begin(priorities), std::end(priorities), fl::nan);
+    std::fill(std::begin(previous_priorities), std::end(previous_priorities), fl::nan);
+
+    return simulate_trajectory(effects, saturation, cutoff, horizon, end_stats, trace, priorities,
+        [&](const StatsArray& stats) {
+            // Load the specimen into the inputs after the inclinations
+            std::copy(stats.begin(), stats.end(), inputs + 5);
+            Baseline::process(inputs, priorities, previous_priorities);
+            return choose_action_index(priorities, Baseline::numberOfOutputVariables);
+        });
+}
+
+/** The native engine is generated from the Baseline.fll in the sources, make sure it matches the one loaded */
+void check_native_engine(const fl::Engine* engine)
+{
+    bool matches = engine->numberOfInputVariables() == Baseline::numberOfInputVariables
+        && engine->numberOfOutputVariables() == Baseline::numberOfOutputVariables;
+    for (std::size_t i = 0; matches && i < Baseline::numberOfInputVariables; ++i)
+        matches = engine->getInputVariable(i)->getName() == Baseline::inputVariables[i];
+    for (std::size_t i = 0; matches && i < Baseline::numberOfOutputVariables; ++i)
+        matches = engine->getOutputVariable(i)->getName() == Baseline::outputVariables[i];
+    if (!matches)
+        throw fl::Exception("[engine error] the native engine does not match engine <" + engine->getName() + ">, rebuild the solver");
+}
+#endif
+
+/** Random change of a stat by an action, uniform between low and high (inclusive) */
+struct stat_range
+{
+    std::size_t stat;
+    int low;
+    int high;
+};
+
+/** Level of the classes in the charts of the game, the fixed changes of the actions table being those of adept */
+enum class class_level { novice, adept, expert, master };
+
+constexpr std::array<const char*, 4> class_level_names{ "novice", "adept", "expert", "master" };
+
+/**
+ * Random ranges of the stat changes of the actions, as given by the charts of the game quoted in the actions table,
+ * all at the same level of the classes, which replace the fixed changes of the table; the other changes stay fixed.
+ * Only used by the stochastic simulation (see simulate_stochastic).
+ */
+std::unordered_map<std::string, std::vector<stat_range>> action_ranges(class_level level)
+{
+    // the lowest and highest change of the stat at every level, from novice to master
+    const auto at_level = [level](std::size_t stat, const std::array<std::pair<int, int>, 4>& ranges) {
+        const auto [low, high] = ranges[static_cast<std::size_t>(level)];
+        return stat_range{ stat, low, high };
+    };
+    return {
+        { "Hunting", { { 9, 0, 1 }, { 7, 0, 1 } } }, // combat skill and sin: random raise, +0 to 1/day
+        { "ScienceClass", {
+            at_level(2, { { { 1, 4 }, { 2, 6 }, { 3, 8 }, { 4, 12 } } }), // intelligence
+            at_level(6, { { { 0, 0 }, { -1, 0 }, { -2, 0 }, { -3, 0 } } }), // faith
+            at_level(14, { { { 0, 0 }, { -1, 0 }, { -1, 0 }, { -1, 0 } } }), // magical defense
+        } },
+        { "MannersClass", {
+            at_level(15, { { { 1, 1 }, { 1, 2 }, { 1, 3 }, { 1, 4 } } }), // decorum
+            at_level(3, { { { 1, 1 }, { 1, 2 }, { 1, 3 }, { 1, 4 } } }), // refinement
+        } },
+    };
+}
+
+/** Stat changes of an action split into the fixed ones and the random ones, which are left at 0 in fixed */
+struct StochasticEffect
+{
+    StatsArray fixed;
+    std::vector<stat_range> random;
+};
+
+/** Same as bind_actions, with the random ranges of the stat changes at the level of the classes */
+std::vector<StochasticEffect> bind_stochastic_actions(const fl::Engine* engine, class_level level)
+{
+    std::vector<StochasticEffect> effects;
+    for (const auto& fixed : bind_actions(engine))
+    {
+        effects.push_back({ fixed, {} });
+    }
+    const auto level_ranges = action_ranges(level);
+    for (std::size_t i = 0; i < engine->numberOfOutputVariables(); ++i)
+    {
+        const auto ranges = level_ranges.find(engine->getOutputVariable(i)->getName());
+        if (ranges == level_ranges.end())
+        {
+            continue;
+        }
+        for (const auto& range : ranges->second)
+        {
+            effects[i].fixed[range.stat] = 0;
+            effects[i].random.push_back(range);
+        }
+    }
+    return effects;
+}
+
+/**
+ * Counter-based random bits: a hash (the finalizer of SplitMix64) of the seed and the counters, so every replicate
+ * draws its numbers without any state, on any thread and in any order, and the same numbers for every specimen.
+ */
+std::uint64_t counter_random(std::uint64_t seed, std::uint64_t replicate, std::uint64_t step, std::uint64_t stat)
+{
+    const auto mix = [](std::uint64_t x) {
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+        return x ^ (x >> 31);
+    };
+    constexpr std::uint64_t golden = 0x9e3779b97f4a7c15ull;
+    return mix(mix(mix(seed + golden) + replicate * golden) + (step << 5 | stat));
+}
+
+/**
+ * Fitness of a replicate of the specimen with the random stat changes of the actions (see action_ranges),
+ * where choose_action gives the action of the engine for the stats, whose inclinations are already set.
+ * The random changes of a replicate depend only on the seed, the replicate, the step and the stat, so the specimens
+ * share them (common random numbers): their fitnesses differ because of their choices, not because of their luck.
+ * Neither pruned nor fast-forwarded, since the bounds and the cycles assume fixed changes.
+ */
+template <typename ChooseAction>
+double simulate_stochastic(
+    const std::vector<StochasticEffect>& effects, std::uint64_t seed, std::uint64_t replicate, ChooseAction&& choose_action)
+{
+    StatsArray stats{};
+    for (int i = 0; i < T; ++i)
+    {
+        const auto& effect = effects[choose_action(stats)];
+        apply_action(stats, effect.fixed);
+        for (const auto& range : effect.random)
+        {
+            const auto span = static_cast<std::uint64_t>(range.high - range.low + 1);
+            const auto bits = counter_random(seed, replicate, static_cast<std::uint64_t>(i), range.stat) >> 32;
+            stats[range.stat] += range.low + static_cast<int>((bits * span) >> 32);
+        }
+    }
+    return fitness(stats);
+}
+
+static auto engine = init(); // loaded once and shared read-only by all the islands, each thread evaluates it on its own fl::EngineState
+static const auto action_effects = bind_actions(engine.get()); // the native engine has the same output variables, see check_native_engine
+// none unless the cycles are fast-forwarded (see --fast-forward), set before any simulation
+static auto stat_saturation = StatSaturation::none();
+
+/** Stat changes of the actions for the stochastic simulation at every level of the classes, bound once */
+const std::vector<StochasticEffect>& stochastic_effects(class_level level)
+{
+    static const std::array<std::vector<StochasticEffect>, 4> effects{
+        bind_stochastic_actions(engine.get(), class_level::novice),
+        bind_stochastic_actions(engine.get(), class_level::adept),
+        bind_stochastic_actions(engine.get(), class_level::expert),
+        bind_stochastic_actions(engine.get(), class_level::master),
+    };
+    return effects[static_cast<std::size_t>(level)];
+}
+
+#ifdef FL_INSTRUMENT
+/**
+ * Engine state whose counters (see fl::Instrumentation) are merged into those of the whole run,
+ * as the states are per thread and live until the workers and the pagmo threads end.
+ */
+class instrumented_state : public fl::EngineState
+{
+public:
+    explicit instrumented_state(const fl::Engine* engine) : fl::EngineState(engine)
+    {
+        std::scoped_lock lock(mutex);
+        live.push_back(this);
+    }
+
+    instrumented_state(const instrumented_state&) = delete;
+    instrumented_state& operator=(const instrumented_state&) = delete;
+
+    ~instrumented_state() override
+    {
+        std::scoped_lock lock(mutex);
+        finished.merge(instrumentation());
+        std::erase(live, this);
+    }
+
+    /** Counters of every state so far, only consistent while no specimen is being evaluated */
+    static fl::Instrumentation merged()
+    {
+        std::scoped_lock lock(mutex);
+        fl::Instrumentation result(finished);
+        for (const auto* state : live)
+        {
+            result.merge(state->instrumentation());
+        }
+        return result;
+    }
+
+private:
+    static std::mutex mutex;
+    static std::vector<instrumented_state*> live;
+    static fl::Instrumentation finished;
+};
+
+std::mutex instrumented_state::mutex;
+std::vector<instrumented_state*> instrumented_state::live;
+fl::Instrumentation instrumented_state::finished;
+#endif
+
+/**
+ * Fitness of a single specimen, on an engine state per thread when the native engine is not used.
+ * See simulate_trajectory for the cutoff, and trace_recorder for the traces of the trajectories.
+ */
+double evaluate_specimen(const Inclinations& specimen, double cutoff)
+{
+    // only the sampled trajectories pay for the records of their steps
+    thread_local trajectory_trace trace;
+    trajectory_trace* const traced = trace.start(specimen) ? &trace : nullptr;
+#ifdef PM_SOLVER_NATIVE_ENGINE
+    const double result = simulate_native(specimen, action_effects, stat_saturation, cutoff, T, nullptr, traced);
+#else
+    // a few KB of values per thread instead of a deep copy of the whole engine per call
+#ifdef FL_INSTRUMENT
+    thread_local instrumented_state state(engine.get());
+#else
+    thread_local fl::EngineState state(engine.get());
+#endif
+
+    const double result = simulate_fast(specimen, engine.get(), state, action_effects, stat_saturation, cutoff, T,
+        nullptr, traced);
+#endif
+    if (traced)
+    {
+        traced->finish(result);
+    }
+    return result;
+}
+
+/** Penalty of every ending of the registry for a single specimen, from the same trajectory (see evaluate_specimen) */
+void evaluate_specimen_endings(const Inclinations& specimen, const std::vector<ending>& endings, double* penalties)
+{
+    StatsArray stats{};
+#ifdef PM_SOLVER_NATIVE_ENGINE
+    simulate_native(specimen, action_effects, stat_saturation, std::numeric_limits<double>::max(), T, &stats);
+#else
+#ifdef FL_INSTRUMENT
+    thread_local instrumented_state state(engine.get());
+#else
+    thread_local fl::EngineState state(engine.get());
+#endif
+    simulate_fast(specimen, engine.get(), state, action_effects, stat_saturation, std::numeric_limits<double>::max(), T,
+        &stats);
+#endif
+    for (std::size_t i = 0; i < endings.size(); ++i)
+    {
+        penalties[i] = endings[i].penalty(stats);
+    }
+}
+
+/**
+ * Stochastic simulation of the specimens: count replicates of each one, drawn from the seed, with the random stat
+ * changes of the classes at the level (see simulate_stochastic)
+ */
+struct stochastic_replicates
+{
+    std::uint64_t seed = 0;
+    std::uint32_t count = 30;
+    class_level level = class_level::adept;
+};
+
+/** Fitness of a single replicate of a specimen, on an engine state per thread when the native engine is not used */
+double evaluate_replicate(const Inclinations& specimen, const stochastic_replicates& stochastic, std::uint64_t replicate)
+{
+    const auto& effects = stochastic_effects(stochastic.level);
+#ifdef PM_SOLVER_NATIVE_ENGINE
+    double inputs[Baseline::numberOfInputVariables]{
+        std::get<0>(specimen),
+        std::get<1>(specimen),
+        std::get<2>(specimen),
+        std::get<3>(specimen),
+        std::get<4>(specimen),
+    };
+    double priorities[Baseline::numberOfOutputVariables];
+    double previous_priorities[Baseline::numberOfOutputVariables];
+    std::fill(std::begin(priorities), std::end(priorities), fl::nan);
+    std::fill(std::begin(previous_priorities), std::end(previous_priorities), fl::nan);
+    return simulate_stochastic(effects, stochastic.seed, replicate, [&](const StatsArray& stats) {
+        std::copy(stats.begin(), stats.end(), inputs + 5);
+        Baseline::process(inputs, priorities, previous_priorities);
+        return choose_action_index(priorities, Baseline::numberOfOutputVariables);
+    });
+#else
+#ifdef FL_INSTRUMENT
+    thread_local instrumented_state state(engine.get());
+#else
+    thread_local fl::EngineState state(engine.get());
+#endif
+    state.restart();
+    state.setInputValue(0, std::get<0>(specimen));
+    state.setInputValue(1, std::get<1>(specimen));
+    state.setInputValue(2, std::get<2>(specimen));
+    state.setInputValue(3, std::get<3>(specimen));
+    state.setInputValue(4, std::get<4>(specimen));
+    return simulate_stochastic(effects, stochastic.seed, replicate, [&](const StatsArray& stats) {
+        return choose_action_fast(engine.get(), state, stats);
+    });
+#endif
+}
+
+/** Mean fitness of the replicates of a specimen with the half width of its 95% confidence interval */
+struct replicate_summary
+{
+    double mean;
+    double half_width;
+};
+
+/**
+ * Mean and confidence interval (normal approximation, fine for tens of replicates) of the fitness of the replicates,
+ * which are lost outright if any of them is, as the fitness of a lost simulation cannot be averaged.
+ */
+replicate_summary summarize_replicates(const double* fitness, std::size_t count)
+{
+    constexpr double lost = std::numeric_limits<double>::max();
+    if (std::find(fitness, fitness + count, lost) != fitness + count)
+    {
+        return { lost, 0.0 };
+    }
+    const double mean = std::accumulate(fitness, fitness + count, 0.0) / count;
+    if (count < 2)
+    {
+        return { mean, std::numeric_limits<double>::infinity() };
+    }
+    double squares = 0.0;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        squares += (fitness[i] - mean) * (fitness[i] - mean);
+    }
+    return { mean, 1.96 * std::sqrt(squares / (count - 1) / count) };
+}
+
+/**
+ * A cheaper way of scoring the specimens than the full simulation (see multi_fidelity): a shorter horizon whose stats
+ * are extrapolated to T, a lower resolution of the integral defuzzifiers of the engine, or both.
+ * The resolution only changes the defuzzifiers that integrate numerically, i.e., not the Centroid of piecewise
+ * linear terms, and it needs the engine instead of the native one.
+ */
+struct fidelity_level
+{
+    int horizon = T;
+    /** Resolution of the integral defuzzifiers, or 0 to keep the resolution of the engine */
+    int resolution = 0;
+    /** Fraction of the specimens scored at this level that are promoted to the next one */
+    double promoted = 0.5;
+};
+
+/** Copy of the engine with the given resolution of its integral defuzzifiers, created once and shared read-only */
+const fl::Engine* engine_at_resolution(int resolution)
+{
+    static std::mutex mutex;
+    static std::map<int, std::unique_ptr<fl::Engine>> engines;
+    std::lock_guard lock(mutex);
+    auto& copy = engines[resolution];
+    if (!copy)
+    {
+        copy.reset(fl::FlbImporter().cloneEngine(engine.get()));
+        for (auto* output : copy->outputVariables())
+        {
+            if (auto* integral = dynamic_cast<fl::IntegralDefuzzifier*>(output->getDefuzzifier()))
+            {
+                integral->setResolution(resolution);
+            }
+        }
+    }
+    return copy.get();
+}
+
+/** Score of a single specimen at the given level of fidelity, on an engine state per thread and engine */
+double estimate_specimen(const Inclinations& specimen, const fidelity_level& level)
+{
+    constexpr double no_cutoff = std::numeric_limits<double>::max();
+#ifdef PM_SOLVER_NATIVE_ENGINE
+    if (level.resolution == 0)
+    {
+        return simulate_native(specimen, action_effects, stat_saturation, no_cutoff, level.horizon);
+    }
+#endif
+    const fl::Engine* level_engine = level.resolution == 0 ? engine.get() : engine_at_resolution(level.resolution);
+    thread_local std::map<const fl::Engine*, fl::EngineState> states;
+    auto& state = states.try_emplace(level_engine, level_engine).first->second;
+    return simulate_fast(specimen, level_engine, state, action_effects, stat_saturation, no_cutoff, level.horizon);
+}
+
+/**
+ * Persistent pool of worker threads evaluating whole batches of specimens,
+ * each worker keeping its own engine state between batches (see evaluate_specimen).
+ * The thread submitting a batch also evaluates its specimens, so the islands
+ * submitting batches concurrently share the workers without waiting idle.
+ */
+class evaluation_pool
+{
+public:
+    explicit evaluation_pool(std::size_t worker_count)
+    {
+        start(worker_count);
+    }
+
+    ~evaluation_pool()
+    {
+        for (auto& worker : workers)
+        {
+            worker.request_stop();
+        }
+        // the workers are joined when destroyed
+    }
+
+    /** Replaces the workers with the given number of them, which must happen while no batch is evaluated */
+    void resize(std::size_t worker_count)
+    {
+        for (auto& worker : workers)
+        {
+            worker.request_stop();
+        }
+        workers.clear(); // joins them
+        start(worker_count);
+    }
+
+    /**
+     * Fitness of each specimen in the batch, given one after the other as pagmo does,
+     * or their scores at the given level of fidelity if any
+     */
+    pagmo::vector_double evaluate(const pagmo::vector_double& dvs, double cutoff, const fidelity_level* level = nullptr)
+    {
+        batch job{ dvs, cutoff, level, nullptr, nullptr };
+        return run(job);
+    }
+
+    /**
+     * Fitness of every replicate of each specimen in the batch, the replicates of a specimen one after the other,
+     * which are spread over the workers, and are the same regardless of the number of workers
+     */
+    pagmo::vector_double evaluate_replicates(const pagmo::vector_double& dvs, const stochastic_replicates& stochastic)
+    {
+        batch job{ dvs, std::numeric_limits<double>::max(), nullptr, nullptr, &stochastic };
+        return run(job);
+    }
+
+    /** Penalties of the given endings for each specimen in the batch, the endings of a specimen one after the other */
+    pagmo::vector_double evaluate_endings(const pagmo::vector_double& dvs, const std::vector<ending>& endings)
+    {
+        batch job{ dvs, std::numeric_limits<double>::max(), nullptr, &endings, nullptr };
+        return run(job);
+    }
+
+private:
+    static constexpr std::size_t dimension = std::tuple_size_v<Inclinations>;
+
+    struct batch
+    {
+        batch(const pagmo::vector_double& dvs, double cutoff, const fidelity_level* level,
+            const std::vector<ending>* endings, const stochastic_replicates* stochastic)
+            : dvs(dvs), cutoff(cutoff), level(level), endings(endings), stochastic(stochastic),
+            size(dvs.size() / dimension * (stochastic ? stochastic->count : 1)),
+            fitness(size * (endings ? endings->size() : 1)) {}
+
+        const pagmo::vector_double& dvs;
+        const double cutoff;
+        const fidelity_level* level;
+        const std::vector<ending>* endings;
+        const stochastic_replicates* stochastic;
+        const std::size_t size; // of the tasks, i.e., the specimens or their replicates
+        pagmo::vector_double fitness;
+        std::size_t next = 0; // guarded by the pool mutex
+        std::size_t finished = 0; // guarded by the batch mutex
+        std::mutex mutex;
+        std::condition_variable done;
+    };
+
+    void start(std::size_t worker_count)
+    {
+        workers.reserve(worker_count);
+        for (std::size_t i = 0; i < worker_count; ++i)
+        {
+            workers.emplace_back([this](std::stop_token stop) { work(stop); });
+        }
+    }
+
+    pagmo::vector_double run(batch& job)
+    {
+        if (job.size == 0)
+        {
+            return {};
+        }
+
+        std::unique_lock lock(mutex);
+        pending.push_back(&job);
+        wake.notify_all();
+        while (job.next < job.size)
+        {
+            const std::size_t index = claim(job);
+            lock.unlock();
+            complete(job, index);
+            lock.lock();
+        }
+        lock.unlock();
+
+        std::unique_lock done_lock(job.mutex);
+        job.done.wait(done_lock, [&job] { return job.finished == job.size; });
+        return std::move(job.fitness);
+    }
+
+    /** Takes the next specimen of the batch, the pool mutex must be locked */
+    std::size_t claim(batch& job)
+    {
+        const std::size_t index = job.next++;
+        if (job.next == job.size)
+        {
+            pending.erase(std::find(pending.begin(), pending.end(), &job));
+        }
+        return index;
+    }
+
+    void complete(batch& job, std::size_t index)
+    {
+        const std::size_t replicates = job.stochastic ? job.stochastic->count : 1;
+        const double* dv = job.dvs.data() + index / replicates * dimension;
+        const Inclinations specimen{ dv[0], dv[1], dv[2], dv[3], dv[4] };
+        if (job.stochastic)
+        {
+            job.fitness[index] = evaluate_replicate(specimen, *job.stochastic, index % replicates);
+        }
+        else if (job.endings)
+        {
+            evaluate_specimen_endings(specimen, *job.endings, job.fitness.data() + index * job.endings->size());
+        }
+        else
+        {
+            job.fitness[index] = job.level ? estimate_specimen(specimen, *job.level) : evaluate_specimen(specimen, job.cutoff);
+        }
+
+        // notifying under the lock, the batch may not exist anymore once it is released
+        std::lock_guard done_lock(job.mutex);
+        if (++job.finished == job.size)
+        {
+            job.done.notify_all();
+        }
+    }
+
+    void work(std::stop_token stop)
+    {
+        std::unique_lock lock(mutex);
+        while (wake.wait(lock, stop, [this] { return !pending.empty(); }))
+        {
+            const auto job = pending.front();
+            const std::size_t index = claim(*job);
+            lock.unlock();
+            complete(*job, index);
+            lock.lock();
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable_any wake;
+    std::deque<batch*> pending;
+    std::vector<std::jthread> workers; // last, so the workers stop before the rest is destroyed
+};
+
+evaluation_pool& shared_evaluation_pool()
+{
+    static evaluation_pool pool(std::max(1u, std::thread::hardware_concurrency()));
+    return pool;
+}
+
+/** Identifies the engine by its FLL, so cached trajectories of different engines never mix */
+std::size_t engine_fingerprint(const fl::Engine* engine)
+{
+    return std::hash<std::string>{}(fl::FllExporter().toString(engine));
+}
+
+/**
+ * Concurrent LRU cache of the fitness of the specimens, so the specimens that the algorithms propose again
+ * (e.g., once the populations converge) are not simulated again.
+ *
+ * The inclinations only enter the engine through linear Ramps, so nearby specimens tend to take the same actions:
+ * the specimens are keyed by their inclinations rounded to a multiple of the resolution (or exactly, if 0),
+ * together with the fingerprint of the engine. The specimens of a key are all simulated as its representative, so
+ * their fitness does not depend on which of them was simulated first (see pm_problem).
+ * The entries are split in shards, each with its own lock.
+ */
+class trajectory_cache
+{
+public:
+    trajectory_cache(double resolution, std::size_t capacity, std::size_t engine_fingerprint)
+        : resolution(resolution), capacity_per_shard((capacity + shard_count - 1) / shard_count), engine(engine_fingerprint) {}
+
+    /**
+     * Fitness of the specimen if cached, as simulated with the cutoff (see simulate_trajectory): the fitness if it is
+     * not worse than the cutoff, the maximum otherwise. The specimens stopped early are only known to be worse than
+     * the cutoff they were simulated with, so they are only found for cutoffs that are not worse than it.
+     * Hence, the cache never changes the fitness of a specimen, whichever island simulated it first.
+     */
+    std::optional<double> find(const Inclinations& specimen, double cutoff)
+    {
+        const Key key = make_key(specimen);
+        Shard& shard = shard_of(key);
+        {
+            std::lock_guard lock(shard.mutex);
+            const auto it = shard.index.find(key);
+            if (it != shard.index.end() && (it->second->second.exact || it->second->second.fitness >= cutoff))
+            {
+                shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+                hit_count.fetch_add(1, std::memory_order_relaxed);
+                const Entry& entry = it->second->second;
+                return entry.exact && entry.fitness <= cutoff ? entry.fitness : std::numeric_limits<double>::max();
+            }
+        }
+        miss_count.fetch_add(1, std::memory_order_relaxed);
+        return std::nullopt;
+    }
+
+    void insert(const Inclinations& specimen, double cutoff, double fitness)
+    {
+        if (capacity_per_shard == 0)
+        {
+            return;
+        }
+        const Key key = make_key(specimen);
+        const Entry entry = fitness <= cutoff ? Entry{ fitness, true } : Entry{ cutoff, false };
+        Shard& shard = shard_of(key);
+        std::lock_guard lock(shard.mutex);
+        const auto it = shard.index.find(key);
+        if (it != shard.index.end())
+        {
+            // the fitness found by another island is kept rather than the cutoff this one stopped at
+            if (entry.exact || !it->second->second.exact)
+            {
+                it->second->second = entry;
+            }
+            shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+            return;
+        }
+        if (shard.entries.size() == capacity_per_shard)
+        {
+            shard.index.erase(shard.entries.back().first);
+            shard.entries.pop_back();
+        }
+        shard.entries.emplace_front(key, entry);
+        shard.index.emplace(key, shard.entries.begin());
+    }
+
+    /** The specimen that is simulated for every specimen of the same key: its inclinations rounded to the resolution */
+    Inclinations representative(const Inclinations& specimen) const
+    {
+        if (resolution == 0.0)
+        {
+            return specimen;
+        }
+        return std::apply([this](auto... inclination) {
+            return Inclinations{ static_cast<double>(std::llround(inclination / resolution)) * resolution... };
+        }, specimen);
+    }
+
+    std::size_t hits() const { return hit_count.load(); }
+    std::size_t misses() const { return miss_count.load(); }
+
+    double hit_rate() const
+    {
+        const std::size_t lookups = hits() + misses();
+        return lookups == 0 ? 0.0 : static_cast<double>(hits()) / lookups;
+    }
+
+private:
+    static constexpr std::size_t shard_count = 16;
+
+    struct Key
+    {
+        std::size_t engine;
+        std::array<std::int64_t, std::tuple_size_v<Inclinations>> inclinations;
+
+        bool operator==(const Key&) const = default;
+    };
+
+    struct KeyHash
+    {
+        std::size_t operator()(const Key& key) const
+        {
+            std::size_t hash = key.engine;
+            for (const auto inclination : key.inclinations)
+            {
+                hash ^= std::hash<std::int64_t>{}(inclination) + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+            }
+            return hash;
+        }
+    };
+
+    struct Entry
+    {
+        double fitness;
+        bool exact; // otherwise the cutoff that the fitness is worse than
+    };
+
+    struct Shard
+    {
+        std::mutex mutex;
+        std::list<std::pair<Key, Entry>> entries; // most recently used first
+        std::unordered_map<Key, std::list<std::pair<Key, Entry>>::iterator, KeyHash> index;
+    };
+
+    Key make_key(const Inclinations& specimen) const
+    {
+        Key key{ engine, {} };
+        std::apply([this, &key](auto... inclination) {
+            std::size_t i = 0;
+            ((key.inclinations[i++] = resolution > 0.0
+                ? std::llround(inclination / resolution)
+                : std::bit_cast<std::int64_t>(inclination)), ...);
+        }, specimen);
+        return key;
+    }
+
+    Shard& shard_of(const Key& key)
+    {
+        return shards[KeyHash{}(key) % shard_count];
+    }
+
+    const double resolution;
+    const std::size_t capacity_per_shard;
+    const std::size_t engine;
+    std::array<Shard, shard_count> shards;
+    std::atomic<std::size_t> hit_count{ 0 };
+    std::atomic<std::size_t> miss_count{ 0 };
+};
+
+/**
+ * Multi-fidelity evaluation of the batches of specimens: every specimen is scored at the first level of fidelity,
+ * the best fraction of them is promoted to the next level and so on, and the specimens promoted from the last level
+ * are simulated in full. The specimens that are not promoted get the score of the last level they reached, but never
+ * better than the worst finite fitness of the specimens simulated in full, since they ranked below them: the lost
+ * (or pruned) specimens, whose fitness is the maximum, would otherwise give it to the whole batch and erase the
+ * ranking of the cheaper levels. Without any finite fitness in full, the scores of the cheaper levels are kept.
+ * Counts how often the ranking of the specimens at each level disagrees with their ranking at the next one.
+ *
+ * Only the batches of pm_problem::batch_fitness go through it: pagmo::sade of main has no batch evaluation, so it
+ * only scores the initial populations, and every specimen evaluated by the evolution itself is simulated in full.
+ */
+class multi_fidelity
+{
+public:
+    explicit multi_fidelity(std::vector<fidelity_level> levels) : levels(std::move(levels)), statistics(this->levels.size())
+    {
+    }
+
+    /** Fitness of each specimen in the batch, where full tells which of them were simulated in full */
+    pagmo::vector_double evaluate(const pagmo::vector_double& dvs, double cutoff, std::vector<bool>& full)
+    {
+        const std::size_t size = dvs.size() / dimension;
+        pagmo::vector_double results(size);
+        full.assign(size, false);
+        if (size == 0)
+        {
+            return results;
+        }
+
+        std::vector<std::size_t> candidates(size);
+        std::iota(candidates.begin(), candidates.end(), std::size_t{ 0 });
+        for (std::size_t level = 0; level <= levels.size(); ++level)
+        {
+            const bool last = level == levels.size();
+            pagmo::vector_double subset;
+            subset.reserve(candidates.size() * dimension);
+            for (const std::size_t candidate : candidates)
+            {
+                subset.insert(subset.end(), dvs.begin() + candidate * dimension, dvs.begin() + (candidate + 1) * dimension);
+            }
+            const auto scores = shared_evaluation_pool().evaluate(subset, cutoff, last ? nullptr : &levels[level]);
+
+            // the candidates were promoted from the previous level with the scores still in the results
+            if (level > 0)
+            {
+                count_disagreements(level - 1, candidates, results, scores);
+            }
+            for (std::size_t k = 0; k < candidates.size(); ++k)
+            {
+                results[candidates[k]] = scores[k];
+            }
+            if (last)
+            {
+                break;
+            }
+
+            const auto promoted = std::max<std::size_t>(1, static_cast<std::size_t>(
+                std::ceil(levels[level].promoted * static_cast<double>(candidates.size()))));
+            std::stable_sort(candidates.begin(), candidates.end(),
+                [&](std::size_t a, std::size_t b) { return results[a] < results[b]; });
+            {
+                std::lock_guard lock(mutex);
+                statistics[level].scored += candidates.size();
+                statistics[level].promoted += std::min(promoted, candidates.size());
+            }
+            candidates.resize(std::min(promoted, candidates.size()));
+        }
+
+        constexpr double lost = std::numeric_limits<double>::max();
+        double worst_full = std::numeric_limits<double>::lowest();
+        for (const std::size_t candidate : candidates)
+        {
+            full[candidate] = true;
+            if (results[candidate] < lost)
+            {
+                worst_full = std::max(worst_full, results[candidate]);
+            }
+        }
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            if (!full[i])
+            {
+                results[i] = std::max(results[i], worst_full);
+            }
+        }
+        return results;
+    }
+
+    /** Specimens scored and promoted at each level, and how often their rankings disagree with the next level */
+    std::string report() const
+    {
+        std::lock_guard lock(mutex);
+        std::ostringstream report;
+        for (std::size_t level = 0; level < levels.size(); ++level)
+        {
+            const auto& counts = statistics[level];
+            report << "fidelity level " << level + 1 << " (" << levels[level].horizon << " steps, resolution "
+                << levels[level].resolution << "): " << counts.scored << " scored, " << counts.promoted << " promoted, "
+                << "ranking disagrees with the " << (level + 1 == levels.size() ? "full simulation" : "next level")
+                << " in " << 100.0 * counts.discordant_pairs / std::max<std::uint64_t>(counts.pairs, 1) << "% of "
+                << counts.pairs << " pairs\n";
+        }
+        return report.str();
+    }
+
+private:
+    static constexpr std::size_t dimension = std::tuple_size_v<Inclinations>;
+
+    struct level_statistics
+    {
+        std::uint64_t scored = 0;
+        std::uint64_t promoted = 0;
+        std::uint64_t pairs = 0;
+        std::uint64_t discordant_pairs = 0;
+    };
+
+    /** Pairs of candidates ranked in one order by their previous scores and in the other by their new scores */
+    void count_disagreements(std::size_t level, const std::vector<std::size_t>& candidates,
+        const pagmo::vector_double& previous, const pagmo::vector_double& scores)
+    {
+        std::uint64_t pairs = 0;
+        std::uint64_t discordant = 0;
+        for (std::size_t a = 0; a < candidates.size(); ++a)
+        {
+            for (std::size_t b = a + 1; b < candidates.size(); ++b)
+            {
+                const double before = previous[candidates[a]] - previous[candidates[b]];
+                const double after = scores[a] - scores[b];
+                if (before == 0 || after == 0)
+                {
+                    continue;
+                }
+                ++pairs;
+                discordant += (before < 0) != (after < 0);
+            }
+        }
+        std::lock_guard lock(mutex);
+        statistics[level].pairs += pairs;
+        statistics[level].discordant_pairs += discordant;
+    }
+
+    const std::vector<fidelity_level> levels;
+    mutable std::mutex mutex;
+    std::vector<level_statistics> statistics;
+};
+
+// Pagmo2-compatible problem definition
+struct pm_problem {
+
+    /**
+     * Specimens stop being simulated once they provably end up worse than the best fitness found so far
+     * plus this margin, and get the maximum fitness instead (see simulate_trajectory).
+     * Infinity disables the pruning (the default, see --prune), so every specimen gets its actual fitness.
+     */
+    double pruning_margin = std::numeric_limits<double>::infinity();
+
+    /**
+     * Best fitness found so far by this copy of the problem, i.e., by its island (and by the migrants in the islands
+     * of main_worker), which is read once per batch (or per specimen outside of batches): the fitness of a specimen
+     * depends neither on the other islands nor on the timing of the threads, so a seed reproduces a run.
+     */
+    mutable double best_fitness = std::numeric_limits<double>::max();
+
+    /** Fitness of the specimens already evaluated by any of the islands, none if null */
+    std::shared_ptr<trajectory_cache> cache;
+
+    /** Scores the batches at lower fidelities first and simulates only the best specimens in full, none if null */
+    std::shared_ptr<multi_fidelity> fidelity;
+
+    /**
+     * Simulates the specimens with random stat changes instead, their fitness being the mean of the replicates,
+     * none if null. Neither pruned, cached nor scored at lower fidelities, which assume fixed changes.
+     */
+    std::shared_ptr<const stochastic_replicates> stochastic;
+
+    double cutoff() const
+    {
+        return std::isinf(pruning_margin) ? std::numeric_limits<double>::max() : best_fitness + pruning_margin;
+    }
+
+    void update_best_fitness(double fitness) const
+    {
+        best_fitness = std::min(best_fitness, fitness);
+    }
+
+    // Implementation of the objective function.
+    pagmo::vector_double fitness(const pagmo::vector_double& dv) const
+    {
+        if (stochastic)
+        {
+            return stochastic_fitness(dv);
+        }
+        const Inclinations specimen = cache ? cache->representative({ dv[0], dv[1], dv[2], dv[3], dv[4] })
+            : Inclinations{ dv[0], dv[1], dv[2], dv[3], dv[4] };
+        const double specimen_cutoff = cutoff();
+        if (cache)
+        {
+            if (const auto cached = cache->find(specimen, specimen_cutoff))
+            {
+                update_best_fitness(*cached);
+                return { *cached };
+            }
+        }
+
+        const double result = evaluate_specimen(specimen, specimen_cutoff);
+        update_best_fitness(result);
+        if (cache)
+        {
+            cache->insert(specimen, specimen_cutoff, result);
+        }
+        return { result };
+    }
+
+    /**
+     * Implementation of the batch objective function, used by pagmo::bfe.
+     * Spreads the specimens over all the cores regardless of the number of islands.
+     */
+    pagmo::vector_double batch_fitness(const pagmo::vector_double& dvs) const
+    {
+        if (stochastic)
+        {
+            return stochastic_fitness(dvs);
+        }
+        const double batch_cutoff = cutoff();
+        std::vector<bool> full;
+        if (!cache)
+        {
+            auto results = evaluate_batch(dvs, batch_cutoff, full);
+            for (std::size_t i = 0; i < results.size(); ++i)
+            {
+                if (full[i])
+                {
+                    update_best_fitness(results[i]);
+                }
+            }
+            return results;
+        }
+
+        // only the specimens that are not cached are simulated, as the representatives of their keys
+        const std::size_t dimension = std::tuple_size_v<Inclinations>;
+        pagmo::vector_double results(dvs.size() / dimension);
+        pagmo::vector_double missing;
+        std::vector<std::size_t> missing_indices;
+        for (std::size_t i = 0; i < results.size(); ++i)
+        {
+            const double* dv = dvs.data() + i * dimension;
+            const Inclinations specimen = cache->representative({ dv[0], dv[1], dv[2], dv[3], dv[4] });
+            if (const auto cached = cache->find(specimen, batch_cutoff))
+            {
+                results[i] = *cached;
+                update_best_fitness(*cached);
+                continue;
+            }
+            std::apply([&missing](auto... inclination) { (missing.push_back(inclination), ...); }, specimen);
+            missing_indices.push_back(i);
+        }
+
+        // only the fitness of the specimens simulated in full is cached and tightens the cutoff
+        const auto missing_results = evaluate_batch(missing, batch_cutoff, full);
+        for (std::size_t m = 0; m < missing_indices.size(); ++m)
+        {
+            const double* dv = missing.data() + m * dimension;
+            results[missing_indices[m]] = missing_results[m];
+            if (!full[m])
+            {
+                continue;
+            }
+            update_best_fitness(missing_results[m]);
+            cache->insert({ dv[0], dv[1], dv[2], dv[3], dv[4] }, batch_cutoff, missing_results[m]);
+        }
+        return results;
+    }
+
+    /** Mean fitness of the replicates of each specimen */
+    pagmo::vector_double stochastic_fitness(const pagmo::vector_double& dvs) const
+    {
+        const auto replicates = shared_evaluation_pool().evaluate_replicates(dvs, *stochastic);
+        pagmo::vector_double results(dvs.size() / std::tuple_size_v<Inclinations>);
+        for (std::size_t i = 0; i < results.size(); ++i)
+        {
+            results[i] = summarize_replicates(replicates.data() + i * stochastic->count, stochastic->count).mean;
+            update_best_fitness(results[i]);
+        }
+        return results;
+    }
+
+    /** Fitness of the specimens, through the levels of fidelity if any, where full tells which were simulated in full */
+    pagmo::vector_double evaluate_batch(const pagmo::vector_double& dvs, double batch_cutoff, std::vector<bool>& full) const
+    {
+        if (fidelity)
+        {
+            return fidelity->evaluate(dvs, batch_cutoff, full);
+        }
+        full.assign(dvs.size() / std::tuple_size_v<Inclinations>, true);
+        return shared_evaluation_pool().evaluate(dvs, batch_cutoff);
+    }
+
+    /**
+     * Implementation of the box bounds.
+     * First element is the lower bound, second is the upper bound.
+     * Bounds are inclination values for five our inclinations.
+     * 
+     * (Range is 0.0 - 1.0, we hope that Pagmo2 will correctly interpolate between them)
+     */
+    std::pair<pagmo::vector_double, pagmo::vector_double> get_bounds() const
+    {
+        return { {0., 0., 0., 0., 0.}, {1., 1., 1., 1., 1.} };
+    }
+
+    /**
+     * The margin and the best fitness of the island are saved with it, the rest (cache, fidelity, replicates) is
+     * shared by all, so they are configured again and shared again by relink_islands.
+     */
+    template <typename Archive>
+    void serialize(Archive& archive, unsigned)
+    {
+        archive & pruning_margin;
+        archive & best_fitness;
+    }
+};
+
+PAGMO_S11N_PROBLEM_EXPORT(pm_problem)
+
+/**
+ * Multi-objective problem whose objectives are the penalties of every ending of the registry (see ending_registry),
+ * all scored from the same trajectory, so a single run finds the specimens for every ending and the trade-offs
+ * between them instead of a run per ending. Without pruning, since the bounds only hold for the General ending.
+ */
+struct pm_endings_problem {
+
+    pagmo::vector_double fitness(const pagmo::vector_double& dv) const
+    {
+        const auto& endings = ending_registry();
+        pagmo::vector_double penalties(endings.size());
+        evaluate_specimen_endings({ dv[0], dv[1], dv[2], dv[3], dv[4] }, endings, penalties.data());
+        return penalties;
+    }
+
+    /** Implementation of the batch objective function, used by pagmo::bfe, the objectives of each specimen in a row */
+    pagmo::vector_double batch_fitness(const pagmo::vector_double& dvs) const
+    {
+        return shared_evaluation_pool().evaluate_endings(dvs, ending_registry());
+    }
+
+    pagmo::vector_double::size_type get_nobj() const
+    {
+        return ending_registry().size();
+    }
+
+    /** Same bounds as pm_problem */
+    std::pair<pagmo::vector_double, pagmo::vector_double> get_bounds() const
+    {
+        return { {0., 0., 0., 0., 0.}, {1., 1., 1., 1., 1.} };
+    }
+
+    template <typename Archive>
+    void serialize(Archive&, unsigned)
+    {
+    }
+};
+
+PAGMO_S11N_PROBLEM_EXPORT(pm_endings_problem)
+
+/**
+ * Makes the algorithm evaluate whole generations through pm_problem::batch_fitness if it supports it,
+ * otherwise only the initial populations are evaluated in batches.
+ */
+template <typename Algorithm>
+void use_batch_evaluation(Algorithm& uda)
+{
+    if constexpr (requires { uda.set_bfe(pagmo::bfe{}); })
+    {
+        uda.set_bfe(pagmo::bfe{});
+    }
+}
+
+/**
+ * Checkpoint of a run: the archipelago (islands, populations, algorithms with their RNG states, champions,
+ * migrants) in a Boost binary archive, which keeps every double and counter exact, preceded by the rounds
+ * of evolution completed and the fingerprint of the engine.
+ * Written to a temporary file that is synced to the disk before it replaces the previous checkpoint at once,
+ * so a crash (even of the system) leaves either one intact.
+ * Resuming is exact: the best fitness of every island that sets its cutoff is saved with it (see pm_problem), and the
+ * trajectory cache, which is not saved, never changes a fitness, only saves simulations, as long as the run resumes
+ * with the same --cache-resolution, which decides the specimens simulated (see trajectory_cache::representative).
+ */
+struct checkpoint_header
+{
+    static constexpr std::array<char, 4> magic{ 'P', 'M', 'C', 'K' };
+    static constexpr std::uint32_t version = 2;
+
+    std::uint64_t engine = 0;
+    std::uint32_t rounds = 0;
+};
+
+/** Writes the contents of the file, or the entries of the directory, to the disk */
+void sync_to_disk(const std::filesystem::path& path)
+{
+#ifdef _WIN32
+    // the directories cannot be opened as files, their entries are written by the file system
+    if (std::filesystem::is_directory(path))
+    {
+        return;
+    }
+    const int descriptor = ::_wopen(path.c_str(), _O_WRONLY | _O_BINARY);
+    const bool synced = descriptor >= 0 && ::_commit(descriptor) == 0;
+    if (descriptor >= 0)
+    {
+        ::_close(descriptor);
+    }
+#else
+    const int descriptor = ::open(path.c_str(), O_RDONLY);
+    const bool synced = descriptor >= 0 && ::fsync(descriptor) == 0;
+    if (descriptor >= 0)
+    {
+        ::close(descriptor);
+    }
+#endif
+    if (!synced)
+    {
+        throw std::runtime_error("could not write " + path.string() + " to the disk");
+    }
+}
+
+void save_checkpoint(const std::string& path, const pagmo::archipelago& archi, const checkpoint_header& header)
+{
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write(checkpoint_header::magic.data(), checkpoint_header::magic.size());
+        file.write(reinterpret_cast<const char*>(&checkpoint_header::version), sizeof(checkpoint_header::version));
+        file.write(reinterpret_cast<const char*>(&header.engine), sizeof(header.engine));
+        file.write(reinterpret_cast<const char*>(&header.rounds), sizeof(header.rounds));
+        boost::archive::binary_oarchive archive(file);
+        archive << archi;
+        file.flush();
+        if (!file)
+        {
+            throw std::runtime_error("could not write the checkpoint " + temporary);
+        }
+    }
+    sync_to_disk(temporary);
+    std::filesystem::rename(temporary, path);
+    sync_to_disk(std::filesystem::absolute(path).parent_path());
+}
+
+checkpoint_header load_checkpoint(const std::string& path, pagmo::archipelago& archi, std::uint64_t engine)
+{
+    std::ifstream file(path, std::ios::binary);
+    std::array<char, 4> magic{};
+    std::uint32_t version = 0;
+    checkpoint_header header;
+    file.read(magic.data(), magic.size());
+    file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    file.read(reinterpret_cast<char*>(&header.engine), sizeof(header.engine));
+    file.read(reinterpret_cast<char*>(&header.rounds), sizeof(header.rounds));
+    if (!file || magic != checkpoint_header::magic || version != checkpoint_header::version)
+    {
+        throw std::runtime_error("not a checkpoint of pm_solver: " + path);
+    }
+    if (header.engine != engine)
+    {
+        throw std::runtime_error("the checkpoint " + path + " was made with a different engine");
+    }
+    boost::archive::binary_iarchive archive(file);
+    archive >> archi;
+    return header;
+}
+
+/** The islands loaded from a checkpoint get their own copies of what the problems share, share them again */
+void relink_islands(pagmo::archipelago& archi, const pm_problem& shared)
+{
+    for (auto& isl : archi)
+    {
+        auto population = isl.get_population();
+        auto* problem = population.get_problem().extract<pm_problem>();
+        problem->cache = shared.cache;
+        problem->fidelity = shared.fidelity;
+        problem->stochastic = shared.stochastic;
+        isl.set_population(population);
+    }
+}
+
+void test_simulation(const Inclinations &specimen)
+{
+    std::unique_ptr<fl::Engine> engine_clone(fl::FlbImporter().cloneEngine(engine.get()));
+    // a single trajectory has nothing else to run in parallel, so each step defuzzifies its outputs in parallel
+    fl::TaskPool task_pool;
+    engine_clone->setTaskPool(&task_pool);
+    const auto& result = simulate(
+        specimen,
+        engine_clone.get()
+    );
+    print_simulation_result(result);
+}
+
+int main_debug()
+{
+    //// Example specimen with balanced inclinations
+    const Inclinations specimen{ 0.01, 0.2, 0.7, 0.9, 0.1 };
+    test_simulation(specimen);
+    return 0;
+}
+
+#ifdef PM_SOLVER_BENCHMARK
+/*
+ * Benchmark of the stages of the solver, built as pm_solver_bench.
+ * Every stage is measured with 1, 2, 4, ... up to --threads threads calling it at the same time,
+ * with specimens and inputs drawn from --seed, and the results are written as JSON to --output (or stdout).
+ */
+
+// Counts the allocations of the whole program, so the benchmark can report the allocations per call
+static std::atomic<std::uint64_t> allocation_count{ 0 };
+
+void* operator new(std::size_t size)
+{
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* pointer = std::malloc(size == 0 ? 1 : size))
+    {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+// keeps the results of the calls from being optimized away
+thread_local volatile double benchmark_sink = 0.0;
+
+struct benchmark_result
+{
+    std::string stage;
+    unsigned threads = 1;
+    std::size_t calls = 0;
+    double seconds = 0.0;
+    std::uint64_t allocations = 0;
+    std::vector<double> latencies; // of every call, in seconds, sorted
+    int process_calls_per_call = 0; // engine evaluations made by each call, if known
+};
+
+using benchmark_call = std::function<void()>;
+
+/**
+ * Times the calls made by make_call(thread) on each of the threads at the same time.
+ * Each thread prepares its call before the clock starts, so only the calls are measured.
+ */
+benchmark_result run_benchmark(
+    const std::string& stage, unsigned threads, std::size_t calls_per_thread,
+    const std::function<benchmark_call(unsigned thread)>& make_call)
+{
+    using clock = std::chrono::steady_clock;
+
+    std::vector<std::vector<double>> latencies(threads);
+    std::latch ready(threads + 1);
+    std::latch start(1);
+    std::vector<std::jthread> workers;
+    for (unsigned thread = 0; thread < threads; ++thread)
+    {
+        workers.emplace_back([&, thread] {
+            const benchmark_call call = make_call(thread);
+            auto& thread_latencies = latencies[thread];
+            thread_latencies.reserve(calls_per_thread);
+            ready.count_down();
+            start.wait();
+            for (std::size_t i = 0; i < calls_per_thread; ++i)
+            {
+                const auto begin = clock::now();
+                call();
+                thread_latencies.push_back(std::chrono::duration<double>(clock::now() - begin).count());
+            }
+        });
+    }
+    ready.arrive_and_wait();
+
+    const std::uint64_t allocations = allocation_count.load();
+    const auto begin = clock::now();
+    start.count_down();
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+
+    benchmark_result result{ .stage = stage, .threads = threads, .calls = threads * calls_per_thread };
+    result.seconds = std::chrono::duration<double>(clock::now() - begin).count();
+    result.allocations = allocation_count.load() - allocations;
+    for (const auto& thread_latencies : latencies)
+    {
+        result.latencies.insert(result.latencies.end(), thread_latencies.begin(), thread_latencies.end());
+    }
+    std::sort(result.latencies.begin(), result.latencies.end());
+    return result;
+}
+
+std::vector<Inclinations> random_specimens(std::size_t count, std::uint64_t seed)
+{
+    std::mt19937_64 generator(seed);
+    std::uniform_real_distribution<double> inclination(0.0, 1.0);
+    std::vector<Inclinations> specimens;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const double fighting = inclination(generator), magic = inclination(generator),
+            housekeeping = inclination(generator), artistry = inclination(generator), sinfulness = inclination(generator);
+        specimens.emplace_back(fighting, magic, housekeeping, artistry, sinfulness);
+    }
+    return specimens;
+}
+
+/** Rows of values for the input variables, each drawn from the range of its variable */
+std::vector<std::vector<double>> random_inputs(const fl::Engine* engine, std::size_t count, std::uint64_t seed)
+{
+    std::mt19937_64 generator(seed);
+    std::vector<std::vector<double>> rows(count);
+    for (auto& row : rows)
+    {
+        for (const fl::InputVariable* variable : engine->inputVariables())
+        {
+            row.push_back(std::uniform_real_distribution<double>(variable->getMinimum(), variable->getMaximum())(generator));
+        }
+    }
+    return rows;
+}
+
+pagmo::sade benchmark_algorithm(unsigned generations, unsigned seed)
+{
+    pagmo::sade uda(generations, 2u, 1u, 1e-6, 1e-6, false, seed);
+    use_batch_evaluation(uda);
+    return uda;
+}
+
+/** Every stage with the given number of threads, where the archipelago gets one island per thread */
+std::vector<benchmark_result> benchmark_stages(unsigned threads, std::uint64_t seed)
+{
+    std::vector<benchmark_result> results;
+    // the batches are evaluated by as many workers as the stages have threads, rather than one per core
+    shared_evaluation_pool().resize(threads);
+
+    // parses Baseline.fll, even if the solver loads the snapshot instead (see init and load_snapshot)
+    results.push_back(run_benchmark("load", threads, 20, [](unsigned) -> benchmark_call {
+        return [] {
+            benchmark_sink = static_cast<double>(
+                std::unique_ptr<fl::Engine>(fl::FllImporter().fromFile(engine_path))->numberOfRuleBlocks());
+        };
+    }));
+
+    results.push_back(run_benchmark("clone", threads, 200, [](unsigned) -> benchmark_call {
+        return [] { benchmark_sink = static_cast<double>(std::unique_ptr<fl::Engine>(engine->clone())->numberOfRuleBlocks()); };
+    }));
+
+    results.push_back(run_benchmark("clone_snapshot", threads, 200, [](unsigned) -> benchmark_call {
+        return [] {
+            benchmark_sink = static_cast<double>(
+                std::unique_ptr<fl::Engine>(fl::FlbImporter().cloneEngine(engine.get()))->numberOfRuleBlocks());
+        };
+    }));
+
+    static const std::string snapshot = fl::FlbExporter().toString(engine.get());
+    results.push_back(run_benchmark("load_snapshot", threads, 200, [](unsigned) -> benchmark_call {
+        return [] {
+            benchmark_sink = static_cast<double>(
+                std::unique_ptr<fl::Engine>(fl::FlbImporter().fromString(snapshot))->numberOfRuleBlocks());
+        };
+    }));
+
+    results.push_back(run_benchmark("process", threads, 20000, [seed](unsigned thread) -> benchmark_call {
+        return [state = fl::EngineState(engine.get()), rows = random_inputs(engine.get(), 1024, seed + thread),
+                   next = std::size_t{ 0 }]() mutable {
+            const auto& row = rows[next++ % rows.size()];
+            for (std::size_t i = 0; i < row.size(); ++i)
+            {
+                state.setInputValue(i, row[i]);
+            }
+            engine->process(state);
+            benchmark_sink = state.getOutputValue(0);
+        };
+    }));
+    results.back().process_calls_per_call = 1;
+
+    results.push_back(run_benchmark("simulate_fast", threads, 50, [seed](unsigned thread) -> benchmark_call {
+        return [state = fl::EngineState(engine.get()), specimens = random_specimens(64, seed + thread),
+                   next = std::size_t{ 0 }]() mutable {
+            benchmark_sink = simulate_fast(specimens[next++ % specimens.size()], engine.get(), state, action_effects, stat_saturation);
+        };
+    }));
+    results.back().process_calls_per_call = T;
+
+    // the same specimens fast-forwarding the cycles, i.e., their net gain over the steps spent looking for them
+    results.push_back(run_benchmark("simulate_fast_cycles", threads, 50, [seed](unsigned thread) -> benchmark_call {
+        return [state = fl::EngineState(engine.get()), specimens = random_specimens(64, seed + thread),
+                   next = std::size_t{ 0 }, saturation = saturation_bounds(engine.get())]() mutable {
+            benchmark_sink = simulate_fast(specimens[next++ % specimens.size()], engine.get(), state, action_effects, saturation);
+        };
+    }));
+    results.back().process_calls_per_call = T;
+
+#ifdef PM_SOLVER_NATIVE_ENGINE
+    results.push_back(run_benchmark("simulate_native", threads, 200, [seed](unsigned thread) -> benchmark_call {
+        return [specimens = random_specimens(64, seed + thread), next = std::size_t{ 0 }]() mutable {
+            benchmark_sink = simulate_native(specimens[next++ % specimens.size()], action_effects, stat_saturation);
+        };
+    }));
+    results.back().process_calls_per_call = T;
+
+    results.push_back(run_benchmark("simulate_native_cycles", threads, 200, [seed](unsigned thread) -> benchmark_call {
+        return [specimens = random_specimens(64, seed + thread), next = std::size_t{ 0 },
+                   saturation = saturation_bounds(engine.get())]() mutable {
+            benchmark_sink = simulate_native(specimens[next++ % specimens.size()], action_effects, saturation);
+        };
+    }));
+    results.back().process_calls_per_call = T;
+#endif
+
+    // one generation of a single island, as the islands of main evolve them, without pruning nor cache
+    results.push_back(run_benchmark("island_generation", threads, 5, [seed](unsigned thread) -> benchmark_call {
+        const pagmo::problem prob(pm_problem{});
+        return [uda = benchmark_algorithm(1u, static_cast<unsigned>(seed + thread)),
+                   pop = pagmo::population(prob, 20u, static_cast<unsigned>(seed + thread))]() mutable {
+            pop = uda.evolve(pop);
+            benchmark_sink = pop.champion_f()[0];
+        };
+    }));
+
+    // a whole archipelago with an island per thread, evolved by pagmo itself
+    auto archipelago = run_benchmark("archipelago_evolve", 1, 2, [threads, seed](unsigned) -> benchmark_call {
+        auto archi = std::make_shared<pagmo::archipelago>(threads, pagmo::algorithm(benchmark_algorithm(10u, static_cast<unsigned>(seed))),
+            pagmo::problem(pm_problem{}), pagmo::bfe{}, 20u, static_cast<unsigned>(seed));
+        return [archi] {
+            archi->evolve(1);
+            archi->wait_check();
+        };
+    });
+    archipelago.threads = threads;
+    results.push_back(std::move(archipelago));
+
+    return results;
+}
+
+void write_benchmark_results(std::ostream& out, std::uint64_t seed, const std::vector<benchmark_result>& results)
+{
+    const auto percentile = [](const std::vector<double>& sorted, double p) {
+        return sorted.empty() ? 0.0 : sorted[std::min(sorted.size() - 1, static_cast<std::size_t>(p * sorted.size()))];
+    };
+
+    out << std::setprecision(6);
+    out << "{\n";
+    out << "  \"seed\": " << seed << ",\n";
+    out << "  \"native_engine\": "
+#ifdef PM_SOLVER_NATIVE_ENGINE
+        << "true"
+#else
+        << "false"
+#endif
+        << ",\n";
+    out << "  \"hardware_concurrency\": " << std::thread::hardware_concurrency() << ",\n";
+    out << "  \"steps\": " << T << ",\n";
+    out << "  \"results\": [\n";
+    for (std::size_t i = 0; i < results.size(); ++i)
+    {
+        const benchmark_result& result = results[i];
+        const double calls = static_cast<double>(result.calls);
+        out << "    {\"stage\": \"" << result.stage << "\", \"threads\": " << result.threads
+            << ", \"calls\": " << result.calls << ", \"seconds\": " << result.seconds
+            << ", \"calls_per_second\": " << calls / result.seconds;
+        if (result.process_calls_per_call > 0)
+        {
+            out << ", \"process_calls_per_second\": " << calls * result.process_calls_per_call / result.seconds;
+        }
+        out << ", \"latency_us\": {\"p50\": " << 1e6 * percentile(result.latencies, 0.50)
+            << ", \"p90\": " << 1e6 * percentile(result.latencies, 0.90)
+            << ", \"p99\": " << 1e6 * percentile(result.latencies, 0.99)
+            << ", \"max\": " << 1e6 * percentile(result.latencies, 1.0) << "}"
+            << ", \"allocations_per_call\": " << static_cast<double>(result.allocations) / calls << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n";
+    out << "}\n";
+}
+
+/** Usage: pm_solver_bench [--threads N] [--seed S] [--output results.json] */
+int main_benchmark(int argc, char** argv)
+{
+    unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+    std::uint64_t seed = 42;
+    std::string output;
+    for (int i = 1; i < argc; i += 2)
+    {
+        const std::string option = argv[i];
+        if (i + 1 == argc)
+            throw std::invalid_argument("option " + option + " requires a value");
+        if (option == "--threads")
+            max_threads = std::max(1u, static_cast<unsigned>(std::stoul(argv[i + 1])));
+        else if (option == "--seed")
+            seed = std::stoull(argv[i + 1]);
+        else if (option == "--output")
+            output = argv[i + 1];
+        else
+            throw std::invalid_argument("unknown option " + option);
+    }
+
+#ifdef PM_SOLVER_NATIVE_ENGINE
+    check_native_engine(engine.get());
+#endif
+
+    std::vector<benchmark_result> results;
+    for (unsigned threads = 1;; threads = std::min(2 * threads, max_threads))
+    {
+        std::cerr << "benchmarking with " << threads << " thread(s)\n";
+        auto stages = benchmark_stages(threads, seed);
+        std::move(stages.begin(), stages.end(), std::back_inserter(results));
+        if (threads == max_threads)
+            break;
+    }
+
+    if (output.empty())
+    {
+        write_benchmark_results(std::cout, seed, results);
+    }
+    else
+    {
+        std::ofstream file(output);
+        write_benchmark_results(file, seed, results);
+    }
+    return 0;
+}
+#endif
+
+#ifndef PM_SOLVER_BENCHMARK
+/*
+ * Distributed islands: every island runs in a worker process of its own (with its own engine, allocator and
+ * evaluation pool) and a coordinator migrates the best specimens between them over TCP, so the islands can run
+ * on several machines, or over a local (Unix domain) socket when they all run on a single host.
+ *
+ *   pm_solver --coordinator PORT|unix:PATH --workers N [--spawn] [--rounds R]
+ *   pm_solver --worker HOST:PORT|unix:PATH
+ *
+ * --spawn starts the N workers as local processes of the same executable (port 0 picks a free port), with the options
+ * of the problem given to the coordinator (see forwarded_options), so they all optimize the same problem.
+ * The islands exchange a few specimens per round, which a socket copies in microseconds against the seconds of
+ * evolution of a round, so there is no transport over shared memory.
+ * Every round, each island receives the migrants of the previous island in the ring, replaces its worst specimens
+ * with them if they are better, evolves one round and sends back its best specimens along with the evaluations
+ * and the time the round took; the rest of the round trip measured by the coordinator is the migration latency.
+ * The values are sent in the byte order of the hosts, so all the machines must share it, and the sizes received are
+ * checked against their bounds before anything is allocated for them, whatever the peer sends.
+ */
+
+#ifdef _WIN32
+using socket_handle = SOCKET;
+constexpr socket_handle no_socket = INVALID_SOCKET;
+#else
+using socket_handle = int;
+constexpr socket_handle no_socket = -1;
+#endif
+
+/** Starts the sockets of the process once (Winsock, on Windows) */
+void start_sockets()
+{
+#ifdef _WIN32
+    static const int started = [] {
+        WSADATA data;
+        if (WSAStartup(MAKEWORD(2, 2), &data) != 0)
+        {
+            throw std::runtime_error("could not start Winsock");
+        }
+        return 0;
+    }();
+#endif
+}
+
+/** Largest message between the coordinator and a worker, far beyond the specimens of any population */
+constexpr std::uint32_t max_island_message_size = 1u << 24;
+
+/** Largest population of an island that the coordinator may assign */
+constexpr std::uint32_t max_island_population = 1u << 16;
+
+/** The kinds of messages between the coordinator and the workers */
+enum class island_command : std::uint8_t { assign, evolve, result, stop };
+
+/** A message between the coordinator and a worker, sent as its size followed by its values */
+struct island_message
+{
+    std::vector<char> bytes;
+    std::size_t offset = 0;
+
+    template <typename T>
+    island_message& put(const T& value)
+    {
+        const char* data = reinterpret_cast<const char*>(&value);
+        bytes.insert(bytes.end(), data, data + sizeof(T));
+        return *this;
+    }
+
+    template <typename T>
+    T get()
+    {
+        if (offset + sizeof(T) > bytes.size())
+        {
+            throw std::runtime_error("truncated message between islands");
+        }
+        T value;
+        std::memcpy(&value, bytes.data() + offset, sizeof(T));
+        offset += sizeof(T);
+        return value;
+    }
+
+    /** Specimens with their fitness, as the count followed by the inclinations and the fitness of each one */
+    island_message& put_specimens(const std::vector<std::pair<pagmo::vector_double, double>>& specimens)
+    {
+        put(static_cast<std::uint32_t>(specimens.size()));
+        for (const auto& [x, f] : specimens)
+        {
+            for (const double inclination : x)
+            {
+                put(inclination);
+            }
+            put(f);
+        }
+        return *this;
+    }
+
+    std::vector<std::pair<pagmo::vector_double, double>> get_specimens()
+    {
+        const auto count = get<std::uint32_t>();
+        const std::size_t specimen_size = (std::tuple_size_v<Inclinations> + 1) * sizeof(double);
+        if (count > (bytes.size() - offset) / specimen_size)
+        {
+            throw std::runtime_error("truncated message between islands");
+        }
+        std::vector<std::pair<pagmo::vector_double, double>> specimens(count);
+        for (auto& [x, f] : specimens)
+        {
+            x.resize(std::tuple_size_v<Inclinations>);
+            for (double& inclination : x)
+            {
+                inclination = get<double>();
+            }
+            f = get<double>();
+        }
+        return specimens;
+    }
+};
+
+/** Prefix of the addresses of the local sockets, unix:PATH, for the islands on a single host */
+constexpr std::string_view local_socket_prefix = "unix:";
+
+/** Path of the local socket if the address is one (unix:PATH), none if it is a TCP address or port */
+std::optional<std::string> local_socket_path(const std::string& address)
+{
+    if (!address.starts_with(local_socket_prefix))
+    {
+        return std::nullopt;
+    }
+    return address.substr(local_socket_prefix.size());
+}
+
+/**
+ * A connection between the coordinator and a worker, or the socket where the coordinator listens, either over TCP
+ * or over a local (Unix domain) socket, which skips the network stack of the host when all the islands run on it
+ */
+class island_socket
+{
+public:
+    explicit island_socket(socket_handle handle = no_socket) : handle(handle) {}
+    island_socket(island_socket&& other) noexcept : handle(std::exchange(other.handle, no_socket)) {}
+    island_socket& operator=(island_socket&& other) noexcept
+    {
+        std::swap(handle, other.handle);
+        return *this;
+    }
+    ~island_socket()
+    {
+        if (handle != no_socket)
+        {
+#ifdef _WIN32
+            closesocket(handle);
+#else
+            ::close(handle);
+#endif
+        }
+    }
+
+    /** Listens on the given port of every interface, 0 for any free port (see port) */
+    static island_socket listen(std::uint16_t port)
+    {
+        start_sockets();
+        island_socket listener(::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP));
+        const int reuse = 1;
+        setsockopt(listener.handle, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_ANY);
+        address.sin_port = htons(port);
+        if (listener.handle == no_socket
+            || ::bind(listener.handle, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0
+            || ::listen(listener.handle, SOMAXCONN) != 0)
+        {
+            throw std::runtime_error("could not listen on port " + std::to_string(port));
+        }
+        return listener;
+    }
+
+    /** Listens on the local socket at the given path, replacing the file of a previous one */
+    static island_socket listen_local(const std::string& path)
+    {
+        start_sockets();
+        island_socket listener(::socket(AF_UNIX, SOCK_STREAM, 0));
+        const sockaddr_un address = local_address(path);
+        std::remove(path.c_str());
+        if (listener.handle == no_socket
+            || ::bind(listener.handle, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0
+            || ::listen(listener.handle, SOMAXCONN) != 0)
+        {
+            throw std::runtime_error("could not listen on the local socket " + path);
+        }
+        return listener;
+    }
+
+    /** Connects to the coordinator listening on the local socket at the given path */
+    static island_socket connect_local(const std::string& path)
+    {
+        start_sockets();
+        island_socket connection(::socket(AF_UNIX, SOCK_STREAM, 0));
+        const sockaddr_un address = local_address(path);
+        if (connection.handle == no_socket
+            || ::connect(connection.handle, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+        {
+            throw std::runtime_error("could not connect to the coordinator at the local socket " + path);
+        }
+        return connection;
+    }
+
+    /** Connects to the coordinator listening on the given host and port */
+    static island_socket connect(const std::string& host, const std::string& port)
+    {
+        start_sockets();
+        addrinfo hints{};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* addresses = nullptr;
+        if (getaddrinfo(host.c_str(), port.c_str(), &hints, &addresses) != 0)
+        {
+            throw std::runtime_error("could not resolve the coordinator " + host + ":" + port);
+        }
+        for (const addrinfo* address = addresses; address; address = address->ai_next)
+        {
+            island_socket connection(::socket(address->ai_family, address->ai_socktype, address->ai_protocol));
+            if (connection.handle != no_socket
+                && ::connect(connection.handle, address->ai_addr, static_cast<int>(address->ai_addrlen)) == 0)
+            {
+                freeaddrinfo(addresses);
+                connection.send_immediately();
+                return connection;
+            }
+        }
+        freeaddrinfo(addresses);
+        throw std::runtime_error("could not connect to the coordinator " + host + ":" + port);
+    }
+
+    island_socket accept() const
+    {
+        island_socket connection(::accept(handle, nullptr, nullptr));
+        if (connection.handle == no_socket)
+        {
+            throw std::runtime_error("could not accept a worker");
+        }
+        connection.send_immediately();
+        return connection;
+    }
+
+    std::uint16_t port() const
+    {
+        sockaddr_in address{};
+        socklen_t size = sizeof(address);
+        getsockname(handle, reinterpret_cast<sockaddr*>(&address), &size);
+        return ntohs(address.sin_port);
+    }
+
+    void send(const island_message& message)
+    {
+        const auto size = static_cast<std::uint32_t>(message.bytes.size());
+        send_bytes(reinterpret_cast<const char*>(&size), sizeof(size));
+        send_bytes(message.bytes.data(), message.bytes.size());
+    }
+
+    island_message receive()
+    {
+        std::uint32_t size = 0;
+        receive_bytes(reinterpret_cast<char*>(&size), sizeof(size));
+        if (size > max_island_message_size)
+        {
+            throw std::runtime_error("message of " + std::to_string(size) + " bytes between islands, at most "
+                + std::to_string(max_island_message_size) + " expected");
+        }
+        island_message message;
+        message.bytes.resize(size);
+        receive_bytes(message.bytes.data(), size);
+        return message;
+    }
+
+private:
+    static sockaddr_un local_address(const std::string& path)
+    {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        if (path.empty() || path.size() >= sizeof(address.sun_path))
+        {
+            throw std::invalid_argument("the path of a local socket must have 1 to "
+                + std::to_string(sizeof(address.sun_path) - 1) + " characters, not " + path);
+        }
+        std::copy(path.begin(), path.end(), address.sun_path);
+        return address;
+    }
+
+    /**
+     * The messages are small and answered at once, so they are not held back to be merged (Nagle's algorithm),
+     * which the local sockets never do (the option fails on them and is ignored)
+     */
+    void send_immediately()
+    {
+        const int no_delay = 1;
+        setsockopt(handle, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&no_delay), sizeof(no_delay));
+    }
+
+    void send_bytes(const char* data, std::size_t size)
+    {
+        while (size > 0)
+        {
+            const auto sent = ::send(handle, data, static_cast<int>(size), 0);
+            if (sent <= 0)
+            {
+                throw std::runtime_error("the connection between islands was lost while sending");
+            }
+            data += sent;
+            size -= static_cast<std::size_t>(sent);
+        }
+    }
+
+    void receive_bytes(char* data, std::size_t size)
+    {
+        while (size > 0)
+        {
+            const auto received = ::recv(handle, data, static_cast<int>(size), 0);
+            if (received <= 0)
+            {
+                throw std::runtime_error("the connection between islands was lost while receiving");
+            }
+            data += received;
+            size -= static_cast<std::size_t>(received);
+        }
+    }
+
+    socket_handle handle;
+};
+
+/** The best specimens of the population, the first ones the best, to migrate to the next island */
+std::vector<std::pair<pagmo::vector_double, double>> select_migrants(const pagmo::population& pop, std::size_t count)
+{
+    std::vector<std::size_t> order(pop.get_x().size());
+    std::iota(order.begin(), order.end(), std::size_t{ 0 });
+    count = std::min(count, order.size());
+    std::partial_sort(order.begin(), order.begin() + count, order.end(),
+        [&](std::size_t a, std::size_t b) { return pop.get_f()[a][0] < pop.get_f()[b][0]; });
+
+    std::vector<std::pair<pagmo::vector_double, double>> migrants;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        migrants.emplace_back(pop.get_x()[order[i]], pop.get_f()[order[i]][0]);
+    }
+    return migrants;
+}
+
+/** Connects to the coordinator at HOST:PORT, or at the local socket unix:PATH */
+island_socket connect_coordinator(const std::string& coordinator_address)
+{
+    if (const auto path = local_socket_path(coordinator_address))
+    {
+        return island_socket::connect_local(*path);
+    }
+    const auto colon = coordinator_address.rfind(':');
+    if (colon == std::string::npos)
+    {
+        throw std::invalid_argument("--worker requires HOST:PORT or unix:PATH, not " + coordinator_address);
+    }
+    return island_socket::connect(coordinator_address.substr(0, colon), coordinator_address.substr(colon + 1));
+}
+
+/** Runs one island of the problem for the coordinator at HOST:PORT (or unix:PATH) until it stops it */
+int main_worker(const std::string& coordinator_address, const pm_problem& problem)
+{
+    auto coordinator = connect_coordinator(coordinator_address);
+
+    auto assignment = coordinator.receive();
+    if (assignment.get<island_command>() != island_command::assign)
+    {
+        throw std::runtime_error("the coordinator did not assign an island");
+    }
+    const auto island = assignment.get<std::uint32_t>();
+    const auto seed = assignment.get<std::uint32_t>();
+    const auto population_size = assignment.get<std::uint32_t>();
+    const auto migrant_count = assignment.get<std::uint32_t>();
+    if (population_size == 0 || population_size > max_island_population || migrant_count > population_size)
+    {
+        throw std::runtime_error("the coordinator assigned " + std::to_string(population_size) + " specimens and "
+            + std::to_string(migrant_count) + " migrants, at most " + std::to_string(max_island_population) + " and "
+            + "as many as the specimens expected");
+    }
+
+    pagmo::problem prob(problem);
+
+    pagmo::sade uda(100, 2u, 1u, 1e-6, 1e-6, false, seed);
+    use_batch_evaluation(uda);
+    pagmo::algorithm algo(uda);
+    pagmo::population pop(prob, pagmo::bfe{}, population_size, seed);
+    auto evaluations = pop.get_problem().get_fevals();
+
+    for (;;)
+    {
+        auto command = coordinator.receive();
+        if (command.get<island_command>() != island_command::evolve)
+        {
+            break;
+        }
+
+        // the migrants replace the worst specimens they are better than, and tighten the pruning of this island
+        for (const auto& [x, f] : command.get_specimens())
+        {
+            const auto worst = pop.worst_idx();
+            if (f < pop.get_f()[worst][0])
+            {
+                pop.set_xf(worst, x, { f });
+            }
+            pop.get_problem().extract<pm_problem>()->update_best_fitness(f);
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        pop = algo.evolve(pop);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        const auto round_evaluations = static_cast<std::uint64_t>(pop.get_problem().get_fevals() - evaluations);
+        evaluations = pop.get_problem().get_fevals();
+
+        island_message result;
+        result.put(island_command::result).put(seconds).put(round_evaluations);
+        result.put_specimens({ { pop.champion_x(), pop.champion_f()[0] } });
+        result.put_specimens(select_migrants(pop, migrant_count));
+        coordinator.send(result);
+    }
+
+    std::cout << "island " << island << " stopped by the coordinator\n";
+    return 0;
+}
+
+/** What the coordinator knows of every island, reported when the islands stop */
+struct island_report
+{
+    std::uint64_t evaluations = 0;
+    double evolve_seconds = 0.0;
+    double latency_seconds = 0.0;
+    double max_latency_seconds = 0.0;
+    std::uint32_t rounds = 0;
+    pagmo::vector_double champion;
+    double champion_fitness = std::numeric_limits<double>::max();
+};
+
+/**
+ * Coordinates N worker processes, each of them an island of a ring, and reports their throughput
+ * and migration latency once the rounds are over
+ */
+int main_coordinator(const std::string& endpoint, std::uint32_t workers, std::uint32_t rounds, const std::string& spawn_command)
+{
+    // the workers connect to the local socket at unix:PATH, or to the TCP port (0 for any free port)
+    const auto path = local_socket_path(endpoint);
+    const auto listener = path ? island_socket::listen_local(*path)
+        : island_socket::listen(static_cast<std::uint16_t>(std::stoul(endpoint)));
+    const std::string address = path ? endpoint : "127.0.0.1:" + std::to_string(listener.port());
+    std::cout << "coordinator listening on " << (path ? endpoint : "port " + std::to_string(listener.port())) << " for "
+        << workers << " islands\n";
+
+    // every spawned worker is waited for by its own thread, which the destructor joins
+    std::vector<std::jthread> spawned;
+    if (!spawn_command.empty())
+    {
+        const std::string command = spawn_command + " --worker " + address;
+        for (std::uint32_t i = 0; i < workers; ++i)
+        {
+            spawned.emplace_back([command] { std::system(command.c_str()); });
+        }
+    }
+
+    const std::uint32_t population_size = 20;
+    const std::uint32_t migrant_count = 1;
+    const auto seed = std::random_device{}();
+    std::vector<island_socket> islands;
+    for (std::uint32_t i = 0; i < workers; ++i)
+    {
+        islands.push_back(listener.accept());
+        island_message assignment;
+        assignment.put(island_command::assign).put(i).put(static_cast<std::uint32_t>(seed + i))
+            .put(population_size).put(migrant_count);
+        islands.back().send(assignment);
+    }
+
+    std::vector<island_report> reports(workers);
+    std::vector<std::vector<std::pair<pagmo::vector_double, double>>> migrants(workers);
+    for (std::uint32_t round = 0; round < rounds; ++round)
+    {
+        // each island gets the migrants of the previous one in the ring, and sends its own for the next round
+        auto arriving = migrants;
+        std::vector<std::exception_ptr> errors(workers);
+        {
+            std::vector<std::jthread> exchanges;
+            for (std::uint32_t i = 0; i < workers; ++i)
+            {
+                exchanges.emplace_back([&, i] {
+                    try
+                    {
+                        island_message command;
+                        command.put(island_command::evolve).put_specimens(arriving[(i + workers - 1) % workers]);
+                        const auto start = std::chrono::steady_clock::now();
+                        islands[i].send(command);
+                        auto result = islands[i].receive();
+                        const double round_trip
+                            = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                        if (result.get<island_command>() != island_command::result)
+                        {
+                            throw std::runtime_error("island " + std::to_string(i) + " did not send its result");
+                        }
+
+                        auto& report = reports[i];
+                        const double evolve_seconds = result.get<double>();
+                        const double latency = std::max(0.0, round_trip - evolve_seconds);
+                        report.evolve_seconds += evolve_seconds;
+                        report.latency_seconds += latency;
+                        report.max_latency_seconds = std::max(report.max_latency_seconds, latency);
+                        report.evaluations += result.get<std::uint64_t>();
+                        ++report.rounds;
+                        const auto champion = result.get_specimens().front();
+                        if (champion.second < report.champion_fitness)
+                        {
+                            std::tie(report.champion, report.champion_fitness) = champion;
+                        }
+                        migrants[i] = result.get_specimens();
+                    }
+                    catch (...)
+                    {
+                        errors[i] = std::current_exception();
+                    }
+                });
+            }
+        }
+        for (const auto& error : errors)
+        {
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+    for (auto& island : islands)
+    {
+        island.send(island_message{}.put(island_command::stop));
+    }
+
+    const island_report* best = &reports.front();
+    for (std::uint32_t i = 0; i < workers; ++i)
+    {
+        const auto& report = reports[i];
+        std::cout << "island " << i << ": " << report.evaluations << " evaluations, "
+            << report.evaluations / std::max(report.evolve_seconds, 1e-9) << " evaluations/s, migration latency "
+            << 1e3 * report.latency_seconds / std::max(report.rounds, 1u) << " ms on average, "
+            << 1e3 * report.max_latency_seconds << " ms at most\n";
+        const auto& champion = report.champion;
+        std::cout << "island champion: {" << champion[0] << ", " << champion[1] << ", " << champion[2] << ", " << champion[3] << ", " << champion[4] << "}";
+        std::cout << " with fitness: " << report.champion_fitness << "\n";
+        if (report.champion_fitness < best->champion_fitness)
+        {
+            best = &report;
+        }
+    }
+
+    const auto& champion = best->champion;
+    test_simulation({ champion[0], champion[1], champion[2], champion[3], champion[4] });
+    return 0;
+}
+#endif
+
+#ifdef PM_SOLVER_BENCHMARK
+int main(int argc, char** argv)
+{
+    return main_benchmark(argc, argv);
+}
+#else
+/** Options of main that define the problem, given to the spawned workers as they were given to the coordinator */
+constexpr std::array<std::string_view, 7> forwarded_options{
+    "--prune", "--fidelity", "--replicates", "--seed", "--level", "--cache-resolution", "--cache-capacity" };
+
+/** Same as forwarded_options, for the options without a value */
+constexpr std::array<std::string_view, 1> forwarded_flags{ "--fast-forward" };
+
+/** Level of fidelity given as STEPS,RESOLUTION,RATIO */
+fidelity_level parse_fidelity_level(const std::string& text)
+{
+    fidelity_level level;
+    char separators[2] = {};
+    std::istringstream stream(text);
+    stream >> level.horizon >> separators[0] >> level.resolution >> separators[1] >> level.promoted;
+    if (!stream || !stream.eof() || separators[0] != ',' || separators[1] != ','
+        || level.horizon < 1 || level.horizon > T || level.resolution < 0 || !(level.promoted > 0 && level.promoted <= 1))
+    {
+        throw std::invalid_argument("--fidelity requires STEPS,RESOLUTION,RATIO with STEPS in [1, " + std::to_string(T)
+            + "] and RATIO in (0, 1], not " + text);
+    }
+    return level;
+}
+
+/** Level of the classes given by its name */
+class_level parse_class_level(const std::string& text)
+{
+    const auto name = std::find(class_level_names.begin(), class_level_names.end(), text);
+    if (name == class_level_names.end())
+    {
+        throw std::invalid_argument("--level requires novice, adept, expert or master, not " + text);
+    }
+    return static_cast<class_level>(name - class_level_names.begin());
+}
+
+/**
+ * Optimizes every ending of the registry at once with NSGA-II, printing the specimens of the Pareto front
+ * and the best specimen of each ending.
+ */
+int main_endings(std::uint32_t rounds)
+{
+    const auto& endings = ending_registry();
+    if (endings.size() < 2)
+    {
+        throw std::invalid_argument("--endings requires at least two endings in the registry");
+    }
+
+    pagmo::nsga2 uda(100u);
+    use_batch_evaluation(uda);
+    pagmo::algorithm algo(uda);
+    // NSGA-II requires a multiple of 4 specimens
+    pagmo::population pop(pagmo::problem(pm_endings_problem{}), pagmo::bfe{}, 64u);
+    for (std::uint32_t round = 0; round < rounds; ++round)
+    {
+        pop = algo.evolve(pop);
+    }
+
+    const auto& x = pop.get_x();
+    const auto& f = pop.get_f();
+    const auto print_specimen = [&](std::size_t i) {
+        std::cout << "{" << x[i][0] << ", " << x[i][1] << ", " << x[i][2] << ", " << x[i][3] << ", " << x[i][4] << "} with";
+        for (std::size_t e = 0; e < endings.size(); ++e)
+        {
+            std::cout << " " << endings[e].name << ": " << f[i][e];
+        }
+        std::cout << "\n";
+    };
+
+    const auto fronts = std::get<0>(pagmo::fast_non_dominated_sorting(f));
+    std::cout << "pareto front:\n";
+    for (const auto i : fronts.front())
+    {
+        print_specimen(i);
+    }
+    for (std::size_t e = 0; e < endings.size(); ++e)
+    {
+        const auto best = std::min_element(f.begin(), f.end(),
+            [e](const auto& a, const auto& b) { return a[e] < b[e]; }) - f.begin();
+        std::cout << endings[e].name << " champion: ";
+        print_specimen(static_cast<std::size_t>(best));
+    }
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+#ifdef PM_SOLVER_NATIVE_ENGINE
+    check_native_engine(engine.get());
+#endif
+
+    // --checkpoint FILE saves the archipelago after every round of evolution, --resume continues from FILE
+    // --prune MARGIN stops simulating the specimens that cannot get within MARGIN of the best fitness of their island
+    // --coordinator PORT|unix:PATH and --worker HOST:PORT|unix:PATH run the islands in separate processes
+    // (see main_coordinator), --spawn starts them with the options of the problem (see forwarded_options) but no --trace
+    // --fidelity STEPS,RESOLUTION,RATIO scores the batches over STEPS steps (extrapolated to T) with the defuzzifiers
+    // at RESOLUTION (0 keeps them) and promotes the best RATIO of them, repeat it for every level (see multi_fidelity);
+    // pagmo::sade evaluates the specimens one at a time, so it only applies to the initial populations
+    // --fast-forward skips the engine on the cycles of actions that it would repeat (see trajectory_cycles)
+    // --cache-resolution R keys the trajectory cache by the inclinations rounded to R (0 keys them exactly) and
+    // --cache-capacity N keeps its N most recently used specimens (0 disables it, see trajectory_cache)
+    // --endings optimizes all the endings of the registry at once instead of the General one (see main_endings)
+    // --replicates R [--seed S] [--level L] simulates every specimen R times with the random stat changes of the classes
+    // at level L, adept by default (see simulate_stochastic)
+    // --trace FILE records the trajectories, one in --trace-sample N of them, only those with a fitness below
+    // --trace-below X, or only the successive champions with --trace-champions (see trace_recorder);
+    // --decode-trace FILE [--json] writes a trace as CSV (or JSON) to stdout
+    std::string checkpoint_path;
+    bool resume = false;
+    std::uint32_t rounds = 10;
+    std::string coordinator_endpoint;
+    std::uint32_t workers = 16;
+    bool spawn = false;
+    std::string coordinator_address;
+    std::vector<fidelity_level> fidelity_levels;
+    bool all_endings = false;
+    std::optional<stochastic_replicates> stochastic;
+    std::uint64_t stochastic_seed = 0;
+    class_level stochastic_level = class_level::adept;
+    std::string trace_path;
+    trace_trigger trigger;
+    std::string decode_path;
+    bool json = false;
+    double pruning_margin = std::numeric_limits<double>::infinity();
+    double cache_resolution = 1e-6;
+    std::size_t cache_capacity = 1u << 20;
+    std::string problem_arguments;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string option = argv[i];
+        if (i + 1 < argc && std::find(forwarded_options.begin(), forwarded_options.end(), option) != forwarded_options.end())
+        {
+            problem_arguments += " " + option + " \"" + argv[i + 1] + "\"";
+        }
+        if (std::find(forwarded_flags.begin(), forwarded_flags.end(), option) != forwarded_flags.end())
+        {
+            problem_arguments += " " + option;
+        }
+        if (option == "--checkpoint" && i + 1 < argc)
+            checkpoint_path = argv[++i];
+        else if (option == "--resume")
+            resume = true;
+        else if (option == "--rounds" && i + 1 < argc)
+            rounds = static_cast<std::uint32_t>(std::stoul(argv[++i]));
+        else if (option == "--coordinator" && i + 1 < argc)
+            coordinator_endpoint = argv[++i];
+        else if (option == "--workers" && i + 1 < argc)
+            workers = static_cast<std::uint32_t>(std::stoul(argv[++i]));
+        else if (option == "--spawn")
+            spawn = true;
+        else if (option == "--worker" && i + 1 < argc)
+            coordinator_address = argv[++i];
+        else if (option == "--fidelity" && i + 1 < argc)
+            fidelity_levels.push_back(parse_fidelity_level(argv[++i]));
+        else if (option == "--endings")
+            all_endings = true;
+        else if (option == "--replicates" && i + 1 < argc)
+            stochastic = stochastic_replicates{ .count = static_cast<std::uint32_t>(std::stoul(argv[++i])) };
+        else if (option == "--seed" && i + 1 < argc)
+            stochastic_seed = std::stoull(argv[++i]);
+        else if (option == "--level" && i + 1 < argc)
+            stochastic_level = parse_class_level(argv[++i]);
+        else if (option == "--trace" && i + 1 < argc)
+            trace_path = argv[++i];
+        else if (option == "--trace-sample" && i + 1 < argc)
+            trigger.sample_every = std::max(1u, static_cast<std::uint32_t>(std::stoul(argv[++i])));
+        else if (option == "--trace-below" && i + 1 < argc)
+            trigger.fitness_below = std::stod(argv[++i]);
+        else if (option == "--trace-champions")
+            trigger.champions_only = true;
+        else if (option == "--decode-trace" && i + 1 < argc)
+            decode_path = argv[++i];
+        else if (option == "--json")
+            json = true;
+        else if (option == "--prune" && i + 1 < argc)
+            pruning_margin = std::stod(argv[++i]);
+        else if (option == "--fast-forward")
+            stat_saturation = saturation_bounds(engine.get());
+        else if (option == "--cache-resolution" && i + 1 < argc)
+            cache_resolution = std::stod(argv[++i]);
+        else if (option == "--cache-capacity" && i + 1 < argc)
+            cache_capacity = std::stoull(argv[++i]);
+        else
+            throw std::invalid_argument("unknown option " + option);
+    }
+    if (resume && checkpoint_path.empty())
+    {
+        throw std::invalid_argument("--resume requires --checkpoint FILE");
+    }
+    if (!(cache_resolution >= 0.0 && cache_resolution < 1.0))
+    {
+        throw std::invalid_argument("--cache-resolution requires a resolution in [0, 1)");
+    }
+    if (spawn && !trace_path.empty())
+    {
+        // the trace is a file of the process, start the workers with --worker and a --trace of their own instead
+        throw std::invalid_argument("--trace cannot be given to the workers started by --spawn");
+    }
+    if (!decode_path.empty())
+    {
+        return decode_trace(decode_path, json, std::cout);
+    }
+    if (!trace_path.empty())
+    {
+        shared_trace_recorder().start(trace_path, engine.get(), trigger);
+    }
+    if (stochastic)
+    {
+        if (stochastic->count == 0)
+        {
+            throw std::invalid_argument("--replicates requires at least one replicate");
+        }
+        stochastic->seed = stochastic_seed;
+        stochastic->level = stochastic_level;
+    }
+
+    // the specimens closer than the resolution share a key and are simulated as its representative, so the cache never
+    // changes a fitness, whichever specimen of a key comes first
+    const auto cache = cache_capacity == 0 ? nullptr
+        : std::make_shared<trajectory_cache>(cache_resolution, cache_capacity, engine_fingerprint(engine.get()));
+    const auto fidelity = fidelity_levels.empty() ? nullptr : std::make_shared<multi_fidelity>(fidelity_levels);
+    if (fidelity)
+    {
+        std::cout << "fidelity levels: only for the initial populations, pagmo::sade evaluates one specimen at a time\n";
+    }
+    const auto replicates = stochastic ? std::make_shared<const stochastic_replicates>(*stochastic) : nullptr;
+    const pm_problem shared_problem{
+        .pruning_margin = pruning_margin, .cache = cache, .fidelity = fidelity, .stochastic = replicates };
+
+    if (!coordinator_address.empty())
+    {
+        return main_worker(coordinator_address, shared_problem);
+    }
+    if (!coordinator_endpoint.empty())
+    {
+        if (workers == 0)
+        {
+            throw std::invalid_argument("--coordinator requires at least one worker");
+        }
+        // the spawned workers optimize the problem that the coordinator was given
+        const std::string spawn_command = "\"" + std::string(argv[0]) + "\"" + problem_arguments;
+        return main_coordinator(coordinator_endpoint, workers, rounds, spawn ? spawn_command : "");
+    }
+    if (all_endings)
+    {
+        return main_endings(rounds);
+    }
+
+    pagmo::problem prob(shared_problem);
+
+    pagmo::sade uda(100);
+    use_batch_evaluation(uda);
+    pagmo::algorithm algo(uda);
+
+    checkpoint_header progress{ .engine = engine_fingerprint(engine.get()) };
+    pagmo::archipelago archi;
+    if (resume && std::filesystem::exists(checkpoint_path))
+    {
+        progress = load_checkpoint(checkpoint_path, archi, progress.engine);
+        relink_islands(archi, shared_problem);
+        std::cout << "resuming from " << checkpoint_path << " after " << progress.rounds << " of " << rounds << " rounds\n";
+    }
+    else
+    {
+        // the default pagmo::bfe evaluates the initial populations through pm_problem::batch_fitness
+        archi = pagmo::archipelago(16u, algo, prob, pagmo::bfe{}, 20u);
+    }
+
+    if (checkpoint_path.empty())
+    {
+        archi.evolve(rounds);
+        archi.wait_check();
+    }
+    else
+    {
+        // one round at a time, so every round is saved as soon as all the islands finish it
+        while (progress.rounds < rounds)
+        {
+            archi.evolve(1);
+            archi.wait_check();
+            ++progress.rounds;
+            const auto start = std::chrono::steady_clock::now();
+            save_checkpoint(checkpoint_path, archi, progress);
+            std::cout << "checkpoint of round " << progress.rounds << " saved in "
+                << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() << " ms\n";
+        }
+    }
+
+    pagmo::vector_double best_champion;
+	double best_fitness = std::numeric_limits<double>::max();
+
+    for (const auto& isl : archi)
+    {
+        const auto& champion = isl.get_population().champion_x();
+        std::cout << "island champion: {" << champion[0] << ", " << champion[1] << ", " << champion[2] << ", " << champion[3] << ", " << champion[4] << "}";
+		std::cout << " with fitness: " << isl.get_population().champion_f()[0];
+        if (replicates)
+        {
+            // the fitness is the mean of the replicates, their spread is only computed for the champions
+            const auto champion_replicates = shared_evaluation_pool().evaluate_replicates(champion, *replicates);
+            std::cout << " +/- " << summarize_replicates(champion_replicates.data(), replicates->count).half_width;
+        }
+        std::cout << "\n";
+
+        if (isl.get_population().champion_f()[0] < best_fitness)
+        {
+            best_fitness = isl.get_population().champion_f()[0];
+            best_champion = champion;
+        }
+    }
+
+
+    if (cache)
+    {
+        std::cout << "trajectory cache: " << cache->hits() << " hits, " << cache->misses() << " misses ("
+            << 100.0 * cache->hit_rate() << "% hit rate)\n";
+    }
+    if (fidelity)
+    {
+        std::cout << fidelity->report();
+    }
+    if (replicates)
+    {
+        std::cout << "stochastic fitness: 95% confidence of the mean of " << replicates->count << " replicates of seed "
+            << replicates->seed << " with the classes at " << class_level_names[static_cast<std::size_t>(replicates->level)]
+            << " level\n";
+    }
+
+#ifdef FL_INSTRUMENT
+    // which rules never fire and where the time of each step goes, over all the islands
+    const auto instrumentation = instrumented_state::merged();
+    std::cout << instrumentation.toString();
+    for (const auto& rule : instrumentation.rulesNeverFired())
+    {
+        std::cout << "never fired: " << rule << "\n";
+    }
+#endif
+
+    test_simulation({ best_champion[0], best_champion[1], best_champion[2], best_champion[3], best_champion[4] });
+
+    if (!trace_path.empty())
+    {
+        auto& recorder = shared_trace_recorder();
+        recorder.stop();
+        std::cout << "trace: " << recorder.recorded() << " trajectories recorded in " << trace_path << ", "
+            << recorder.dropped() << " dropped by full buffers\n";
+    }
 
     return 0;
 }
+#endif
@@ -8,5 +8,51 @@
 #include <exception>
 #include <unordered_map>
 #include <tuple>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <list>
+#include <map>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <latch>
+#include <random>
+#include <vector>
+#include <cstring>
+#include <numeric>
+#include <span>
+
+// сокеты TCP и локальные сокеты Unix для островов в отдельных процессах (см. main_coordinator)
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <afunix.h>
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
 
 // TODO: установите здесь ссылки на дополнительные заголовки, требующиеся для программы.
\ No newline at end of file